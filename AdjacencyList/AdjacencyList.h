@@ -1,27 +1,271 @@
 #pragma once
 #include <atomic>
 #include <mutex>
+#include <cstring>
 #include <vector>
 #include "lftt.h"
 #include "pre_alloc.h"
 #include "mdlist.h"
+#include "intersect.h"
 
-class AdjacencyList
+template<typename Key>
+class BasicWriteAheadLog;
+
+template<typename Key>
+class BasicChangeFeed;
+
+template<typename Key>
+class BasicAdjacencyList;
+
+//Ties together the parts of a cross-shard transaction, one descriptor on each shard it touches, see ShardedAdjacencyList
+//Each part runs like any transaction but ends PREPARED instead of COMMITTED, whoever finds a prepared part helps every part
+//to PREPARED or ABORTED, decides the coordinator and settles the parts with it, so no thread ever waits for another
+template<typename Key>
+struct BasicCoordinator
+{
+    struct Part
+    {
+        BasicAdjacencyList<Key>* shard;
+        BasicDesc<Key>* desc;
+    };
+
+    //Coordinators are variable sized and handed out in DESC_UNIT steps like descriptors
+    static uint64_t Units(uint32_t size)
+    {
+        return (sizeof(BasicCoordinator) + sizeof(Part) * size + DESC_UNIT - 1) / DESC_UNIT;
+    }
+
+    //ACTIVE until every part is prepared or one aborted, then COMMITTED or ABORTED
+    volatile uint8_t status;
+    uint32_t size;
+    //In shard order, so that transactions prepare their parts in the same order
+    Part parts[];
+};
+
+//Vertex and edge keys are of type Key, an unsigned integer of any width
+//Every value of Key is usable as a vertex and as an edge, none is reserved, so hashed keys can be used as they are
+template<typename Key>
+class BasicAdjacencyList
 {
 public:
+    typedef BasicOperator<Key> Operator;
+    typedef BasicDesc<Key> Desc;
+    typedef BasicNodeDesc<Key> NodeDesc;
+    typedef BasicMDList<Key> MDList;
+    typedef BasicMDNode<Key> MDNode;
+    typedef BasicMDDesc<Key> MDDesc;
+    typedef BasicWriteAheadLog<Key> WriteAheadLog;
+    typedef BasicChangeFeed<Key> ChangeFeed;
+    typedef BasicCoordinator<Key> Coordinator;
+
+    //Edge lists take two bits of the key per dimension
+    static const uint32_t DIMENSION = MDList::DIMENSION;
     static const uint32_t key_range = 1024;
+    //Edges a vertex keeps inline before its adjacencies are promoted to an MDList
+    static const uint32_t inline_edges = 8;
+    //Snapshots one thread may hold open on a list at once
+    static const uint32_t snapshots_per_thread = 2;
+    //Probes SnapshotFindBatch keeps in flight
+    static const uint32_t batch_interleave = 16;
+    //Dense table entries SnapshotScan fetches the nodes of ahead
+    static const uint32_t scan_prefetch = 8;
+    //Property bytes set aside per op of each thread, a thread storing larger properties runs out of them sooner
+    static const uint32_t property_room = 32;
+    //Cold array bytes set aside per op of each thread, one thread may freeze the edges of all of them
+    static const uint32_t cold_room = 16;
+    //Edges per block of a cold array, a lookup decodes at most one block after a binary search of the block starts
+    static const uint32_t cold_block = 64;
+    //Mdlists the edges of a contended vertex are split over, and the contention that splits them, see split_hot_edges
+    static const uint32_t split_ways = 8;
+    static const uint32_t split_contention = 64;
+
+    //Node::tier is an edge write gate while its low bit is set: the writers inside it above the bit and the number of
+    //writers that ever entered it in the upper half. A frozen vertex holds its ColdEdges pointer there instead,
+    //a vertex whose edges are being split its SplitEdges pointer with TIER_SPLITTING set
+    static const uint64_t TIER_GATE = 1;
+    static const uint64_t TIER_SPLITTING = 2;
+    static const uint64_t TIER_WRITER = 2;
+    static const uint64_t TIER_WRITERS = 0xFFFFFFFEull;
+    static const uint64_t TIER_GENERATION = 1ull << 32;
+
+    //Node::edge_slots holds the EdgeSlots pointer of a vertex with these flags in its low bits
+    //A promoted block is the last of its vertex, an edge missing from it goes to the mdlist, see ReclaimSlots
+    static const uint64_t SLOTS_PROMOTED = 1;
+    static const uint64_t SLOTS_RECLAIMING = 2;
+    //Set in EdgeSlots::keep once the slots a reclaim copies are decided
+    static const uint32_t SLOTS_DECIDED = 1u << 31;
+    //Slot of every block that holds edge 0
+    static const uint32_t ZERO_SLOT = inline_edges;
+
+    struct SplitEdges;
+
+    //Inline adjacencies, a slot is claimed in order by writing its key and never given to another key of the block
+    //Key 0 has the last slot of every block to itself, so in the others it marks a free slot. The mdlist head takes
+    //coordinate 0, an edge 0 is always inline. A claimed slot with a NULL descriptor holds a logically absent edge
+    //A full block is reclaimed by copying the slots still needed to next, its descriptors are marked as they are sealed
+    struct EdgeSlots
+    {
+        EdgeSlots() : next(NULL), keep(0)
+        {
+            memset(keys, 0, sizeof(keys));
+            memset((void*)descs, 0, sizeof(descs));
+        }
+
+        Key keys[inline_edges + 1];
+        NodeDesc* volatile descs[inline_edges + 1];
+        //Block the slots are copied to, and a bit for every slot copied with SLOTS_DECIDED
+        EdgeSlots* volatile next;
+        volatile uint32_t keep;
+    };
 	
 	struct Node
 	{
-		Node(uint32_t _key, Node* _next, NodeDesc* _nodeDesc, MDList* m_list)
-            : key(_key), next(_next), node_desc(_nodeDesc), m_list(NULL){}
+		Node(Key _key, Node* _next, NodeDesc* _nodeDesc, MDList* m_list)
+            : key(_key), contention(0), next(_next), node_desc(_nodeDesc), m_list(NULL), m_split(NULL), edge_slots((uint64_t)&slots), tier(TIER_GATE)
+        {
+        }
 
-        uint32_t key;	//Vertex key
+        Key key;	//Vertex key
+        //Retried and overlapping edge writes while split_hot_edges is set
+        volatile uint32_t contention;
 		Node *next; 	//Next vertex
         NodeDesc* node_desc;
-		MDList *m_list;	//Adjacencies
+		MDList *m_list;	//Adjacencies beyond the inline ones, NULL until promoted
+        //Set once the mdlist edges are split, m_list then only holds what they were split from
+        SplitEdges* volatile m_split;
+        //Current block of inline adjacencies with the SLOTS_ flags, slots until a reclaim replaces it
+        volatile uint64_t edge_slots;
+
+        //First block of inline adjacencies, on the second line of the node
+        EdgeSlots slots;
+
+        //Edge write gate, or the ColdEdges the mdlist edges are frozen into, see FreezeEdges
+        volatile uint64_t tier;
 	};
 
+    //The mdlist edges of a contended vertex spread over split_ways mdlists by a hash of the edge key, so that
+    //inserts of different edges no longer meet at the head of a single mdlist. Reads of all the edges merge the parts
+    //Built from the single mdlist while Node::tier points here, by every writer that comes along, as frozen edges are thawed
+    struct SplitEdges
+    {
+        static uint32_t PartOf(Key edge)
+        {
+            return (uint32_t)(((uint64_t)edge * 0x9E3779B97F4A7C15ull) >> 32) % split_ways;
+        }
+
+        //Writers the gate had seen, the gate put back after the split goes on counting from there
+        uint64_t generation;
+        MDList* source;
+        MDList* volatile parts[split_ways];
+    };
+
+    //The mdlist edges of a vertex frozen into a sorted array, immutable once published in Node::tier
+    //Each block of cold_block edges starts with its first key and goes on with the varint encoded gaps to the next ones
+    struct ColdEdges
+    {
+        //Cold arrays are variable sized and handed out in 8 byte units
+        static uint64_t Units(uint32_t bytes)
+        {
+            return (sizeof(ColdEdges) + bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        }
+
+        static uint32_t Blocks(uint32_t count)
+        {
+            return (count + cold_block - 1) / cold_block;
+        }
+
+        static const uint8_t* ReadVarint(const uint8_t* p, uint64_t& value)
+        {
+            value = 0;
+
+            for (uint32_t shift = 0; ; shift += 7)
+            {
+                uint8_t byte = *p++;
+                value |= (uint64_t)(byte & 0x7F) << shift;
+
+                if (!(byte & 0x80))
+                {
+                    return p;
+                }
+            }
+        }
+
+        //Byte offset of each block within the varints, which follow the offsets
+        const uint32_t* Offsets() const
+        {
+            return (const uint32_t*)data;
+        }
+
+        const uint8_t* Varints() const
+        {
+            return data + sizeof(uint32_t) * Blocks(count);
+        }
+
+        //Calls visit(edge) for the edges from block on in ascending order until visit returns false
+        template<typename Visitor>
+        void Decode(uint32_t block, Visitor&& visit) const
+        {
+            const uint8_t* p = Varints() + (block < Blocks(count) ? Offsets()[block] : 0);
+            Key edge = 0;
+
+            for (uint32_t i = block * cold_block; i < count; i++)
+            {
+                uint64_t gap;
+                p = ReadVarint(p, gap);
+                edge = i % cold_block == 0 ? (Key)gap : (Key)(edge + gap);
+
+                if (!visit(edge))
+                {
+                    return;
+                }
+            }
+        }
+
+        bool Contains(Key edge) const
+        {
+            //Last block starting at or before edge
+            uint32_t low = 0;
+            uint32_t high = Blocks(count);
+
+            while (high - low > 1)
+            {
+                uint32_t middle = (low + high) / 2;
+                uint64_t first;
+                ReadVarint(Varints() + Offsets()[middle], first);
+
+                if ((Key)first <= edge)
+                {
+                    low = middle;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+
+            bool found = false;
+
+            Decode(low, [&](Key key)
+            {
+                found = key == edge;
+                return key < edge;
+            });
+
+            return found;
+        }
+
+        //Newest commit of any version of the frozen edges, every snapshot that may read them is at least as new
+        uint64_t commit_ts;
+        //Writers the gate had seen, the gate a thaw puts back goes on counting from there
+        uint64_t generation;
+        //The mdlist the edges were frozen from and the one the first thaw rebuilds them in
+        MDList* detached;
+        MDList* volatile thawed;
+        uint32_t count;
+        uint32_t bytes;
+        uint8_t data[];
+    };
+
 	struct HelpStack
     {
         void Init()
@@ -29,12 +273,19 @@ public:
             index = 0;
         }
 
+        //Grows on demand, helping large transactions can nest deeper than a fixed stack allows
         void Push(Desc* desc)
         {
-            if (index >= 255)
+            if (index == capacity)
             {
-                printf("index out of range\n");
-                std::exit(EXIT_FAILURE);
+                capacity = capacity == 0 ? 256 : capacity * 2;
+                helps = (Desc**)realloc(helps, sizeof(Desc*) * capacity);
+
+                if (helps == NULL)
+                {
+                    printf("help stack allocation failed\n");
+                    std::exit(EXIT_FAILURE);
+                }
             }
 
             helps[index++] = desc;
@@ -53,7 +304,7 @@ public:
 
         bool Contain(Desc* desc)
         {
-            for(uint8_t i = 0; i < index; i++)
+            for(uint32_t i = 0; i < index; i++)
             {
                 if(helps[i] == desc)
                 {
@@ -64,42 +315,330 @@ public:
             return false;
         }
 
-        Desc* helps[256];
-        uint8_t index;
+        Desc** helps;
+        uint32_t index;
+        uint32_t capacity;
     };
 
-    AdjacencyList(int num_threads, int _transize, int ops);
+    //A non zero dense_range maps the vertex keys [0, dense_range) directly to their nodes through a table
+    //A segment puts the list's nodes, descriptors and allocators in it instead of the heap, see CreateShared
+    BasicAdjacencyList(int num_threads, int _transize, int ops, uint32_t _dense_range = 0, SharedSegment* segment = NULL);
+    //Frees every node and descriptor at once, runs after the last thread is done with the list
+    ~BasicAdjacencyList();
+
+    //Shared mode: the list and everything it allocates live in a segment mapped at the same address in every process,
+    //so its pointers are valid in all of them and transactions of different processes help each other as threads do
+    //num_threads counts the threads of all processes, each calls Init once like any other thread
+    //Every process must run the same build, the wal and the feed are per process and cannot be attached
+    static BasicAdjacencyList* CreateShared(SharedSegment* segment, int num_threads, int transize, int ops, uint32_t dense_range = 0);
+    //The list another process created in segment, NULL until CreateShared returned
+    static BasicAdjacencyList* AttachShared(SharedSegment* segment);
+    //Bytes CreateShared takes from a segment
+    static uint64_t SharedSize(int num_threads, int ops, uint32_t dense_range = 0);
 
+    //Runs a transaction, true if it committed
+    //With ordered_ops set desc->ops is stable sorted on the vertex key in place before the first op runs, the caller,
+    //the WAL record and the change feed all see the ops in that order. Ops on different vertices commute, so the
+    //transaction means the same. Helpers index the ops of a published descriptor for as long as it is reachable, the
+    //ops that run can not be a sorted copy, a caller that needs its own order afterwards keeps one
     bool ExecuteOps(Desc* desc);
+    //Runs every part of a cross-shard transaction on its shard, the calling thread must have called Init on all of them
+    static bool ExecuteCoordinated(Coordinator* coordinator);
     void Init();
-    Desc* AllocateDesc(uint8_t size);
+    Desc* AllocateDesc(uint32_t size);
     void InitLists();
 
+    //Snapshot reads see every transaction committed up to the snapshot and nothing after it
+    //They never install descriptors, so they neither abort nor help concurrent transactions
+    //Deleted nodes are kept linked while a snapshot older than the delete is open, any thread removes them once none is
+    //A thread may hold snapshots_per_thread snapshots open on one list at once, BeginSnapshot waits for more
+    uint64_t BeginSnapshot();
+    void EndSnapshot();
+    bool SnapshotFindVertex(uint64_t snapshot, Key vertex);
+    bool SnapshotFindEdge(uint64_t snapshot, Key vertex, Key edge);
+    //Fills edges with the sorted adjacencies of vertex, returns false if the vertex is not in the snapshot
+    bool SnapshotNeighbors(uint64_t snapshot, Key vertex, std::vector<Key>& edges);
+    //Fills vertices with the sorted vertex keys in the snapshot
+    void SnapshotVertices(uint64_t snapshot, std::vector<Key>& vertices);
+    //Number of keys both u and v have an edge to, 0 if either vertex is not in the snapshot
+    uint64_t SnapshotCommonNeighbors(uint64_t snapshot, Key u, Key v);
+    //Number of edges u -> w between two neighbors of vertex, self loops left out
+    //A graph that stores every edge in both directions counts each triangle through vertex twice
+    uint64_t SnapshotTriangles(uint64_t snapshot, Key vertex);
+    //Fills vertices with the sorted vertex keys and triangles with the SnapshotTriangles count of each
+    //Every adjacency set is materialized once, instead of once per neighbor as SnapshotTriangles on each vertex would
+    void SnapshotAllTriangles(uint64_t snapshot, std::vector<Key>& vertices, std::vector<uint64_t>& triangles);
+
+    //One share of a partitioned scan, the vertices with keys in [first, last]
+    struct ScanRange
+    {
+        Key first;
+        Key last;
+        //Vertex node the walk of the range starts from, NULL in dense mode
+        Node* start;
+    };
+
+    //Splits the vertices with keys in [first, last] into at most count ranges, to be scanned by SnapshotScan in parallel
+    //The vertex list is walked once for ranges of about as many vertex nodes each, the dense table is split by key
+    void SnapshotPartition(uint64_t snapshot, Key first, Key last, uint32_t count, std::vector<ScanRange>& ranges);
+    //Calls visit(vertex, edges) for every vertex of the range in the snapshot, in key order and with its sorted edges
+    //Only what is present in the snapshot is reported, whatever transactions run meanwhile
+    template<typename Visitor>
+    void SnapshotScan(uint64_t snapshot, const ScanRange& range, Visitor&& visit);
+
+    //Copies size bytes into a new property of the calling thread, to be given to a vertex by an INSERT or SET_PROPERTY op
+    const Property* NewProperty(const void* data, uint32_t size);
+    //The property of vertex in the snapshot, NULL if it has none or is not in the snapshot
+    //Read in place from the arena, properties are never changed or freed while the list lives
+    const Property* SnapshotProperty(uint64_t snapshot, Key vertex);
+
+    //Cold adjacencies: the mdlist edges of a vertex that stopped changing can be frozen into a ColdEdges array,
+    //a few bytes an edge instead of an mdlist node and its descriptors. Reads take whichever form the vertex has,
+    //the first write to its mdlist edges thaws them back into an mdlist. Inline edges are never frozen
+    //Nothing is freed, a frozen mdlist is only no longer reachable, see SampleLiveness
+    //
+    //Split vertices are the contended ones, they are left alone
+    //Freezes the mdlist edges of vertex, false if it has none, any of them or the vertex is not settled, or a snapshot older
+    //than their versions is open. Such a snapshot could read versions the array does not keep
+    bool FreezeEdges(Key vertex);
+    //Freezes every vertex with at least min_edges mdlist edges of which none changed in the last min_age commits
+    //Meant for a background thread that called Init, returns the number of vertices frozen
+    uint64_t FreezeColdEdges(uint64_t min_age, uint32_t min_edges);
+
+    //A FIND_EDGE of vertex -> edge when find_edge is set, a FIND of vertex otherwise
+    struct Probe
+    {
+        Key vertex;
+        Key edge;
+        bool find_edge;
+    };
+
+    //Sets found[i] to what SnapshotFindVertex or SnapshotFindEdge returns for probes[i]
+    //The searches of batch_interleave probes are interleaved, each prefetches its next node and yields to the others
+    //so their cache misses overlap instead of being waited out one after another
+    void SnapshotFindBatch(uint64_t snapshot, const Probe* probes, size_t count, bool* found);
+
+    //Footprint of one allocator, nothing handed out is ever returned
+    struct AllocatorStats
+    {
+        const char* name;
+        uint64_t reserved;
+        uint64_t handed_out;
+        //Bytes handed out to each thread in the order the threads called Init
+        std::vector<uint64_t> thread_handed_out;
+    };
+
+    //Objects still reachable from the graph, estimated from a sample of the vertices
+    //Whatever an allocator handed out beyond them is dead: superseded descriptors, removed nodes and finished adoptions
+    struct LivenessStats
+    {
+        uint64_t vertex_nodes;
+        uint64_t sampled_vertex_nodes;
+        //Vertex counts are exact, every vertex node is visited
+        uint64_t live_vertices;
+        uint64_t dead_vertices;
+        //Edge counts are scaled up from the sampled vertex nodes
+        uint64_t live_edges;
+        uint64_t dead_edges;
+        uint64_t md_nodes;
+        uint64_t marked_md_nodes;
+        uint64_t pending_adoptions;
+        //NodeDescs installed in the nodes and the older versions chained behind them
+        uint64_t node_descs;
+        uint64_t chained_versions;
+        //Exact, every vertex node is visited: frozen vertices, their edges and the bytes of their arrays
+        uint64_t cold_vertices;
+        uint64_t cold_edges;
+        uint64_t cold_bytes;
+        //Exact as well, vertices with their mdlist edges split
+        uint64_t split_vertices;
+    };
+
+    //Safe while transactions run, the statistics are then approximate
+    void MemoryUsage(std::vector<AllocatorStats>& stats);
+    //Ops the calling thread can still allocate for, the least room of the allocators vertex and edge ops draw from
+    //Properties, frozen arrays and splits are not counted
+    uint64_t Room();
+    //Classifies vertices and edges as of a snapshot, the edges of every sample_every-th vertex node are walked
+    void SampleLiveness(uint32_t sample_every, LivenessStats& stats);
+
 private:
-	ReturnCode InsertVertex(uint32_t vertex, Desc* desc, uint8_t opid, Node*& inserted, Node*& pred);
-	ReturnCode InsertEdge(uint32_t vertex, uint32_t edge, Desc* desc, uint8_t opid, MDNode*& inserted, MDNode*& md_pred, Node*& current, uint32_t& dim, uint32_t& pred_dim);
-	ReturnCode DeleteVertex(uint32_t vertex, Desc* desc, uint8_t opid, Node*& deleted, Node*& pred);
-	ReturnCode DeleteEdge(uint32_t vertex, uint32_t edge, Desc* desc, uint8_t opid, MDNode*& deleted, MDNode*& md_pred, Node*& current, uint32_t& dim, uint32_t& pred_dim);
-	ReturnCode Find(uint32_t key, Desc* desc, uint8_t opid);
+    //Where the search of a probe resumes, everything the stage reads was prefetched when it was entered
+    enum BatchStage
+    {
+        BATCH_TABLE = 0,    //dense table entry of the vertex
+        BATCH_WALK,         //vertex list node
+        BATCH_VERTEX_DESC,  //descriptor of a vertex node with the key
+        BATCH_VERTEX_TXN,   //transaction of that descriptor
+        BATCH_MDLIST,       //mdlist of the vertex
+        BATCH_MDWALK,       //mdlist node on the path to the edge
+        BATCH_EDGE_DESC,    //descriptor of the edge
+        BATCH_EDGE_TXN      //transaction of that descriptor
+    };
+
+    struct BatchSlot
+    {
+        size_t index;
+        uint8_t stage;
+        Node* node;
+        NodeDesc* node_desc;
+        MDList* m_list;
+        MDNode* md_current;
+        uint32_t dim;
+    };
+
+    //Keeps the mdlist edges of a node thawed while an op writes them
+    struct EdgeWriter
+    {
+        EdgeWriter(BasicAdjacencyList* _list, Node* _node)
+            : list(_list), node(_node)
+        {
+            list->EnterEdges(node);
+        }
 
-	void HelpOps(Desc* desc, uint8_t opid);
+        ~EdgeWriter()
+        {
+            list->ExitEdges(node);
+        }
+
+        BasicAdjacencyList* list;
+        Node* node;
+    };
+
+    void BatchStart(BatchSlot& slot, const Probe& probe, size_t index);
+    bool BatchStep(BatchSlot& slot, const Probe& probe, uint64_t snapshot, bool& found);
+
+	ReturnCode InsertVertex(Key vertex, Desc* desc, uint32_t opid, Node*& inserted, Node*& pred);
+	ReturnCode InsertEdge(Key vertex, Key edge, Desc* desc, uint32_t opid, MDNode*& inserted, MDNode*& md_pred, Node*& current, uint32_t& dim, uint32_t& pred_dim);
+	ReturnCode DeleteVertex(Key vertex, Desc* desc, uint32_t opid, Node*& deleted, Node*& pred);
+	ReturnCode DeleteEdge(Key vertex, Key edge, Desc* desc, uint32_t opid, MDNode*& deleted, MDNode*& md_pred, Node*& current, uint32_t& dim, uint32_t& pred_dim);
+	ReturnCode Find(Key key, Desc* desc, uint32_t opid);
+
+	void HelpOps(Desc* desc, uint32_t opid);
+    static void ResolveCoordinator(Coordinator* coordinator);
     bool IsSameOperation(NodeDesc* nodeDesc1, NodeDesc* nodeDesc2);
     void FinishPendingTxn(NodeDesc* nodeDesc, Desc* desc);
     void FinishDeleteVertex(MDList* m_list, MDNode* n, int dim, Desc *desc, NodeDesc *nodeDesc, int DIMENSION);
-    bool IsNodeExist(Node* node, uint32_t key);
-    bool IsNodeExist(MDNode* node, uint32_t key);
+    void FinishDeleteInline(Node* node, Desc *desc, NodeDesc *nodeDesc);
+    void FinishDeleteEdges(Node* node, Desc *desc, NodeDesc *nodeDesc);
+    NodeDesc* CopyDesc(NodeDesc* nodeDesc, NodeDesc* prev);
+    static EdgeSlots* SlotsOf(uint64_t state);
+    int LocateInlineEdge(EdgeSlots* slots, Key edge, bool claim);
+    void ReclaimSlots(Node* node, uint64_t state);
+    void HelpReclaim(Node* node, EdgeSlots* slots);
+    bool IsVertexLive(Node* node, Desc* desc);
+    MDList* PromoteEdges(Node* node, Key edge);
+    static MDList* EdgeList(Node* node, Key edge);
+    static ColdEdges* ColdOf(Node* node);
+    void EnterEdges(Node* node);
+    void ExitEdges(Node* node);
+    void NoteContention(Node* node);
+    void AppendEdge(MDList* m_list, Key edge, NodeDesc* nodeDesc);
+    void ThawEdges(Node* node, ColdEdges* cold);
+    void StartSplit(Node* node, uint64_t gate);
+    void HelpSplit(Node* node, SplitEdges* split);
+    void CollectLinked(MDList* m_list, MDNode* n, int dim, std::vector<std::pair<Key, NodeDesc*>>& edges);
+    bool Freeze(Node* node, uint64_t min_age, uint32_t min_edges);
+    bool CollectSettled(MDList* m_list, MDNode* n, int dim, std::vector<Key>& edges, uint64_t& newest);
+    bool IsNodeExist(Node* node, Key key);
+    bool IsNodeExist(MDNode* node, Key key);
     bool IsNodeActive(NodeDesc* nodeDesc);
     bool IsKeyExist(NodeDesc* nodeDesc);
-    void LocatePred(Node*& pred, Node*& curr, uint32_t key);
-    bool FindVertex(Node*& curr, NodeDesc*& nDesc, Desc *desc, uint32_t key);
+    void LocatePred(Node*& pred, Node*& curr, Key key);
+    void LocateVertex(Node*& pred, Node*& curr, Key key);
+    bool FindVertex(Node*& curr, NodeDesc*& nDesc, Desc *desc, Key key);
+    uint64_t CommitTs(Desc* desc);
+    bool IsKeyVisible(NodeDesc* nodeDesc, uint64_t snapshot);
+    bool IsCommittedBy(Desc* desc, uint64_t snapshot);
+    const Property* CurrentProperty(NodeDesc* nodeDesc, Desc* desc);
+    Node* SnapshotLocateVertex(uint64_t snapshot, Key key);
+    void SnapshotCollect(MDList* m_list, MDNode* n, int dim, uint64_t snapshot, std::vector<Key>& edges);
+    void SnapshotEdges(Node* node, uint64_t snapshot, std::vector<Key>& edges);
+    void SampleNode(Node* node, uint64_t snapshot, LivenessStats& stats);
+    void SampleEdges(MDList* m_list, MDNode* n, int dim, uint64_t snapshot, bool vertex_live, LivenessStats& stats);
+    void SampleDesc(NodeDesc* nodeDesc, LivenessStats& stats);
+    static Node* NewSentinel(SharedSegment* segment, Key key);
+    static Node** NewVertexTable(SharedSegment* segment, uint32_t size);
+    static volatile uint64_t* NewSnapshotTable(SharedSegment* segment, uint32_t size);
+    static uint64_t SplitRoom(int num_threads, int ops);
+    template<typename T>
+    static PreAllocator<T>* NewAllocator(SharedSegment* segment, uint64_t num_threads, uint64_t type_size, uint64_t amount);
+    template<typename T>
+    static void AddAllocatorStats(const char* name, PreAllocator<T>* allocator, std::vector<AllocatorStats>& stats);
     void MarkForDeletion(const std::vector<Node*>& nodes, const std::vector<Node*>& preds, const std::vector<MDNode*>& md_nodes, 
         const std::vector<MDNode*>& md_preds, const std::vector<Node*>& parents, std::vector<uint32_t>& dims, std::vector<uint32_t>& predDims, Desc* desc);
+    void RemoveOrRetire(std::vector<Node*>& nodes, std::vector<Node*>& preds, std::vector<MDNode*>& md_nodes,
+        std::vector<MDNode*>& md_preds, std::vector<Node*>& parents, std::vector<uint32_t>& dims, std::vector<uint32_t>& predDims, Desc* desc);
+    static void DrainRetired();
+    uint64_t OldestSnapshot();
+    bool IsSettledBy(NodeDesc* nodeDesc, uint64_t oldest);
+
+    static __thread HelpStack helpStack;
+
+    //A MarkForDeletion put off while older snapshots were open, due once every open snapshot is at least as new as retire_ts
+    struct Retired
+    {
+        BasicAdjacencyList* list;
+        Desc* desc;
+        uint64_t retire_ts;
+        std::vector<Node*> nodes;
+        std::vector<Node*> preds;
+        std::vector<MDNode*> md_nodes;
+        std::vector<MDNode*> md_preds;
+        std::vector<Node*> parents;
+        std::vector<uint32_t> dims;
+        std::vector<uint32_t> pred_dims;
+        Retired* next;
+    };
+
+    //Removals put off on every list of the process, any thread drains them, see DrainRetired
+    static Retired* volatile retired;
+    static void PushRetired(Retired* first, Retired* last);
+
+    //Entries of snapshot_ts the thread announced its open snapshots in, with the list of each
+    static __thread std::vector<std::pair<BasicAdjacencyList*, uint32_t>>* open_snapshots;
+
+    //Ordered execution finger, the predecessor found by the last vertex search of this thread and the list it belongs to
+    static __thread Node* finger;
+    static __thread BasicAdjacencyList* finger_list;
 
 public:
 	//Sentinel Nodes
 	Node* head;
 	Node* tail;
 
+    //Dense mode vertex table, NULL when vertices are kept in the list
+    Node** vertex_table;
+    uint32_t dense_range;
+
+    //Execute the ops of a transaction in vertex key order, resuming each vertex search from the previous one
+    //The ops are reordered in the descriptor, see ExecuteOps. Edge ops keep searching the mdlist from its head, the sort
+    //leaves the edge keys of one vertex unordered, and a later op may find the previous one's pred removed from the mdlist
+    bool ordered_ops;
+
+    //Split the mdlist edges of a vertex over split_ways mdlists once split_contention edge writes to it retried or overlapped
+    //The split is done by the last writer to leave the vertex and never undone
+    bool split_hot_edges;
+
+    //Source of commit timestamps and the number of open snapshots
+    volatile uint64_t commit_clock;
+    volatile uint32_t active_snapshots;
+    //The clock value plus one each open snapshot announced, 0 in a free entry, see OldestSnapshot
+    volatile uint64_t* snapshot_ts;
+    uint32_t snapshot_slots;
+
+    //Commits are appended here when set, see WriteAheadLog::Open
+    WriteAheadLog* wal;
+
+    //Commit timestamps drawn from the clock are published here when set, see ChangeFeed
+    ChangeFeed* feed;
+
+    //Built in a segment by CreateShared, the segment owns its memory
+    bool shared;
+
+    //A shard of a ShardedAdjacencyList, which cannot be logged, see WriteAheadLog::Open
+    bool sharded;
+
     int thread_count;
     int transaction_size;
 
@@ -109,5 +648,14 @@ public:
     PreAllocator<MDList> *mdlist_allocator;
     PreAllocator<MDNode> *mdnode_allocator;
     PreAllocator<MDDesc> *mddesc_allocator;
+    PreAllocator<Property> *property_allocator;
+    PreAllocator<ColdEdges> *cold_allocator;
+    PreAllocator<SplitEdges> *split_allocator;
+    PreAllocator<EdgeSlots> *slots_allocator;
+
+};
+
+typedef BasicAdjacencyList<uint32_t> AdjacencyList;
+typedef BasicAdjacencyList<uint64_t> AdjacencyList64;
 
-};
\ No newline at end of file
+#include "AdjacencyList_impl.h"
@@ -0,0 +1,3434 @@
+//Included at the end of AdjacencyList.h, the list is a template and lives in headers only
+#pragma once
+#include <atomic>
+#include <limits>
+#include <iostream>
+#include <thread>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <algorithm>
+#include "WriteAheadLog.h"
+#include "ChangeFeed.h"
+
+#define SET_MARK(_p)    ((Node *)(((uintptr_t)(_p)) | 1))
+#define CLR_MARK(_p)    ((Node *)(((uintptr_t)(_p)) & ~1))
+#define SET_MARKD(_p)    ((NodeDesc *)(((uintptr_t)(_p)) | 1))
+#define CLR_MARKD(_p)    ((NodeDesc *)(((uintptr_t)(_p)) & ~1))
+#define IS_MARKED(_p)     (((uintptr_t)(_p)) & 1)
+
+template<typename Key>
+__thread typename BasicAdjacencyList<Key>::HelpStack BasicAdjacencyList<Key>::helpStack;
+
+template<typename Key>
+__thread typename BasicAdjacencyList<Key>::Node* BasicAdjacencyList<Key>::finger;
+
+template<typename Key>
+__thread BasicAdjacencyList<Key>* BasicAdjacencyList<Key>::finger_list;
+
+template<typename Key>
+typename BasicAdjacencyList<Key>::Retired* volatile BasicAdjacencyList<Key>::retired;
+
+template<typename Key>
+__thread std::vector<std::pair<BasicAdjacencyList<Key>*, uint32_t>>* BasicAdjacencyList<Key>::open_snapshots;
+
+template<typename Key>
+BasicAdjacencyList<Key>::BasicAdjacencyList(int num_threads, int _transize, int ops, uint32_t _dense_range, SharedSegment* segment)
+	: head(NewSentinel(segment, 0))
+    , tail(NewSentinel(segment, std::numeric_limits<Key>::max()))
+    , vertex_table(_dense_range > 0 ? NewVertexTable(segment, _dense_range) : NULL)
+    , dense_range(_dense_range)
+    , ordered_ops(false)
+    , split_hot_edges(false)
+    , commit_clock(0)
+    , active_snapshots(0)
+    , snapshot_ts(NewSnapshotTable(segment, num_threads * snapshots_per_thread))
+    , snapshot_slots(num_threads * snapshots_per_thread)
+    , wal(NULL)
+    , feed(NULL)
+    , shared(segment != NULL)
+    , sharded(false)
+    , thread_count(num_threads)
+    , transaction_size(_transize)
+    {
+        node_allocator = NewAllocator<Node>(segment, num_threads, sizeof(Node), ops);
+        //Descriptors are variable sized, every op of a transaction fits in the units of a single op descriptor
+        desc_allocator = NewAllocator<Desc>(segment, num_threads, DESC_UNIT, ops * Desc::Units(1));
+        ndesc_allocator = NewAllocator<NodeDesc>(segment, num_threads, sizeof(NodeDesc), ops);
+        mdlist_allocator = NewAllocator<MDList>(segment, num_threads, sizeof(MDList), ops);
+        //MDNodes are variable width, the arena is sized for full width nodes and addressed in MDNODE_UNIT steps
+        if ((uint64_t)num_threads * ops * MDNode::Units(0) > MDNODE_MAX_UNITS)
+        {
+            printf("Error: MDNode arena exceeds the 32-bit child reference range\n");
+            std::exit(EXIT_FAILURE);
+        }
+        mdnode_allocator = NewAllocator<MDNode>(segment, num_threads, MDNODE_UNIT, ops * MDNode::Units(0));
+        mddesc_allocator = NewAllocator<MDDesc>(segment, num_threads, sizeof(MDDesc), ops);
+        //Properties are variable sized, the arena gives every op property_room bytes on average
+        property_allocator = NewAllocator<Property>(segment, num_threads, PROPERTY_UNIT, ops * Property::Units(property_room));
+        cold_allocator = NewAllocator<ColdEdges>(segment, num_threads, sizeof(uint64_t), ops * cold_room / sizeof(uint64_t));
+        //A split takes split_contention contended writes by any threads, any one thread may end up doing all the splits
+        split_allocator = NewAllocator<SplitEdges>(segment, num_threads, sizeof(SplitEdges), SplitRoom(num_threads, ops));
+        //A reclaim is started by an edge insert that found the inline slots full, at most one per op
+        slots_allocator = NewAllocator<EdgeSlots>(segment, num_threads, sizeof(EdgeSlots), ops);
+        head->next = tail;
+    }
+
+template<typename Key>
+typename BasicAdjacencyList<Key>::Node* BasicAdjacencyList<Key>::NewSentinel(SharedSegment* segment, Key key)
+{
+    if(segment == NULL)
+    {
+        return new Node(key, NULL, NULL, NULL);
+    }
+
+    return new(segment->Allocate(sizeof(Node))) Node(key, NULL, NULL, NULL);
+}
+
+template<typename Key>
+typename BasicAdjacencyList<Key>::Node** BasicAdjacencyList<Key>::NewVertexTable(SharedSegment* segment, uint32_t size)
+{
+    if(segment == NULL)
+    {
+        return new Node*[size]();
+    }
+
+    //A new segment is zero filled
+    return (Node**)segment->Allocate(sizeof(Node*) * (uint64_t)size);
+}
+
+template<typename Key>
+volatile uint64_t* BasicAdjacencyList<Key>::NewSnapshotTable(SharedSegment* segment, uint32_t size)
+{
+    if(segment == NULL)
+    {
+        return new uint64_t[size]();
+    }
+
+    return (volatile uint64_t*)segment->Allocate(sizeof(uint64_t) * (uint64_t)size);
+}
+
+//SplitEdges each thread has room for
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::SplitRoom(int num_threads, int ops)
+{
+    return (uint64_t)num_threads * ops / split_contention + 1;
+}
+
+template<typename Key>
+template<typename T>
+PreAllocator<T>* BasicAdjacencyList<Key>::NewAllocator(SharedSegment* segment, uint64_t num_threads, uint64_t type_size, uint64_t amount)
+{
+    if(segment == NULL)
+    {
+        return new PreAllocator<T>(num_threads, type_size, amount);
+    }
+
+    return new(segment->Allocate(sizeof(PreAllocator<T>))) PreAllocator<T>(num_threads, type_size, amount, segment);
+}
+
+template<typename Key>
+BasicAdjacencyList<Key>* BasicAdjacencyList<Key>::CreateShared(SharedSegment* segment, int num_threads, int transize, int ops, uint32_t dense_range)
+{
+    BasicAdjacencyList* list = new(segment->Allocate(sizeof(BasicAdjacencyList))) BasicAdjacencyList(num_threads, transize, ops, dense_range, segment);
+    segment->SetRoot(list);
+
+    return list;
+}
+
+template<typename Key>
+BasicAdjacencyList<Key>* BasicAdjacencyList<Key>::AttachShared(SharedSegment* segment)
+{
+    return (BasicAdjacencyList*)segment->Root();
+}
+
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::SharedSize(int num_threads, int ops, uint32_t dense_range)
+{
+    //Every allocation is rounded up to a cache line
+    uint64_t items = (uint64_t)num_threads * ops;
+    uint64_t size = sizeof(BasicAdjacencyList) + 2 * sizeof(Node) + sizeof(Node*) * (uint64_t)dense_range;
+    size += sizeof(uint64_t) * num_threads * snapshots_per_thread;
+
+    size += items * (sizeof(Node) + DESC_UNIT * Desc::Units(1) + sizeof(NodeDesc) + sizeof(MDList) + MDNODE_UNIT * MDNode::Units(0) + sizeof(MDDesc) + PROPERTY_UNIT * Property::Units(property_room) + cold_room + sizeof(EdgeSlots));
+    size += num_threads * sizeof(SplitEdges) * SplitRoom(num_threads, ops);
+    size += 10 * (sizeof(PreAllocator<Node>) + num_threads * PreAllocator<Node>::COUNTER_STRIDE * sizeof(uint64_t));
+
+    return size + 32 * 64;
+}
+
+template<typename Key>
+BasicAdjacencyList<Key>::~BasicAdjacencyList()
+{
+    //Removals put off on this list would otherwise be run on a dead list, no other thread may use it by now
+    Retired* entry = __sync_lock_test_and_set(&retired, (Retired*)NULL);
+
+    while(entry != NULL)
+    {
+        Retired* next = entry->next;
+
+        if(entry->list == this)
+        {
+            delete entry;
+        }
+        else
+        {
+            PushRetired(entry, entry);
+        }
+
+        entry = next;
+    }
+
+    //The segment owns all of a shared list's memory
+    if(shared)
+    {
+        return;
+    }
+
+    delete node_allocator;
+    delete desc_allocator;
+    delete ndesc_allocator;
+    delete mdlist_allocator;
+    delete mdnode_allocator;
+    delete mddesc_allocator;
+    delete property_allocator;
+    delete cold_allocator;
+    delete split_allocator;
+    delete slots_allocator;
+    delete[] vertex_table;
+    delete[] snapshot_ts;
+    delete head;
+    delete tail;
+}
+
+template<typename Key>
+typename BasicAdjacencyList<Key>::Desc* BasicAdjacencyList<Key>::AllocateDesc(uint32_t size)
+{
+    Desc* desc = desc_allocator->get_new(Desc::Units(size));
+    desc->size = size;
+    desc->status = ACTIVE;
+    desc->commit_ts = 0;
+    desc->wal_lsn = 0;
+    desc->coordinator = NULL;
+
+    bool* pending = desc->Pending();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        pending[i] = true;
+        desc->ops[i].property = NULL;
+    }
+    
+    return desc;
+}
+
+template<typename Key>
+void BasicAdjacencyList<Key>::Init()
+{
+    node_allocator->init();
+    desc_allocator->init();
+    ndesc_allocator->init();
+    mdlist_allocator->init();
+    mdnode_allocator->init();
+    mddesc_allocator->init();
+    property_allocator->init();
+    cold_allocator->init();
+    split_allocator->init();
+    slots_allocator->init();
+}
+
+template<typename Key>
+bool BasicAdjacencyList<Key>::ExecuteOps(Desc* desc)
+{
+    TRACE_SCOPE("ExecuteOps", desc, desc->size);
+    helpStack.Init();
+
+    //Ops on different vertices commute within a transaction, a stable sort on the vertex key keeps the order of ops on the same vertex
+    //Every transaction then visits vertices in the same order, which also avoids most cyclic helping
+    if(ordered_ops)
+    {
+        std::stable_sort(desc->ops, desc->ops + desc->size, [](const Operator& a, const Operator& b) { return a.key < b.key; });
+        finger_list = NULL;
+    }
+
+    HelpOps(desc, 0);
+
+    bool ret = desc->status != ABORTED;
+
+    //A helper may have committed us and not yet logged the commit
+    if(ret && wal != NULL)
+    {
+        CommitTs(desc);
+        wal->WaitDurable(wal->Append(desc));
+    }
+
+    return ret;
+}
+
+template<typename Key>
+bool BasicAdjacencyList<Key>::ExecuteCoordinated(Coordinator* coordinator)
+{
+    helpStack.Init();
+
+    //No other thread knows the parts yet, each is sorted like ExecuteOps sorts a transaction
+    for(uint32_t i = 0; i < coordinator->size; i++)
+    {
+        Desc* desc = coordinator->parts[i].desc;
+
+        if(coordinator->parts[i].shard->ordered_ops)
+        {
+            std::stable_sort(desc->ops, desc->ops + desc->size, [](const Operator& a, const Operator& b) { return a.key < b.key; });
+            finger_list = NULL;
+        }
+    }
+
+    ResolveCoordinator(coordinator);
+
+    //Shards are never logged, a part appended to its own shard's log could survive a crash without the others
+    return coordinator->status == COMMITTED;
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::MarkForDeletion(const std::vector<Node*>& nodes, const std::vector<Node*>& preds, const std::vector<MDNode*>& md_nodes, 
+    const std::vector<MDNode*>& md_preds, const std::vector<Node*>& parents, std::vector<uint32_t>& dims, std::vector<uint32_t>& predDims, Desc* desc)
+{ 
+    // Mark nodes for logical deletion
+    for(uint32_t i = 0; i < nodes.size(); ++i)
+    {
+        Node* n = nodes[i];
+        if(n != NULL)
+        {
+            NodeDesc* node_desc = n->node_desc;
+
+            if(node_desc->desc == desc)
+            {
+                //Mark node descriptor
+                //Dense table entries are not unlinked, the next insert of the key replaces them
+                if(__sync_bool_compare_and_swap(&n->node_desc, node_desc, SET_MARK(node_desc)) && vertex_table == NULL)
+                {
+                    Node* pred = preds[i];
+                    Node* succ = CLR_MARK(__sync_fetch_and_or(&n->next, 0x1));
+                    __sync_bool_compare_and_swap(&pred->next, n, succ); //Physical Removal
+                }
+            }
+        }
+    }
+
+    //Mark MDList nodes for logical deletion
+    for(uint32_t i = 0; i < md_nodes.size(); ++i)
+    {
+        MDNode* node = md_nodes[i];
+        MDNode* pred_node = md_preds[i];
+        uint32_t dim = dims[i];
+        uint32_t pred_dim = predDims[i];
+
+        if (node != NULL)
+        {
+            NodeDesc* node_desc = node->node_desc;
+
+            if(node_desc->desc == desc)
+            {
+                //Mark node descriptor
+                if(__sync_bool_compare_and_swap(&node->node_desc, node_desc, SET_MARK(node_desc)))
+                {
+                    Node* parent = parents[i];
+                    //Delete only follows the nodes, the vertex mdlist does for nodes of a split or thawed one too
+                    parent->m_list->Delete(pred_node, node, dim, pred_dim); //Mark pointer
+                }
+            }
+        }
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::HelpOps(Desc* desc, uint32_t opid)
+{
+    //The span depth shows how far helping recursed through FinishPendingTxn
+    TRACE_SCOPE("HelpOps", desc, opid);
+
+    if((int)desc->status != ACTIVE)
+    {
+        //A prepared part is settled with the rest of its transaction before its nodes are looked at
+        if(desc->status == PREPARED)
+        {
+            ResolveCoordinator(desc->coordinator);
+        }
+
+        return;
+    }
+
+    //Cyclic dependcy check
+    if(helpStack.Contain(desc))
+    {
+        __sync_bool_compare_and_swap(&desc->status, ACTIVE, ABORTED);
+        return;
+    }
+
+    ReturnCode ret = OK;
+
+    //Vertex Nodes
+    std::vector<Node*> delNodes;
+    std::vector<Node*> delPredNodes;
+    std::vector<Node*> insNodes;
+    std::vector<Node*> insPredNodes;
+
+    //Edge Nodes
+    std::vector<MDNode*> md_delNodes;
+    std::vector<MDNode*> md_delPredNodes;
+    std::vector<Node*> md_delParentNodes;
+    std::vector<uint32_t> md_delDims;
+    std::vector<uint32_t> md_delPredDims;
+
+    //Edge Nodes
+    std::vector<MDNode*> md_insNodes;
+    std::vector<MDNode*> md_insPredNodes;
+    std::vector<Node*> md_insParentNodes;
+    std::vector<uint32_t> md_insDims;
+    std::vector<uint32_t> md_insPredDims;
+
+    helpStack.Push(desc);
+
+    while(desc->status == ACTIVE && ret != FAIL && opid < desc->size)
+    {
+        const Operator& op = desc->ops[opid];
+
+        if(op.type == INSERT)
+        {
+            Node* inserted;
+            Node* pred = NULL;
+            ret = InsertVertex(op.key, desc, opid, inserted, pred);
+
+            insNodes.push_back(inserted);
+            insPredNodes.push_back(pred);
+        }
+        else if(op.type == DELETE)
+        {
+            Node* deleted;
+            Node* pred = NULL;
+            ret = DeleteVertex(op.key, desc, opid, deleted, pred);        
+
+            delNodes.push_back(deleted);
+            delPredNodes.push_back(pred);
+        }
+        else if (op.type == INSERT_EDGE)
+        {
+            MDNode* inserted;
+            MDNode* md_pred;
+            Node* parent;
+            uint32_t dim = 0;
+            uint32_t pred_dim = 0;
+
+            ret = InsertEdge(op.key, op.edge_key, desc, opid, inserted, md_pred, parent, dim, pred_dim);
+
+            md_insNodes.push_back(inserted);
+            md_insPredNodes.push_back(md_pred);
+            md_insParentNodes.push_back(parent);
+            md_insDims.push_back(dim);
+            md_insPredDims.push_back(pred_dim);  
+
+        }
+        else if (op.type == DELETE_EDGE)
+        {
+            MDNode* deleted;
+            MDNode* md_pred;
+            Node* parent;
+            uint32_t dim = 0;
+            uint32_t pred_dim = 0;
+
+            ret = DeleteEdge(op.key, op.edge_key, desc, opid, deleted, md_pred, parent, dim, pred_dim);
+
+            md_delNodes.push_back(deleted);
+            md_delPredNodes.push_back(md_pred);
+            md_delParentNodes.push_back(parent);
+            md_delDims.push_back(dim);
+            md_delPredDims.push_back(pred_dim);  
+        }
+        else
+        {
+            ret = Find(op.key, desc, opid);
+        }
+
+        opid++;
+    }
+
+    helpStack.Pop();
+
+    //The part of a cross-shard transaction only prepares, its coordinator decides whether it commits
+    uint8_t done = desc->coordinator != NULL ? PREPARED : COMMITTED;
+
+    if(ret != FAIL)
+    {
+        if(__sync_bool_compare_and_swap(&desc->status, ACTIVE, done))
+        {
+            if(done == PREPARED)
+            {
+                ResolveCoordinator(desc->coordinator);
+            }
+
+            if(desc->status == COMMITTED)
+            {
+                //The timestamp is drawn before checking for snapshots, a snapshot opened after the check is then ordered after this commit
+                CommitTs(desc);
+
+                if(wal != NULL)
+                {
+                    wal->Append(desc);
+                }
+
+                RemoveOrRetire(delNodes, delPredNodes, md_delNodes, md_delPredNodes, md_delParentNodes, md_delDims, md_delPredDims, desc);
+            }
+            else
+            {
+                RemoveOrRetire(insNodes, insPredNodes, md_insNodes, md_insPredNodes, md_insParentNodes, md_insDims, md_insPredDims, desc);
+            }
+        }
+        else if(desc->status == PREPARED)
+        {
+            ResolveCoordinator(desc->coordinator);
+        }
+    }
+    else
+    {
+        if(__sync_bool_compare_and_swap(&desc->status, ACTIVE, ABORTED))
+        {
+            //A reused node may carry versions an open snapshot still reads
+            RemoveOrRetire(insNodes, insPredNodes, md_insNodes, md_insPredNodes, md_insParentNodes, md_insDims, md_insPredDims, desc);
+        }     
+    }
+}
+
+//Physical removal would hide older versions from open snapshots, the removal is then put off until every open snapshot
+//is at least as new as the clock is now. It is drained by the EndSnapshot that closes the oldest snapshot, on any thread
+template<typename Key>
+inline void BasicAdjacencyList<Key>::RemoveOrRetire(std::vector<Node*>& nodes, std::vector<Node*>& preds, std::vector<MDNode*>& md_nodes,
+    std::vector<MDNode*>& md_preds, std::vector<Node*>& parents, std::vector<uint32_t>& dims, std::vector<uint32_t>& predDims, Desc* desc)
+{
+    //The timestamp of a delete is drawn by now, snapshots that open from here on read a clock at least this new
+    uint64_t retire_ts = __sync_fetch_and_add(&commit_clock, 0);
+
+    if(retire_ts <= OldestSnapshot())
+    {
+        MarkForDeletion(nodes, preds, md_nodes, md_preds, parents, dims, predDims, desc);
+        return;
+    }
+
+    Retired* entry = new Retired{this, desc, retire_ts, std::move(nodes), std::move(preds), std::move(md_nodes), std::move(md_preds),
+        std::move(parents), std::move(dims), std::move(predDims), NULL};
+    PushRetired(entry, entry);
+
+    //The snapshots holding it back may have closed before it was pushed, their drain then missed it
+    if(retire_ts <= OldestSnapshot())
+    {
+        DrainRetired();
+    }
+}
+
+template<typename Key>
+void BasicAdjacencyList<Key>::PushRetired(Retired* first, Retired* last)
+{
+    Retired* head;
+
+    do
+    {
+        head = retired;
+        last->next = head;
+    }
+    while(!__sync_bool_compare_and_swap(&retired, head, first));
+}
+
+//Runs the put off removals that no open snapshot can read anymore, whichever thread put them off
+//The drain takes the whole backlog and pushes back what is not due yet, a snapshot that closed meanwhile found it taken,
+//so the drain goes again if the oldest of the entries it pushed back became due
+template<typename Key>
+void BasicAdjacencyList<Key>::DrainRetired()
+{
+    while(true)
+    {
+        Retired* entry = __sync_lock_test_and_set(&retired, (Retired*)NULL);
+        Retired* kept = NULL;
+        Retired* kept_last = NULL;
+        BasicAdjacencyList* oldest_list = NULL;
+        uint64_t oldest_ts = 0;
+
+        //Entries of one list mostly follow each other, its oldest snapshot is read once for them
+        BasicAdjacencyList* list = NULL;
+        uint64_t oldest = 0;
+
+        while(entry != NULL)
+        {
+            Retired* next = entry->next;
+
+            if(entry->list != list)
+            {
+                list = entry->list;
+                oldest = list->OldestSnapshot();
+            }
+
+            if(entry->retire_ts <= oldest)
+            {
+                list->MarkForDeletion(entry->nodes, entry->preds, entry->md_nodes, entry->md_preds, entry->parents, entry->dims, entry->pred_dims, entry->desc);
+                delete entry;
+            }
+            else
+            {
+                if(oldest_list == NULL || entry->retire_ts < oldest_ts)
+                {
+                    oldest_list = list;
+                    oldest_ts = entry->retire_ts;
+                }
+
+                entry->next = kept;
+                kept = entry;
+                kept_last = kept_last != NULL ? kept_last : entry;
+            }
+
+            entry = next;
+        }
+
+        if(kept == NULL)
+        {
+            return;
+        }
+
+        PushRetired(kept, kept_last);
+
+        if(oldest_ts > oldest_list->OldestSnapshot())
+        {
+            return;
+        }
+    }
+}
+
+//The oldest clock value an open snapshot announced, the largest value if none is open
+//A snapshot that announces after its entry was read reads the clock after that, so it is at least as new as any
+//timestamp drawn before the call
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::OldestSnapshot()
+{
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+
+    if(active_snapshots == 0)
+    {
+        return oldest;
+    }
+
+    for(uint32_t i = 0; i < snapshot_slots; i++)
+    {
+        uint64_t announced = snapshot_ts[i];
+
+        if(announced != 0)
+        {
+            oldest = std::min(oldest, announced - 1);
+        }
+    }
+
+    return oldest;
+}
+
+//Whether every snapshot at least as new as oldest reads the newest committed version of the chain, drawing its timestamp
+//Only a version of a transaction that is still ACTIVE or PREPARED could come after it
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsSettledBy(NodeDesc* nodeDesc, uint64_t oldest)
+{
+    for(; nodeDesc != NULL; nodeDesc = nodeDesc->prev)
+    {
+        uint8_t status = nodeDesc->desc->status;
+
+        if(status == ACTIVE || status == PREPARED)
+        {
+            return false;
+        }
+
+        if(status == COMMITTED)
+        {
+            return CommitTs(nodeDesc->desc) <= oldest;
+        }
+    }
+
+    return true;
+}
+
+//Two phase commit over the parts of a cross-shard transaction, any thread may run it and any number at once
+template<typename Key>
+void BasicAdjacencyList<Key>::ResolveCoordinator(Coordinator* coordinator)
+{
+    //Prepare: each part is helped from its first op, ops a thread already did are skipped as when helping from a later one
+    for(uint32_t i = 0; i < coordinator->size && coordinator->status == ACTIVE; i++)
+    {
+        typename Coordinator::Part& part = coordinator->parts[i];
+
+        if(part.desc->status == ACTIVE)
+        {
+            part.shard->HelpOps(part.desc, 0);
+        }
+
+        if(part.desc->status == ABORTED)
+        {
+            break;
+        }
+    }
+
+    //A part is only ever ABORTED from ACTIVE before the decision, so all parts prepared means none can abort any more
+    uint8_t decision = COMMITTED;
+
+    for(uint32_t i = 0; i < coordinator->size; i++)
+    {
+        if(coordinator->parts[i].desc->status != PREPARED && coordinator->parts[i].desc->status != COMMITTED)
+        {
+            decision = ABORTED;
+            break;
+        }
+    }
+
+    __sync_bool_compare_and_swap(&coordinator->status, ACTIVE, decision);
+    decision = coordinator->status;
+
+    //Commit or abort: parts left active when another part aborted are aborted before they can prepare
+    for(uint32_t i = 0; i < coordinator->size; i++)
+    {
+        Desc* desc = coordinator->parts[i].desc;
+
+        if(decision == ABORTED)
+        {
+            __sync_bool_compare_and_swap(&desc->status, ACTIVE, ABORTED);
+        }
+
+        __sync_bool_compare_and_swap(&desc->status, PREPARED, decision);
+    }
+}
+
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsSameOperation(NodeDesc* nodeDesc1, NodeDesc* nodeDesc2)
+{
+    return nodeDesc1->desc == nodeDesc2->desc && nodeDesc1->opid == nodeDesc2->opid;
+}
+
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsNodeExist(Node* node, Key key)
+{
+    //The tail carries the largest key, which is a valid vertex key too
+    return node != NULL && node != tail && node->key == key;
+}
+
+//Returns True if the node is physically in the list, but may be logically deleted or part of a pending transaction
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsNodeExist(MDNode* node, Key key)
+{
+    return node != NULL && node->m_key == key;
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::FinishPendingTxn(NodeDesc* nodeDesc, Desc* desc)
+{
+    if(nodeDesc->desc == desc)
+    {
+        return;
+    }
+
+    //Check for incomplete DeleteVertex operation
+    //A pred descriptor is installed before its InsertEdge links the new node, so that op may not be done yet either
+    if ((nodeDesc->desc->ops[nodeDesc->opid].type == DELETE && nodeDesc->desc->Pending()[nodeDesc->opid]) || nodeDesc->override_as_find || nodeDesc->override_as_delete)
+    {
+        HelpOps(nodeDesc->desc, nodeDesc->opid);
+    }
+    else
+    {
+        HelpOps(nodeDesc->desc, nodeDesc->opid + 1);
+    }
+
+    //A transaction that builds on this one must commit after it, so its timestamp is fixed before we go on
+    //and its log record is appended before ours
+    if(nodeDesc->desc->status == COMMITTED)
+    {
+        CommitTs(nodeDesc->desc);
+
+        if(wal != NULL)
+        {
+            wal->Append(nodeDesc->desc);
+        }
+    }
+}
+
+//Returns the commit timestamp of a committed transaction, drawing one from the clock if no thread has yet
+//A draw is announced with COMMIT_TS_DRAWING before the clock is read, see IsCommittedBy
+//Threads that race here may waste clock values, only the first CAS after the announcement decides
+template<typename Key>
+inline uint64_t BasicAdjacencyList<Key>::CommitTs(Desc* desc)
+{
+    uint64_t ts = desc->commit_ts;
+
+    if(ts == 0 || ts == COMMIT_TS_DRAWING)
+    {
+        __sync_bool_compare_and_swap(&desc->commit_ts, 0, COMMIT_TS_DRAWING);
+
+        uint64_t new_ts = __sync_add_and_fetch(&commit_clock, 1);
+        ts = __sync_val_compare_and_swap(&desc->commit_ts, COMMIT_TS_DRAWING, new_ts);
+
+        if(ts == COMMIT_TS_DRAWING)
+        {
+            ts = new_ts;
+        }
+
+        //The feed reads the clock values in order, a wasted one is published as a hole
+        if(feed != NULL)
+        {
+            feed->Publish(new_ts, ts == new_ts ? desc : NULL);
+        }
+    }
+
+    return ts;
+}
+
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsNodeActive(NodeDesc* nodeDesc)
+{
+    return nodeDesc->desc->status == COMMITTED;
+}
+
+//Returns True if the node logically exists
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsKeyExist(NodeDesc* nodeDesc)
+{
+    //Placed on an absent pred by InsertEdge, the key stays absent whatever the op and status
+    if(nodeDesc->override_as_delete)
+    {
+        return false;
+    }
+
+    bool isNodeActive = IsNodeActive(nodeDesc);
+    uint8_t opType = nodeDesc->desc->ops[nodeDesc->opid].type;
+
+    return  (opType == FIND || opType == SET_PROPERTY || nodeDesc->override_as_find) || (isNodeActive && (opType == INSERT || opType == INSERT_EDGE)) || (!isNodeActive && (opType == DELETE || opType == DELETE_EDGE || nodeDesc->override_as_delete));
+}
+
+template<typename Key>
+inline ReturnCode BasicAdjacencyList<Key>::Find(Key key, Desc* desc, uint32_t opid)
+{
+	Node *pred = nullptr, *current = head;
+
+	NodeDesc *n_desc = NULL;
+
+	while (true)
+	{
+		LocateVertex(pred, current, key);
+		
+		if(IsNodeExist(current, key))
+        {
+            NodeDesc* current_desc = current->node_desc;
+
+            if(IS_MARKED(current_desc))
+            {
+                //A marked table entry stays until the vertex is inserted again
+                if(vertex_table != NULL)
+                {
+                    return FAIL;
+                }
+
+                if(!IS_MARKED(current->next))
+                {
+                    (__sync_fetch_and_or(&current->next, 0x1));
+                }
+                current = head;
+                continue;
+            }
+
+            FinishPendingTxn(current_desc, desc);
+
+            if(n_desc == NULL) 
+            {  
+                n_desc = new(ndesc_allocator->get_new()) NodeDesc(desc, opid);
+            }
+
+            if(IsSameOperation(current_desc, n_desc))
+            {
+                return SKIP;
+            }
+
+            if(IsKeyExist(current_desc))
+            {
+                if(desc->status != ACTIVE)
+                {
+                    return FAIL;
+                }
+
+                //Update desc 
+                n_desc->prev = current_desc;
+                n_desc->property = desc->ops[opid].type == SET_PROPERTY ? desc->ops[opid].property : CurrentProperty(current_desc, desc);
+                if(__sync_bool_compare_and_swap(&current->node_desc, current_desc, n_desc))
+                {
+                    return OK; 
+                }
+            }
+            else
+            {
+                return FAIL;
+            }
+        }
+        else 
+        {
+            return FAIL;
+        }
+	}
+}
+
+template<typename Key>
+inline ReturnCode BasicAdjacencyList<Key>::InsertVertex(Key vertex, Desc* desc, uint32_t opid, Node*& inserted, Node*& pred)
+{
+	inserted = NULL;
+    Node *new_node = NULL;
+    Node *current = head;
+
+    NodeDesc *n_desc = new(ndesc_allocator->get_new()) NodeDesc(desc, opid);
+    n_desc->property = desc->ops[opid].property;
+
+    while(true)
+    {
+        LocateVertex(pred, current, vertex);
+
+        //Check if node is physically in the list
+        if(!IsNodeExist(current, vertex) || (vertex_table != NULL && IS_MARKED(current->node_desc)))
+        {
+            if(desc->status != ACTIVE || (vertex_table != NULL && vertex >= dense_range))
+            {
+                return FAIL;
+            }
+
+            if(new_node == NULL)
+            {
+                //Allocate new vertex node, its mdlist is only allocated once the inline edges run out
+                new_node = new(node_allocator->get_new()) Node(vertex, NULL, n_desc, NULL);
+            }
+
+            //A new node starts its own version chain
+            n_desc->prev = NULL;
+
+            //In dense mode a missing or deleted vertex is replaced directly in its table entry
+            if(vertex_table != NULL)
+            {
+                if(__sync_bool_compare_and_swap(&vertex_table[vertex], current, new_node))
+                {
+                    inserted = new_node;
+                    return OK;
+                }
+
+                continue;
+            }
+
+            new_node->next = current;
+
+            //Node is not physically in the list, perform physical insertion
+            if(__sync_bool_compare_and_swap(&pred->next, current, new_node))
+            {
+                inserted = new_node;
+                return OK;
+            }
+
+            current = IS_MARKED(pred->next) ? head : pred;
+        }
+        else //If the node is physically in the list, it may be possible to simply update the descriptor
+        {
+            NodeDesc* current_desc = current->node_desc;
+
+            //Check if node descriptor is marked for deletion
+            //If it has, we cannot update the descriptor and must perform physical removal
+            if(IS_MARKED(current_desc))
+            {
+                //DO_DELETE
+                if(!IS_MARKED(current->next))
+                {
+                    (__sync_fetch_and_or(&current->next, 0x1));
+                }
+                current = head;
+                continue;
+            }
+
+            FinishPendingTxn(current_desc, desc);
+
+            if(IsSameOperation(current_desc, n_desc))
+            {
+                return SKIP;
+            }
+
+            //Check is node is logically in the list
+            if(!IsKeyExist(current_desc))
+            {
+                //Check if our transaction has been aborted by another thread
+                if(desc->status != ACTIVE)
+                {
+                    return FAIL;
+                }
+
+                //If the node is not logically in the list, and the descriptor has not been marked yet, we can try to update the descriptor
+                //Doing so completes our insert
+                n_desc->prev = current_desc;
+                if(__sync_bool_compare_and_swap(&current->node_desc, current_desc, n_desc))
+                {
+                    inserted = current;
+                    return OK; 
+                }
+        
+            }
+            else
+            {
+                return FAIL;
+            }
+        }
+    }
+}
+
+template<typename Key>
+inline ReturnCode BasicAdjacencyList<Key>::DeleteVertex(Key vertex, Desc* desc, uint32_t opid, Node*& deleted, Node*& pred)
+{
+	deleted = NULL;
+    Node *current = head;
+
+    NodeDesc* node_desc = new(ndesc_allocator->get_new()) NodeDesc(desc, opid);
+
+    while(true)
+    {
+        LocateVertex(pred, current, vertex);
+
+        if(IsNodeExist(current, vertex))
+        {
+            NodeDesc* current_desc = current->node_desc;
+
+            if(IS_MARKED(current_desc))
+            {
+                return FAIL;
+            }
+
+            FinishPendingTxn(current_desc, desc);
+
+            //DeleteVertex is the only operation that is not complete when the node descriptor is placed in the node
+            //It is only complete when all edge nodes have also been updated, thus we must check for that case here
+            if(IsSameOperation(current_desc, node_desc))
+            {
+                //Check if deleteVertex operation is ongoing
+                if (desc->Pending()[opid] == false)
+                {
+                    FinishDeleteInline(current, desc, node_desc);
+                    FinishDeleteEdges(current, desc, node_desc);
+
+                    //Only allow the thread that marks the operation complete to perform physical updates
+                    if (__sync_bool_compare_and_swap(&desc->Pending()[opid], true, false))
+                    {
+                        deleted = current;
+                        return OK;
+                    }
+                }
+                return SKIP;
+            }
+
+            if(IsKeyExist(current_desc))
+            {
+                if(desc->status != ACTIVE)
+                {
+                    return FAIL;
+                }
+
+                node_desc->prev = current_desc;
+                if(__sync_bool_compare_and_swap(&current->node_desc, current_desc, node_desc))
+                {
+                    FinishDeleteInline(current, desc, node_desc);
+                    FinishDeleteEdges(current, desc, node_desc);
+
+                    //Only allow the thread that marks the operation complete to perform physical updates
+                    if (__sync_bool_compare_and_swap(&desc->Pending()[opid], true, false))
+                    {
+                        deleted = current;
+                        return OK;
+                    }
+                }
+            }
+            else
+            {
+                return FAIL;
+            }  
+        }
+        else 
+        {
+            return FAIL;      
+        }
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::FinishDeleteVertex(MDList* m_list, MDNode* n, int dim, Desc *desc, NodeDesc *node_desc, int DIMENSION)
+{
+    TRACE_SCOPE("FinishDeleteVertex", desc, dim);
+
+    //Update Desc
+    while (true)
+    {
+        NodeDesc* current_desc = n->node_desc;
+
+        //A marked node is already deleted, but its children are only reachable through it until an insert adopts them
+        if (current_desc == NULL || IS_MARKED(current_desc))
+        {
+            break;
+        }
+
+        FinishPendingTxn(current_desc, desc);
+
+        if(desc->status != ACTIVE)
+        {
+            return;
+        }
+
+        //Move on to the next children if we either succeed a CAS to update the descriptor or we see that a different thread has already done so
+        //Absent edges keep their descriptor, otherwise an abort of the delete would bring them back
+        //Every edge gets its own copy of the descriptor to chain its previous version
+        if(IsSameOperation(current_desc, node_desc) || !IsKeyExist(current_desc) || __sync_bool_compare_and_swap(&n->node_desc, current_desc, CopyDesc(node_desc, current_desc)))
+        {
+            break;
+        }
+    }
+
+    MDDesc* pending = n->m_pending;
+    //If a pending child adoption is occuring, make sure it completes so that no nodes are missed in traversal
+    //A new child adoption cannot occur at this node, as our mdlist only creates adoption descriptors in new nodes during insertion
+    if (pending)
+    {
+        m_list->FinishInserting(n, pending);
+    }
+
+    for (int i = DIMENSION - 1; i >= dim; --i) 
+    {
+        MDNode *child = m_list->Deref(n->Child(i));
+
+        if(child != NULL)
+        {
+            FinishDeleteVertex(m_list, child, i, desc, node_desc, DIMENSION);
+        }
+    }
+}
+
+//Frozen edges are thawed first and a split is finished, a delete marks every mdlist node
+template<typename Key>
+inline void BasicAdjacencyList<Key>::FinishDeleteEdges(Node* node, Desc *desc, NodeDesc *node_desc)
+{
+    EdgeWriter writer(this, node);
+    SplitEdges* split = node->m_split;
+    MDList* m_list = node->m_list;
+
+    if (split != NULL)
+    {
+        for (uint32_t i = 0; i < split_ways; i++)
+        {
+            FinishDeleteVertex(split->parts[i], split->parts[i]->m_head, 0, desc, node_desc, DIMENSION);
+        }
+    }
+    else if (m_list != NULL)
+    {
+        FinishDeleteVertex(m_list, m_list->m_head, 0, desc, node_desc, DIMENSION);
+    }
+}
+
+//Copies a descriptor for one more node, each node chains its own previous version
+template<typename Key>
+inline typename BasicAdjacencyList<Key>::NodeDesc* BasicAdjacencyList<Key>::CopyDesc(NodeDesc* nodeDesc, NodeDesc* prev)
+{
+    NodeDesc* copy = new(ndesc_allocator->get_new()) NodeDesc(nodeDesc->desc, nodeDesc->opid);
+    copy->prev = prev;
+
+    return copy;
+}
+
+//Every slot gets the descriptor, free and absent ones a copy that keeps them absent, so no insert of an edge can replace
+//a slot's descriptor unseen. A block reclaimed meanwhile is walked again in its copy, which has the copies placed so far
+template<typename Key>
+inline void BasicAdjacencyList<Key>::FinishDeleteInline(Node* node, Desc *desc, NodeDesc *node_desc)
+{
+    //One copy does for all the empty slots, it has no previous version to chain
+    NodeDesc* empty_desc = NULL;
+    bool reclaimed = true;
+
+    while (reclaimed)
+    {
+        EdgeSlots* slots = SlotsOf(node->edge_slots);
+        reclaimed = false;
+
+        for (uint32_t i = 0; i <= ZERO_SLOT && !reclaimed; i++)
+        {
+            while (true)
+            {
+                NodeDesc* current_desc = slots->descs[i];
+
+                if (IS_MARKED(current_desc))
+                {
+                    HelpReclaim(node, slots);
+                    reclaimed = true;
+                    break;
+                }
+
+                if (current_desc != NULL)
+                {
+                    FinishPendingTxn(current_desc, desc);
+                }
+
+                if(desc->status != ACTIVE)
+                {
+                    return;
+                }
+
+                if (current_desc != NULL && IsSameOperation(current_desc, node_desc))
+                {
+                    break;
+                }
+
+                NodeDesc* copy;
+
+                if (current_desc == NULL)
+                {
+                    if (empty_desc == NULL)
+                    {
+                        empty_desc = CopyDesc(node_desc, NULL);
+                        empty_desc->override_as_delete = true;
+                    }
+
+                    copy = empty_desc;
+                }
+                else
+                {
+                    copy = CopyDesc(node_desc, current_desc);
+
+                    //An absent edge has to stay absent if the delete aborts
+                    copy->override_as_delete = !IsKeyExist(current_desc);
+                }
+
+                if(__sync_bool_compare_and_swap(&slots->descs[i], current_desc, copy))
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+//The block of inline adjacencies in an edge_slots word
+template<typename Key>
+inline typename BasicAdjacencyList<Key>::EdgeSlots* BasicAdjacencyList<Key>::SlotsOf(uint64_t state)
+{
+    return (EdgeSlots*)(state & ~(SLOTS_PROMOTED | SLOTS_RECLAIMING));
+}
+
+//Finds the inline slot holding edge, when claim is set a free slot is taken for it
+//Slots are claimed strictly in order, so two threads claiming the same edge always race for the same slot
+//Returns -1 if the edge is not inline and no slot could be claimed, edge 0 always has its slot
+template<typename Key>
+inline int BasicAdjacencyList<Key>::LocateInlineEdge(EdgeSlots* slots, Key edge, bool claim)
+{
+    if (edge == 0)
+    {
+        return ZERO_SLOT;
+    }
+
+    for (uint32_t i = 0; i < inline_edges; i++)
+    {
+        Key key = slots->keys[i];
+
+        if (key == 0)
+        {
+            if (!claim)
+            {
+                return -1;
+            }
+
+            key = __sync_val_compare_and_swap(&slots->keys[i], 0, edge);
+
+            if (key == 0)
+            {
+                return i;
+            }
+        }
+
+        if (key == edge)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+//Makes room for an edge that found every inline slot of node taken, state is the edge_slots word it found
+//If a slot holds an edge that is settled absent the block is reclaimed, otherwise the block is promoted and stays the
+//last one, a key is then either in it or in the mdlist. Promotion and reclaim both replace the unflagged word,
+//so a block is never reclaimed once edges went to the mdlist past it
+template<typename Key>
+inline void BasicAdjacencyList<Key>::ReclaimSlots(Node* node, uint64_t state)
+{
+    EdgeSlots* slots = SlotsOf(state);
+
+    if (state & SLOTS_RECLAIMING)
+    {
+        HelpReclaim(node, slots);
+        return;
+    }
+
+    //Versions of an absent edge that an open snapshot may still read would be copied
+    uint64_t oldest = OldestSnapshot();
+    bool absent = false;
+
+    for (uint32_t i = 0; i < inline_edges && !absent; i++)
+    {
+        NodeDesc* current_desc = CLR_MARKD(slots->descs[i]);
+        uint8_t status = current_desc != NULL ? current_desc->desc->status : ABORTED;
+
+        absent = current_desc == NULL || ((status == COMMITTED || status == ABORTED) && !IsKeyExist(current_desc) && IsSettledBy(current_desc, oldest));
+    }
+
+    if (!absent)
+    {
+        __sync_bool_compare_and_swap(&node->edge_slots, state, state | SLOTS_PROMOTED);
+        return;
+    }
+
+    if (slots->next == NULL)
+    {
+        EdgeSlots* next = new(slots_allocator->get_new()) EdgeSlots();
+        __sync_bool_compare_and_swap(&slots->next, NULL, next);
+    }
+
+    if (__sync_bool_compare_and_swap(&node->edge_slots, state, state | SLOTS_RECLAIMING))
+    {
+        HelpReclaim(node, slots);
+    }
+}
+
+//Copies the slots of a block being reclaimed that are still needed to its next block and makes that the current one
+//Every slot is sealed first by marking its descriptor, an op that meets a mark helps and goes on in the copy.
+//The first thread to decide which slots are kept publishes it, every helper then copies the same slots
+//An absent edge is only dropped once every open snapshot is at least as new as its last commit, a snapshot that opens
+//later is as well, so all of them see the edge absent in the copy too
+template<typename Key>
+inline void BasicAdjacencyList<Key>::HelpReclaim(Node* node, EdgeSlots* slots)
+{
+    EdgeSlots* next = slots->next;
+
+    for (uint32_t i = 0; i <= ZERO_SLOT; i++)
+    {
+        while (true)
+        {
+            NodeDesc* current_desc = slots->descs[i];
+
+            if (IS_MARKED(current_desc) || __sync_bool_compare_and_swap(&slots->descs[i], current_desc, SET_MARKD(current_desc)))
+            {
+                break;
+            }
+        }
+    }
+
+    if (slots->keep == 0)
+    {
+        uint32_t keep = SLOTS_DECIDED;
+        uint64_t oldest = OldestSnapshot();
+
+        for (uint32_t i = 0; i <= ZERO_SLOT; i++)
+        {
+            NodeDesc* current_desc = CLR_MARKD(slots->descs[i]);
+
+            //A claimed slot without a descriptor never held the edge
+            if (current_desc == NULL)
+            {
+                continue;
+            }
+
+            Desc* current = current_desc->desc;
+
+            if (current->status == ACTIVE || current->status == PREPARED || IsKeyExist(current_desc) || !IsSettledBy(current_desc, oldest))
+            {
+                keep |= 1u << i;
+            }
+        }
+
+        __sync_bool_compare_and_swap(&slots->keep, 0, keep);
+    }
+
+    //Kept slots are copied in order, their keys and the descriptors they were sealed with never change
+    //The copy is only changed once published, a late helper finds its slots set and leaves them
+    uint32_t keep = slots->keep;
+
+    for (uint32_t i = 0, j = 0; i < inline_edges; i++)
+    {
+        if (keep & (1u << i))
+        {
+            __sync_bool_compare_and_swap(&next->keys[j], 0, slots->keys[i]);
+            __sync_bool_compare_and_swap(&next->descs[j], NULL, CLR_MARKD(slots->descs[i]));
+            j++;
+        }
+    }
+
+    if (keep & (1u << ZERO_SLOT))
+    {
+        __sync_bool_compare_and_swap(&next->descs[ZERO_SLOT], NULL, CLR_MARKD(slots->descs[ZERO_SLOT]));
+    }
+
+    __sync_bool_compare_and_swap(&node->edge_slots, (uint64_t)slots | SLOTS_RECLAIMING, (uint64_t)next);
+}
+
+//Whether the vertex of node is still there for an edge insert of desc, checked after the insert read the descriptor it replaces
+//A DeleteVertex puts its descriptor on the vertex before it walks the edges, so either the walk meets the insert's
+//descriptor or the insert sees the delete here, also when the walk found no mdlist that the insert promoted since
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsVertexLive(Node* node, Desc* desc)
+{
+    NodeDesc* vertex_desc = node->node_desc;
+
+    if(IS_MARKED(vertex_desc))
+    {
+        return false;
+    }
+
+    //An earlier op of the transaction deleted the vertex
+    if(vertex_desc->desc == desc)
+    {
+        return desc->ops[vertex_desc->opid].type != DELETE;
+    }
+
+    FinishPendingTxn(vertex_desc, desc);
+
+    return IsKeyExist(vertex_desc);
+}
+
+//Returns the mdlist edge goes in, allocating the vertex mdlist the first time an edge does not fit inline
+template<typename Key>
+inline typename BasicAdjacencyList<Key>::MDList* BasicAdjacencyList<Key>::PromoteEdges(Node* node, Key edge)
+{
+    //Edges are only split once there is an mdlist to split
+    if (node->m_split != NULL)
+    {
+        return EdgeList(node, edge);
+    }
+
+    MDList* m_list = node->m_list;
+
+    if (m_list == NULL)
+    {
+        NodeDesc* vertex_desc = CLR_MARKD(node->node_desc);
+        NodeDesc* head_desc = new(ndesc_allocator->get_new()) NodeDesc(vertex_desc->desc, vertex_desc->opid);
+        MDList* new_list = new(mdlist_allocator->get_new()) MDList(key_range, head_desc, mdnode_allocator, mddesc_allocator);
+
+        m_list = __sync_val_compare_and_swap(&node->m_list, NULL, new_list);
+
+        if (m_list == NULL)
+        {
+            m_list = new_list;
+        }
+    }
+
+    return m_list;
+}
+
+//The mdlist that holds edge, NULL while the vertex has none
+template<typename Key>
+inline typename BasicAdjacencyList<Key>::MDList* BasicAdjacencyList<Key>::EdgeList(Node* node, Key edge)
+{
+    SplitEdges* split = node->m_split;
+
+    return split != NULL ? split->parts[SplitEdges::PartOf(edge)] : node->m_list;
+}
+
+//The frozen edges of a node, NULL while its tier word is a write gate or a split
+template<typename Key>
+inline typename BasicAdjacencyList<Key>::ColdEdges* BasicAdjacencyList<Key>::ColdOf(Node* node)
+{
+    uint64_t tier = node->tier;
+
+    return (tier & (TIER_GATE | TIER_SPLITTING)) ? NULL : (ColdEdges*)tier;
+}
+
+//Counts a writer into the gate of node, thawing its edges first if they are frozen and helping a split that started
+//Writers never wait for each other here, the gate only keeps a freeze or a split from starting while they are inside
+template<typename Key>
+inline void BasicAdjacencyList<Key>::EnterEdges(Node* node)
+{
+    while (true)
+    {
+        uint64_t tier = node->tier;
+
+        if (tier & TIER_GATE)
+        {
+            if (__sync_bool_compare_and_swap(&node->tier, tier, tier + TIER_GENERATION + TIER_WRITER))
+            {
+                if ((tier & TIER_WRITERS) != 0)
+                {
+                    NoteContention(node);
+                }
+
+                return;
+            }
+        }
+        else if (tier & TIER_SPLITTING)
+        {
+            HelpSplit(node, (SplitEdges*)(tier & ~TIER_SPLITTING));
+        }
+        else
+        {
+            ThawEdges(node, (ColdEdges*)tier);
+        }
+    }
+}
+
+//The last writer out of a contended vertex starts the split of its edges, no op is in them at that point
+template<typename Key>
+inline void BasicAdjacencyList<Key>::ExitEdges(Node* node)
+{
+    uint64_t tier = __sync_sub_and_fetch(&node->tier, TIER_WRITER);
+
+    if (split_hot_edges && (tier & TIER_WRITERS) == 0 && node->contention >= split_contention && node->m_split == NULL && node->m_list != NULL)
+    {
+        StartSplit(node, tier);
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::NoteContention(Node* node)
+{
+    if (split_hot_edges && node->m_split == NULL)
+    {
+        __sync_fetch_and_add(&node->contention, 1);
+    }
+}
+
+//Links a new node into an mdlist no other thread writes yet, the keys come in ascending order
+template<typename Key>
+inline void BasicAdjacencyList<Key>::AppendEdge(MDList* m_list, Key edge, NodeDesc* node_desc)
+{
+    uint8_t m_coord[DIMENSION];
+    MDNode* new_node = NULL;
+    MDNode* md_pred = NULL;
+    MDNode* md_current = m_list->m_head;
+    uint32_t dim = 0;
+    uint32_t pred_dim = 0;
+
+    m_list->KeyToCoord(edge, m_coord);
+
+    while (true)
+    {
+        m_list->LocatePred(m_coord, md_pred, md_current, dim, pred_dim);
+
+        if (new_node == NULL)
+        {
+            new_node = m_list->NewNode(edge, node_desc, pred_dim);
+        }
+
+        if (m_list->Insert(new_node, md_pred, md_current, dim, pred_dim))
+        {
+            return;
+        }
+
+        md_current = m_list->m_head;
+        dim = 0;
+        pred_dim = 0;
+    }
+}
+
+//Rebuilds frozen edges in a new mdlist and puts it and a write gate back in the node
+//Racing threads may each build one, the first published is the one every thread installs
+template<typename Key>
+inline void BasicAdjacencyList<Key>::ThawEdges(Node* node, ColdEdges* cold)
+{
+    if (cold->thawed == NULL)
+    {
+        //Every edge comes back as inserted by a transaction that committed when the edges were frozen
+        //The edges were logged long before, so the transaction counts as logged from the start
+        Desc* desc = desc_allocator->get_new(Desc::Units(1));
+        desc->size = 1;
+        desc->status = COMMITTED;
+        desc->commit_ts = cold->commit_ts;
+        desc->wal_lsn = 1;
+        desc->coordinator = NULL;
+        desc->ops[0].type = INSERT_EDGE;
+        desc->ops[0].key = node->key;
+        desc->ops[0].edge_key = 0;
+        desc->ops[0].property = NULL;
+        desc->Pending()[0] = false;
+
+        //Versions start afresh in the new nodes, the head keeps the descriptor it had when the edges were frozen
+        NodeDesc* edge_desc = new(ndesc_allocator->get_new()) NodeDesc(desc, 0);
+        MDList* m_list = new(mdlist_allocator->get_new()) MDList(key_range, cold->detached->m_head->node_desc, mdnode_allocator, mddesc_allocator);
+
+        cold->Decode(0, [&](Key edge)
+        {
+            AppendEdge(m_list, edge, edge_desc);
+            return true;
+        });
+
+        __sync_bool_compare_and_swap(&cold->thawed, NULL, m_list);
+    }
+
+    //The mdlist is in place before the gate, a reader that finds the gate finds the thawed edges
+    __sync_bool_compare_and_swap(&node->m_list, cold->detached, cold->thawed);
+    __sync_bool_compare_and_swap(&node->tier, (uint64_t)cold, (cold->generation + 1) * TIER_GENERATION | TIER_GATE);
+}
+
+//Claims the gate for a split if no writer entered since the last one left
+template<typename Key>
+inline void BasicAdjacencyList<Key>::StartSplit(Node* node, uint64_t gate)
+{
+    //A writer entering in between makes the claim fail, the split it would have started is then up to the next one out
+    SplitEdges* split = split_allocator->get_new();
+    split->generation = gate / TIER_GENERATION;
+    split->source = node->m_list;
+
+    for (uint32_t i = 0; i < split_ways; i++)
+    {
+        split->parts[i] = NULL;
+    }
+
+    if (__sync_bool_compare_and_swap(&node->tier, gate, (uint64_t)split | TIER_SPLITTING))
+    {
+        HelpSplit(node, split);
+    }
+}
+
+//Copies every linked node of the source into the part of its key, each copy takes over the version chain of its node
+//so snapshots read the parts as they read the source. No writer changes the source once the split is claimed,
+//racing threads may each build a part, the first published is the one every thread uses
+template<typename Key>
+inline void BasicAdjacencyList<Key>::HelpSplit(Node* node, SplitEdges* split)
+{
+    bool built = true;
+
+    for (uint32_t i = 0; i < split_ways; i++)
+    {
+        built = built && split->parts[i] != NULL;
+    }
+
+    if (!built)
+    {
+        static __thread std::vector<std::pair<Key, NodeDesc*>>* edges = NULL;
+        if (edges == NULL)
+        {
+            edges = new std::vector<std::pair<Key, NodeDesc*>>();
+        }
+
+        MDList* source = split->source;
+        edges->clear();
+        CollectLinked(source, source->m_head, 0, *edges);
+
+        //A node copied by an adoption can be met twice
+        std::stable_sort(edges->begin(), edges->end(), [](const std::pair<Key, NodeDesc*>& a, const std::pair<Key, NodeDesc*>& b) { return a.first < b.first; });
+        edges->erase(std::unique(edges->begin(), edges->end(), [](const std::pair<Key, NodeDesc*>& a, const std::pair<Key, NodeDesc*>& b) { return a.first == b.first; }), edges->end());
+
+        for (uint32_t i = 0; i < split_ways; i++)
+        {
+            if (split->parts[i] != NULL)
+            {
+                continue;
+            }
+
+            //The heads keep the descriptor the source head had, InsertEdge only overrides it as a pred
+            MDList* part = new(mdlist_allocator->get_new()) MDList(key_range, CLR_MARKD(source->m_head->node_desc), mdnode_allocator, mddesc_allocator);
+
+            for (const std::pair<Key, NodeDesc*>& edge : *edges)
+            {
+                if (SplitEdges::PartOf(edge.first) == i)
+                {
+                    AppendEdge(part, edge.first, edge.second);
+                }
+            }
+
+            __sync_bool_compare_and_swap(&split->parts[i], NULL, part);
+        }
+    }
+
+    //The parts are in place before the gate, a reader or writer that finds the gate finds the parts
+    __sync_bool_compare_and_swap(&node->m_split, NULL, split);
+    __sync_bool_compare_and_swap(&node->tier, (uint64_t)split | TIER_SPLITTING, (split->generation + 1) * TIER_GENERATION | TIER_GATE);
+}
+
+//Gathers the key and descriptor of every node that is not marked, whatever its state, older snapshots may still see it
+template<typename Key>
+inline void BasicAdjacencyList<Key>::CollectLinked(MDList* m_list, MDNode* n, int dim, std::vector<std::pair<Key, NodeDesc*>>& edges)
+{
+    NodeDesc* node_desc = n->node_desc;
+
+    if (n != m_list->m_head && !IS_MARKED(node_desc))
+    {
+        edges.push_back(std::make_pair(n->m_key, node_desc));
+    }
+
+    MDDesc* pending = n->m_pending;
+    if (pending)
+    {
+        m_list->FinishInserting(n, pending);
+    }
+
+    for (int i = DIMENSION - 1; i >= dim; --i)
+    {
+        MDNode* child = m_list->Deref(n->Child(i));
+
+        if (child != NULL)
+        {
+            CollectLinked(m_list, child, i, edges);
+        }
+    }
+}
+
+//Gathers the keys of the visible edges of a frozen candidate and the newest commit timestamp of any of their versions
+//Returns false if a node carries a descriptor of a transaction that may still commit or abort
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::CollectSettled(MDList* m_list, MDNode* n, int dim, std::vector<Key>& edges, uint64_t& newest)
+{
+    NodeDesc* node_desc = n->node_desc;
+
+    //A marked node belongs to a committed delete, it only links its children
+    //The head and the preds carry the overrides of InsertEdge, those settle like any version
+    if (!IS_MARKED(node_desc))
+    {
+        for (NodeDesc* version = node_desc; version != NULL; version = version->prev)
+        {
+            uint8_t status = version->desc->status;
+
+            if (status == ACTIVE || status == PREPARED)
+            {
+                return false;
+            }
+
+            if (status == COMMITTED)
+            {
+                newest = std::max(newest, CommitTs(version->desc));
+            }
+        }
+
+        if (n != m_list->m_head && IsKeyVisible(node_desc, std::numeric_limits<uint64_t>::max()))
+        {
+            edges.push_back(n->m_key);
+        }
+    }
+
+    MDDesc* pending = n->m_pending;
+    if (pending)
+    {
+        m_list->FinishInserting(n, pending);
+    }
+
+    for (int i = DIMENSION - 1; i >= dim; --i)
+    {
+        MDNode* child = m_list->Deref(n->Child(i));
+
+        if (child != NULL && !CollectSettled(m_list, child, i, edges, newest))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//A freeze reads the gate, checks the edges are settled, encodes them and swaps the array in for the gate it read
+//A writer entering in between moves the gate on and the swap fails, one entering after it finds the array and thaws it
+template<typename Key>
+bool BasicAdjacencyList<Key>::Freeze(Node* node, uint64_t min_age, uint32_t min_edges)
+{
+    uint64_t gate = node->tier;
+    MDList* m_list = node->m_list;
+    NodeDesc* vertex_desc = node->node_desc;
+
+    if (!(gate & TIER_GATE) || (gate & TIER_WRITERS) != 0 || m_list == NULL || node->m_split != NULL)
+    {
+        return false;
+    }
+
+    //A vertex being deleted still has to reach its edges, a deleted one keeps them as they are
+    if (IS_MARKED(vertex_desc) || vertex_desc->desc->status == ACTIVE || vertex_desc->desc->status == PREPARED || !IsKeyExist(vertex_desc))
+    {
+        return false;
+    }
+
+    std::vector<Key> edges;
+    uint64_t newest = 0;
+
+    //Every timestamp of the edges is drawn by now, snapshots from newest on see the edges as collected
+    if (!CollectSettled(m_list, m_list->m_head, 0, edges, newest) || newest > OldestSnapshot())
+    {
+        return false;
+    }
+
+    uint64_t frozen_ts = commit_clock;
+
+    //A node copied by an adoption can be met twice
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    if (edges.size() < std::max(min_edges, 1u) || frozen_ts - newest < min_age)
+    {
+        return false;
+    }
+
+    static __thread std::vector<uint8_t>* varints = NULL;
+    if (varints == NULL)
+    {
+        varints = new std::vector<uint8_t>();
+    }
+
+    uint32_t blocks = ColdEdges::Blocks(edges.size());
+    std::vector<uint32_t> offsets(blocks);
+    varints->clear();
+
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        uint64_t value = edges[i];
+
+        if (i % cold_block == 0)
+        {
+            offsets[i / cold_block] = varints->size();
+        }
+        else
+        {
+            value -= edges[i - 1];
+        }
+
+        while (value >= 0x80)
+        {
+            varints->push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+
+        varints->push_back((uint8_t)value);
+    }
+
+    uint32_t bytes = sizeof(uint32_t) * blocks + varints->size();
+    ColdEdges* cold = cold_allocator->get_new(ColdEdges::Units(bytes));
+    cold->commit_ts = newest;
+    cold->generation = gate / TIER_GENERATION;
+    cold->detached = m_list;
+    cold->thawed = NULL;
+    cold->count = edges.size();
+    cold->bytes = bytes;
+    memcpy(cold->data, offsets.data(), sizeof(uint32_t) * blocks);
+    memcpy(cold->data + sizeof(uint32_t) * blocks, varints->data(), varints->size());
+
+    //A snapshot that registers from here on reads a clock at least as new as the edges
+    if (newest > OldestSnapshot())
+    {
+        return false;
+    }
+
+    return __sync_bool_compare_and_swap(&node->tier, gate, (uint64_t)cold);
+}
+
+template<typename Key>
+bool BasicAdjacencyList<Key>::FreezeEdges(Key vertex)
+{
+    Node* pred = NULL;
+    Node* current = head;
+
+    LocateVertex(pred, current, vertex);
+
+    return IsNodeExist(current, vertex) && Freeze(current, 0, 1);
+}
+
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::FreezeColdEdges(uint64_t min_age, uint32_t min_edges)
+{
+    uint64_t frozen = 0;
+    Node* current = NULL;
+    uint32_t key = 0;
+
+    //Nodes are never freed, the walk needs no snapshot, which would keep every freeze from completing
+    while (true)
+    {
+        if (vertex_table != NULL)
+        {
+            while (key < dense_range && vertex_table[key] == NULL)
+            {
+                key++;
+            }
+
+            if (key == dense_range)
+            {
+                break;
+            }
+
+            current = vertex_table[key++];
+        }
+        else
+        {
+            current = CLR_MARK(current == NULL ? head->next : current->next);
+
+            if (current == tail)
+            {
+                break;
+            }
+        }
+
+        frozen += Freeze(current, min_age, min_edges);
+    }
+
+    return frozen;
+}
+
+//A helping function for InsertEdge and DeleteEdge
+//Verifies that a vertex is logically in the list
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::FindVertex(Node*& curr, NodeDesc*& n_desc, Desc *desc, Key key)
+{
+    curr = head;
+    Node *pred = NULL;
+
+    while(true)
+    {
+        LocateVertex(pred, curr, key);
+
+        if(IsNodeExist(curr, key))
+        {
+            NodeDesc* current_desc = curr->node_desc;
+
+            if(IS_MARKED(current_desc))
+            {
+                //Node descriptor is marked for deletion
+                return false;
+            }
+
+            FinishPendingTxn(current_desc, desc);
+
+            if(IsKeyExist(current_desc))
+            {
+                //Vertex is logically within the list
+                return true;
+            }
+            else
+            {
+                //Vertex is physically in the list, but logically deleted
+                return false;
+            }
+        }
+        else 
+        {
+            //Vertex is not physically in the list
+            return false;
+        }
+    }
+}
+
+template<typename Key>
+inline ReturnCode BasicAdjacencyList<Key>::InsertEdge(Key vertex, Key edge, Desc* desc, uint32_t opid, MDNode*& inserted, MDNode*& md_pred, Node*& current, uint32_t& dim, uint32_t& pred_dim)
+{
+    inserted = NULL;
+    md_pred = NULL;
+
+    NodeDesc* n_desc = new(ndesc_allocator->get_new()) NodeDesc(desc, opid);
+    MDNode *new_node = NULL;
+    MDList* mdlist;
+
+    MDNode* md_current;
+    uint8_t m_coord[DIMENSION];
+
+    //Try to find the vertex to which the current key is adjacenct
+    if (FindVertex(current, n_desc, desc, vertex))
+    {
+        while (true)
+        {
+            uint64_t state = current->edge_slots;
+            EdgeSlots* slots = SlotsOf(state);
+            int slot = LocateInlineEdge(slots, edge, true);
+
+            if (slot < 0)
+            {
+                if (state & SLOTS_PROMOTED)
+                {
+                    break;
+                }
+
+                ReclaimSlots(current, state);
+                continue;
+            }
+
+            NodeDesc* current_desc = slots->descs[slot];
+
+            //The block is being reclaimed, the edge goes in its copy
+            if (IS_MARKED(current_desc))
+            {
+                HelpReclaim(current, slots);
+                continue;
+            }
+
+            if (current_desc != NULL)
+            {
+                FinishPendingTxn(current_desc, desc);
+
+                if(IsSameOperation(current_desc, n_desc))
+                {
+                    return SKIP;
+                }
+
+                if(IsKeyExist(current_desc))
+                {
+                    return FAIL;
+                }
+            }
+
+            //The slot is empty or holds a logically deleted edge, update descriptor to complete insert
+            if(desc->status != ACTIVE || !IsVertexLive(current, desc))
+            {
+                return FAIL;
+            }
+
+            n_desc->prev = current_desc;
+            if(__sync_bool_compare_and_swap(&slots->descs[slot], current_desc, n_desc))
+            {
+                return OK;
+            }
+        }
+
+        //A frozen edge is present as of the latest commit, an insert of it fails without a thaw
+        ColdEdges* cold = ColdOf(current);
+        if (cold != NULL && cold->Contains(edge))
+        {
+            return FAIL;
+        }
+
+        EdgeWriter writer(this, current);
+        mdlist = PromoteEdges(current, edge);
+        md_current = mdlist->m_head;
+        mdlist->KeyToCoord(edge, m_coord);
+        while(true)
+        {
+            mdlist->LocatePred(m_coord, md_pred, md_current, dim, pred_dim);
+
+            //Check if the node is physically not within the list, or that it is there, but marked for deletion
+            //If it is marked for deletion, the mdlist will physically remove it during the call to mdlist->Insert
+            if(!IsNodeExist(md_current, edge) || IS_DELINV(md_pred->Child(pred_dim)))
+            {
+                //Check if our transaction has been aborted by another thread
+                if(desc->status != ACTIVE)
+                {
+                    return FAIL;
+                }
+
+                //Update pred descriptor before inserting our new node, as this is the only way for a concurrent DeleteVertex to find our operation
+                //If we do not update the pred descriptor, the new node may be inserted after DeleteVertex has traversed past this node
+                NodeDesc* pred_current_desc = md_pred->node_desc;
+                NodeDesc* pred_desc;
+
+                FinishPendingTxn(CLR_MARKD(pred_current_desc), desc);
+
+                //A pred already claimed by an earlier op of our transaction leads DeleteVertex to us just as well
+                //Overriding it would also override that op, an edge deleted earlier in the transaction would come back as found
+                bool same_op = IsSameOperation(pred_current_desc, n_desc) || CLR_MARKD(pred_current_desc)->desc == desc;
+
+                //If the pred_current_desc isn't the same op as ours, we need to prepare to update it with a special node_desc
+                if(!same_op)
+                {
+                    bool exists = IsKeyExist(CLR_MARKD(pred_current_desc));
+
+                    //Create a special descriptor that maintains the nodes logical status
+                    pred_desc = new(ndesc_allocator->get_new()) NodeDesc(desc, opid);
+
+                    //Node exists, force this operation is display as "find"
+                    if (exists)
+                        pred_desc->override_as_find = true;
+                    else //Node doesn't exist, if we treated the operation as "find" it would add the node back into the list
+                        pred_desc->override_as_delete = true;
+
+                    pred_desc->prev = CLR_MARKD(pred_current_desc);
+                }
+
+                //Update the pred node's descriptor, which provides the necessary synchronization to prevent a conflicting deleteVertex from breaking isolation
+                //There are 3 cases that InsertEdge and DeleteVertex can interleave, all cases begin after InsertEdge suceeds in updating md_pred's node_desc. 
+                //
+                //Case 1: md_pred is unmarked, OR md_pred is marked but not physically removed during the InsertEdge operation
+                //      DeleteVertex will find the descriptor in md_pred and help complete the transaction before proceeding
+                //Case 2: md_pred is physically removed during the InsertEdge 
+                //      DeleteVertex will find an adoption descriptor in md_pred's predecessor. This descriptor will move all children of md_pred to that node.
+                //      If InsertEdge sucessfully added it's new node to md_pred, the DeleteVertex will find it after the adoption process.
+                //      If InsertEdge is too slow to add it's new node, its CAS will fail during the insert process, and it will re-traverse 
+                if(same_op || __sync_bool_compare_and_swap(&md_pred->node_desc, pred_current_desc, pred_desc))
+                {
+                    //A DeleteVertex that found no mdlist has not walked one promoted since
+                    if(!IsVertexLive(current, desc))
+                    {
+                        return FAIL;
+                    }
+
+                    //Size the new node for the position it is inserted at, Insert widens it if a retry moves it up
+                    if(new_node == NULL)
+                    {
+                        new_node = mdlist->NewNode(edge, n_desc, pred_dim);
+                    }
+
+                    //A new node starts its own version chain, an earlier attempt may have chained the descriptor to another node
+                    n_desc->prev = NULL;
+
+                    //Do Insert
+                    bool result = mdlist->Insert(new_node, md_pred, md_current, dim, pred_dim);
+
+                    if(result)
+                    {
+                        inserted = new_node;
+                        return OK;
+                    }
+                }
+
+                //If we don't suceed, retry traversal from wherever md_current is currently pointing
+                NoteContention(current);
+            }
+            else 
+            {
+                NodeDesc* current_desc = md_current->node_desc;
+
+                //Node needs to be deleted
+                if(IS_MARKED(current_desc))
+                {
+                    //Mark the MDList node for deletion and retry
+                    //The physical deletion will occur during a call to mdlist->Insert (mdlist only performs physical deletion during insert operations)
+                    if(!IS_DELINV(md_pred->Child(pred_dim)))
+                    {
+                        MDRef current_ref = mdlist->Ref(md_current);
+                        __sync_bool_compare_and_swap(md_pred->Slot(pred_dim), current_ref, SET_DELINV(current_ref));
+                    }
+                    md_current = mdlist->m_head;
+                    dim = 0;
+                    pred_dim = 0;
+                    continue;
+                }
+
+                FinishPendingTxn(current_desc, desc);
+
+                if(IsSameOperation(current_desc, n_desc))
+                {
+                    return SKIP;
+                }
+
+                //Node exists but is logically deleted, update descriptor to complete insert
+                if(!IsKeyExist(current_desc))
+                {
+                    if(desc->status != ACTIVE)
+                    {
+                        return FAIL;
+                    }
+
+                    //A node that was deleted and replaced after it was located is no longer reachable, an insert into it would be lost
+                    //Its descriptor is read before this check, so the CAS fails if the node is deleted from here on
+                    if(md_pred->Child(pred_dim) != mdlist->Ref(md_current))
+                    {
+                        md_current = mdlist->m_head;
+                        dim = 0;
+                        pred_dim = 0;
+                        continue;
+                    }
+
+                    n_desc->prev = current_desc;
+                    if(__sync_bool_compare_and_swap(&md_current->node_desc, current_desc, n_desc))
+                    {
+                        return OK; 
+                    }
+
+                    NoteContention(current);
+                }
+                else
+                {
+                    return FAIL;
+                }
+            }
+        }
+    }
+    else
+    {
+        return FAIL;
+    }
+}
+
+template<typename Key>
+inline ReturnCode BasicAdjacencyList<Key>::DeleteEdge(Key vertex, Key edge, Desc* desc, uint32_t opid, MDNode*& deleted, MDNode*& md_pred, Node*& current, uint32_t& dim, uint32_t& pred_dim)
+{
+    deleted = NULL;
+    md_pred = NULL;
+    current = head;
+
+    NodeDesc *n_desc = new(ndesc_allocator->get_new()) NodeDesc(desc, opid);
+
+    MDList* mdlist;
+    MDNode *md_current;
+    uint8_t m_coord[DIMENSION];
+
+    //Try to find the vertex to which the current key is adjacenct
+    if (FindVertex(current, n_desc, desc, vertex))
+    {
+        while (true)
+        {
+            EdgeSlots* slots = SlotsOf(current->edge_slots);
+            int slot = LocateInlineEdge(slots, edge, false);
+
+            if (slot < 0)
+            {
+                break;
+            }
+
+            NodeDesc* current_desc = slots->descs[slot];
+
+            if (IS_MARKED(current_desc))
+            {
+                HelpReclaim(current, slots);
+                continue;
+            }
+
+            //Slot was claimed, but the edge was never inserted
+            if (current_desc == NULL)
+            {
+                return FAIL;
+            }
+
+            FinishPendingTxn(current_desc, desc);
+
+            if(IsSameOperation(current_desc, n_desc))
+            {
+                return SKIP;
+            }
+
+            if(!IsKeyExist(current_desc))
+            {
+                return FAIL;
+            }
+
+            if(desc->status != ACTIVE)
+            {
+                return FAIL;
+            }
+
+            //Inline edges are only deleted logically, the slot stays with its key until the block is reclaimed
+            n_desc->prev = current_desc;
+            if(__sync_bool_compare_and_swap(&slots->descs[slot], current_desc, n_desc))
+            {
+                return OK;
+            }
+        }
+
+        //An edge missing from the frozen ones is absent as of the latest commit
+        ColdEdges* cold = ColdOf(current);
+        if (cold != NULL && !cold->Contains(edge))
+        {
+            return FAIL;
+        }
+
+        EdgeWriter writer(this, current);
+        mdlist = EdgeList(current, edge);
+
+        if (mdlist == NULL)
+        {
+            return FAIL;
+        }
+
+        md_current = mdlist->m_head;
+        mdlist->KeyToCoord(edge, m_coord);
+        while(true)
+        {
+            mdlist->LocatePred(m_coord, md_pred, md_current, dim, pred_dim);
+
+            if(IsNodeExist(md_current, edge))
+            {
+                NodeDesc* current_desc = md_current->node_desc;
+
+                if(IS_MARKED(current_desc))
+                {
+                    return FAIL;
+                }
+
+                FinishPendingTxn(current_desc, desc);
+
+                if(IsSameOperation(current_desc, n_desc))
+                {
+                    return SKIP;
+                }
+
+                if(IsKeyExist(current_desc))
+                {
+                    if(desc->status != ACTIVE)
+                    {
+                        return FAIL;
+                    }
+
+                    n_desc->prev = current_desc;
+                    if(__sync_bool_compare_and_swap(&md_current->node_desc, current_desc, n_desc))
+                    {
+                        deleted = md_current;
+                        return OK; 
+                    }
+
+                    NoteContention(current);
+                }
+                else
+                {
+                    return FAIL;
+                }  
+            }
+            else 
+            {
+                return FAIL;      
+            }
+        }
+    }
+    else
+    {
+        return FAIL;
+    }
+}
+
+//Resolves the node of a vertex, in dense mode this is a single table lookup and pred is unused
+template<typename Key>
+inline void BasicAdjacencyList<Key>::LocateVertex(Node*& pred, Node*& current, Key key)
+{
+    if(vertex_table != NULL)
+    {
+        pred = NULL;
+        current = key < dense_range ? vertex_table[key] : NULL;
+        return;
+    }
+
+    //Resume from the previous search when the ops are ordered, unless the finger has been deleted since
+    if(ordered_ops && current == head && finger_list == this && finger->key < key && !IS_MARKED(finger->next))
+    {
+        current = finger;
+    }
+
+    Node* start = current;
+
+    LocatePred(pred, current, key);
+
+    if(ordered_ops && start->key < key)
+    {
+        finger = pred;
+        finger_list = this;
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::LocatePred(Node*& pred, Node*& current, Key key)
+{
+    Node* pred_next;
+
+    //The head carries key 0, which is a valid vertex key too, so a search always moves past it
+    while(current == head || current->key < key)
+    {
+        pred = current;
+        pred_next = CLR_MARK(pred->next);
+        current = pred_next;
+
+        while(IS_MARKED(current->next))
+        {
+            current = CLR_MARK(current->next);
+        }
+
+        if(current != pred_next)
+        {
+            //Failed to remove deleted nodes, start over from pred
+            if(!__sync_bool_compare_and_swap(&pred->next, pred_next, current))
+            {
+                current = head;
+            }
+        }
+    }
+}
+
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::BeginSnapshot()
+{
+    //Register before reading the clock, a commit that misses the registration then has a timestamp within the snapshot
+    __sync_fetch_and_add(&active_snapshots, 1);
+
+    //The announced value is at most the snapshot, which is read after it, see OldestSnapshot
+    uint64_t announced = commit_clock + 1;
+    uint32_t slot = 0;
+
+    while(!__sync_bool_compare_and_swap(&snapshot_ts[slot], 0, announced))
+    {
+        if(++slot == snapshot_slots)
+        {
+            //More snapshots are open than the threads may hold, one has to close first
+            std::this_thread::yield();
+            slot = 0;
+        }
+    }
+
+    if(open_snapshots == NULL)
+    {
+        open_snapshots = new std::vector<std::pair<BasicAdjacencyList*, uint32_t>>();
+    }
+
+    open_snapshots->push_back(std::make_pair(this, slot));
+
+    return __sync_fetch_and_add(&commit_clock, 0);
+}
+
+//Closes the snapshot the thread opened last on the list
+template<typename Key>
+void BasicAdjacencyList<Key>::EndSnapshot()
+{
+    std::vector<std::pair<BasicAdjacencyList*, uint32_t>>& open = *open_snapshots;
+    size_t i = open.size() - 1;
+
+    while(open[i].first != this)
+    {
+        i--;
+    }
+
+    uint64_t announced = __sync_fetch_and_and(&snapshot_ts[open[i].second], 0);
+    open.erase(open.begin() + i);
+    __sync_sub_and_fetch(&active_snapshots, 1);
+
+    //Removals only become due when the oldest snapshot closes
+    if(retired != NULL && announced - 1 <= OldestSnapshot())
+    {
+        DrainRetired();
+    }
+}
+
+//Returns True if the key exists in the version of the chain visible at the snapshot
+//Versions of active, aborted or later transactions are skipped, as are finds, property updates and InsertEdge's pred overrides which leave the key as it was
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsKeyVisible(NodeDesc* nodeDesc, uint64_t snapshot)
+{
+    while(nodeDesc != NULL)
+    {
+        Desc* desc = nodeDesc->desc;
+
+        if(desc->status == COMMITTED && IsCommittedBy(desc, snapshot) && !nodeDesc->override_as_find && !nodeDesc->override_as_delete)
+        {
+            uint8_t opType = desc->ops[nodeDesc->opid].type;
+
+            if(opType != FIND && opType != SET_PROPERTY)
+            {
+                return opType == INSERT || opType == INSERT_EDGE;
+            }
+        }
+
+        nodeDesc = nodeDesc->prev;
+    }
+
+    return false;
+}
+
+//Whether a committed transaction is ordered at or before the snapshot, a plain read once its timestamp is drawn
+//Without an announced draw any timestamp it gets is drawn after the snapshot was taken, so it is not. Only a draw
+//announced before may end at or before the snapshot, the reader then finishes it, so all readers of the snapshot agree
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::IsCommittedBy(Desc* desc, uint64_t snapshot)
+{
+    uint64_t ts = desc->commit_ts;
+
+    if(ts == 0)
+    {
+        return false;
+    }
+
+    if(ts == COMMIT_TS_DRAWING)
+    {
+        ts = CommitTs(desc);
+    }
+
+    return ts <= snapshot;
+}
+
+template<typename Key>
+inline typename BasicAdjacencyList<Key>::Node* BasicAdjacencyList<Key>::SnapshotLocateVertex(uint64_t snapshot, Key key)
+{
+    if(vertex_table != NULL)
+    {
+        Node* current = key < dense_range ? vertex_table[key] : NULL;
+
+        return current != NULL && IsKeyVisible(CLR_MARKD(current->node_desc), snapshot) ? current : NULL;
+    }
+
+    Node* current = CLR_MARK(head->next);
+
+    while(current->key < key)
+    {
+        current = CLR_MARK(current->next);
+    }
+
+    //A node deleted before the snapshot may still be linked ahead of the node that replaced it
+    for(; current != tail && current->key == key; current = CLR_MARK(current->next))
+    {
+        if(IsKeyVisible(CLR_MARKD(current->node_desc), snapshot))
+        {
+            return current;
+        }
+    }
+
+    return NULL;
+}
+
+template<typename Key>
+bool BasicAdjacencyList<Key>::SnapshotFindVertex(uint64_t snapshot, Key vertex)
+{
+    return SnapshotLocateVertex(snapshot, vertex) != NULL;
+}
+
+//Property the vertex has after nodeDesc, which is settled or belongs to desc, the one of the newest version that did not abort
+//Every vertex descriptor carries its own, so at most the aborted versions on top are walked
+template<typename Key>
+inline const Property* BasicAdjacencyList<Key>::CurrentProperty(NodeDesc* nodeDesc, Desc* desc)
+{
+    while(nodeDesc != NULL && nodeDesc->desc != desc && nodeDesc->desc->status == ABORTED)
+    {
+        nodeDesc = nodeDesc->prev;
+    }
+
+    return nodeDesc != NULL ? nodeDesc->property : NULL;
+}
+
+template<typename Key>
+const Property* BasicAdjacencyList<Key>::NewProperty(const void* data, uint32_t size)
+{
+    Property* property = property_allocator->get_new(Property::Units(size));
+    property->size = size;
+    memcpy(property->data, data, size);
+
+    return property;
+}
+
+template<typename Key>
+const Property* BasicAdjacencyList<Key>::SnapshotProperty(uint64_t snapshot, Key vertex)
+{
+    Node* current;
+
+    if(vertex_table != NULL)
+    {
+        current = vertex < dense_range ? vertex_table[vertex] : NULL;
+    }
+    else
+    {
+        current = CLR_MARK(head->next);
+
+        while(current->key < vertex)
+        {
+            current = CLR_MARK(current->next);
+        }
+    }
+
+    //The newest version in the snapshot has the property, a deleted vertex has none
+    //So unlike SnapshotLocateVertex no older version is walked to for the op that decides whether the vertex is there
+    for(; current != NULL && current != tail && current->key == vertex; current = vertex_table != NULL ? NULL : CLR_MARK(current->next))
+    {
+        for(NodeDesc* nodeDesc = CLR_MARKD(current->node_desc); nodeDesc != NULL; nodeDesc = nodeDesc->prev)
+        {
+            Desc* desc = nodeDesc->desc;
+
+            if(desc->status == COMMITTED && IsCommittedBy(desc, snapshot))
+            {
+                if(nodeDesc->property != NULL)
+                {
+                    return nodeDesc->property;
+                }
+
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+template<typename Key>
+bool BasicAdjacencyList<Key>::SnapshotFindEdge(uint64_t snapshot, Key vertex, Key edge)
+{
+    Node* current = SnapshotLocateVertex(snapshot, vertex);
+
+    if(current == NULL)
+    {
+        return false;
+    }
+
+    //A block being reclaimed still holds every version of its edges
+    EdgeSlots* slots = SlotsOf(current->edge_slots);
+    int slot = LocateInlineEdge(slots, edge, false);
+
+    if(slot >= 0)
+    {
+        return IsKeyVisible(CLR_MARKD(slots->descs[slot]), snapshot);
+    }
+
+    //No snapshot older than the edges of a frozen array is open, the array holds the edges every open snapshot sees
+    ColdEdges* cold = ColdOf(current);
+
+    if(cold != NULL)
+    {
+        return cold->Contains(edge);
+    }
+
+    MDList* mdlist = EdgeList(current, edge);
+
+    if(mdlist == NULL)
+    {
+        return false;
+    }
+
+    uint8_t m_coord[DIMENSION];
+    MDNode* md_pred = NULL;
+    MDNode* md_current = mdlist->m_head;
+    uint32_t dim = 0;
+    uint32_t pred_dim = 0;
+
+    mdlist->KeyToCoord(edge, m_coord);
+    mdlist->LocatePred(m_coord, md_pred, md_current, dim, pred_dim);
+
+    return dim == DIMENSION && IsKeyVisible(CLR_MARKD(md_current->node_desc), snapshot);
+}
+
+//Pre-order traversal with the dimensions in descending order visits the keys in ascending order
+template<typename Key>
+inline void BasicAdjacencyList<Key>::SnapshotCollect(MDList* m_list, MDNode* n, int dim, uint64_t snapshot, std::vector<Key>& edges)
+{
+    if(n != m_list->m_head && IsKeyVisible(CLR_MARKD(n->node_desc), snapshot))
+    {
+        edges.push_back(n->m_key);
+    }
+
+    //Children being adopted are only complete in the adopting node once the adoption finishes
+    MDDesc* pending = n->m_pending;
+    if(pending)
+    {
+        m_list->FinishInserting(n, pending);
+    }
+
+    for(int i = DIMENSION - 1; i >= dim; --i)
+    {
+        MDNode* child = m_list->Deref(n->Child(i));
+
+        if(child != NULL)
+        {
+            SnapshotCollect(m_list, child, i, snapshot, edges);
+        }
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::SnapshotEdges(Node* node, uint64_t snapshot, std::vector<Key>& edges)
+{
+    edges.clear();
+
+    EdgeSlots* slots = SlotsOf(node->edge_slots);
+
+    for(uint32_t i = 0; i < inline_edges && slots->keys[i] != 0; i++)
+    {
+        if(IsKeyVisible(CLR_MARKD(slots->descs[i]), snapshot))
+        {
+            edges.push_back(slots->keys[i]);
+        }
+    }
+
+    if(IsKeyVisible(CLR_MARKD(slots->descs[ZERO_SLOT]), snapshot))
+    {
+        edges.push_back(0);
+    }
+
+    ColdEdges* cold = ColdOf(node);
+    SplitEdges* split = node->m_split;
+    MDList* mdlist = node->m_list;
+
+    if(cold != NULL)
+    {
+        cold->Decode(0, [&](Key edge)
+        {
+            edges.push_back(edge);
+            return true;
+        });
+    }
+    else if(split != NULL)
+    {
+        for(uint32_t i = 0; i < split_ways; i++)
+        {
+            SnapshotCollect(split->parts[i], split->parts[i]->m_head, 0, snapshot, edges);
+        }
+    }
+    else if(mdlist != NULL)
+    {
+        SnapshotCollect(mdlist, mdlist->m_head, 0, snapshot, edges);
+    }
+
+    //Inline edges are kept in insertion order, parts are merged and a node copied by an adoption can be met twice
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+}
+
+template<typename Key>
+bool BasicAdjacencyList<Key>::SnapshotNeighbors(uint64_t snapshot, Key vertex, std::vector<Key>& edges)
+{
+    Node* current = SnapshotLocateVertex(snapshot, vertex);
+
+    if(current == NULL)
+    {
+        edges.clear();
+        return false;
+    }
+
+    SnapshotEdges(current, snapshot, edges);
+
+    return true;
+}
+
+template<typename Key>
+void BasicAdjacencyList<Key>::SnapshotVertices(uint64_t snapshot, std::vector<Key>& vertices)
+{
+    vertices.clear();
+
+    if(vertex_table != NULL)
+    {
+        for(uint32_t key = 0; key < dense_range; key++)
+        {
+            Node* current = vertex_table[key];
+
+            if(current != NULL && IsKeyVisible(CLR_MARKD(current->node_desc), snapshot))
+            {
+                vertices.push_back(key);
+            }
+        }
+
+        return;
+    }
+
+    for(Node* current = CLR_MARK(head->next); current != tail; current = CLR_MARK(current->next))
+    {
+        //A key is reported once even if a replaced node is still linked
+        if(IsKeyVisible(CLR_MARKD(current->node_desc), snapshot) && (vertices.empty() || vertices.back() != current->key))
+        {
+            vertices.push_back(current->key);
+        }
+    }
+}
+
+//The boundaries are sampled from one walk, every stride-th new key is kept and the stride doubles whenever the samples fill up
+//Nodes stay linked while the snapshot is open, so a range walked from its start node sees every vertex of the snapshot in it
+template<typename Key>
+void BasicAdjacencyList<Key>::SnapshotPartition(uint64_t snapshot, Key first, Key last, uint32_t count, std::vector<ScanRange>& ranges)
+{
+    ranges.clear();
+
+    if(count == 0 || first > last)
+    {
+        return;
+    }
+
+    if(vertex_table != NULL)
+    {
+        if(first >= dense_range)
+        {
+            return;
+        }
+
+        uint64_t end = std::min<uint64_t>((uint64_t)last + 1, dense_range);
+        uint64_t span = end - first;
+        uint64_t parts = std::min<uint64_t>(count, span);
+
+        for(uint64_t i = 0; i < parts; i++)
+        {
+            ScanRange range = {(Key)(first + span * i / parts), (Key)(first + span * (i + 1) / parts - 1), NULL};
+            ranges.push_back(range);
+        }
+
+        return;
+    }
+
+    std::vector<std::pair<Key, Node*>> samples;
+    size_t capacity = 4 * (size_t)count;
+    uint64_t stride = 1;
+    uint64_t seen = 0;
+
+    Node* current = CLR_MARK(head->next);
+
+    while(current != tail && current->key < first)
+    {
+        current = CLR_MARK(current->next);
+    }
+
+    for(; current != tail && current->key <= last; current = CLR_MARK(current->next))
+    {
+        //A range starts at the first node of its key, a replaced node may still be linked ahead of the current one
+        if(!samples.empty() && samples.back().first == current->key)
+        {
+            continue;
+        }
+
+        if(seen++ % stride == 0)
+        {
+            samples.push_back(std::make_pair(current->key, current));
+
+            if(samples.size() == 2 * capacity)
+            {
+                for(size_t i = 0; i < capacity; i++)
+                {
+                    samples[i] = samples[2 * i];
+                }
+
+                samples.resize(capacity);
+                stride *= 2;
+            }
+        }
+    }
+
+    if(samples.empty())
+    {
+        return;
+    }
+
+    //Boundaries that fall on the same sample give no range of their own
+    std::vector<size_t> starts;
+
+    for(uint64_t i = 0; i < count; i++)
+    {
+        size_t index = samples.size() * i / count;
+
+        if(starts.empty() || starts.back() != index)
+        {
+            starts.push_back(index);
+        }
+    }
+
+    for(size_t i = 0; i < starts.size(); i++)
+    {
+        const std::pair<Key, Node*>& start = samples[starts[i]];
+        Key range_last = i + 1 < starts.size() ? samples[starts[i + 1]].first - 1 : last;
+
+        ScanRange range = {i == 0 ? first : start.first, range_last, start.second};
+        ranges.push_back(range);
+    }
+}
+
+template<typename Key>
+template<typename Visitor>
+void BasicAdjacencyList<Key>::SnapshotScan(uint64_t snapshot, const ScanRange& range, Visitor&& visit)
+{
+    static thread_local std::vector<Key> edges;
+
+    if(vertex_table != NULL)
+    {
+        uint64_t end = std::min<uint64_t>((uint64_t)range.last + 1, dense_range);
+
+        for(uint64_t key = range.first; key < end; key++)
+        {
+            //The table is read in order, the nodes it points to are fetched a few entries ahead
+            if(key + scan_prefetch < end && vertex_table[key + scan_prefetch] != NULL)
+            {
+                __builtin_prefetch(vertex_table[key + scan_prefetch]);
+            }
+
+            Node* current = vertex_table[key];
+
+            if(current != NULL && IsKeyVisible(CLR_MARKD(current->node_desc), snapshot))
+            {
+                SnapshotEdges(current, snapshot, edges);
+                visit((Key)key, (const std::vector<Key>&)edges);
+            }
+        }
+
+        return;
+    }
+
+    bool reported = false;
+    Key last_reported = 0;
+
+    for(Node* current = range.start; current != tail && current->key <= range.last; current = CLR_MARK(current->next))
+    {
+        //A key is reported once even if a replaced node is still linked
+        if(current->key >= range.first && (!reported || current->key != last_reported) && IsKeyVisible(CLR_MARKD(current->node_desc), snapshot))
+        {
+            reported = true;
+            last_reported = current->key;
+
+            SnapshotEdges(current, snapshot, edges);
+            visit(current->key, (const std::vector<Key>&)edges);
+        }
+    }
+}
+
+//Both adjacency sets are materialized sorted and intersected with the kernels of intersect.h
+//The buffers are kept per thread, they only grow to the largest degree seen
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::SnapshotCommonNeighbors(uint64_t snapshot, Key u, Key v)
+{
+    static thread_local std::vector<Key> u_edges;
+    static thread_local std::vector<Key> v_edges;
+
+    if(!SnapshotNeighbors(snapshot, u, u_edges) || !SnapshotNeighbors(snapshot, v, v_edges))
+    {
+        return 0;
+    }
+
+    return IntersectCount(u_edges.data(), u_edges.size(), v_edges.data(), v_edges.size());
+}
+
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::SnapshotTriangles(uint64_t snapshot, Key vertex)
+{
+    static thread_local std::vector<Key> edges;
+    static thread_local std::vector<Key> neighbor_edges;
+    uint64_t triangles = 0;
+
+    if(!SnapshotNeighbors(snapshot, vertex, edges))
+    {
+        return 0;
+    }
+
+    edges.erase(std::remove(edges.begin(), edges.end(), vertex), edges.end());
+
+    for(Key neighbor : edges)
+    {
+        //An edge to a key that is not a vertex closes no triangle
+        if(!SnapshotNeighbors(snapshot, neighbor, neighbor_edges))
+        {
+            continue;
+        }
+
+        triangles += IntersectCount(edges.data(), edges.size(), neighbor_edges.data(), neighbor_edges.size());
+
+        //The neighbor's own self loop is in both sets
+        if(std::binary_search(neighbor_edges.begin(), neighbor_edges.end(), neighbor))
+        {
+            triangles--;
+        }
+    }
+
+    return triangles;
+}
+
+//The adjacency sets are kept back to back with self loops removed, offsets[i] is where the set of vertices[i] starts
+template<typename Key>
+void BasicAdjacencyList<Key>::SnapshotAllTriangles(uint64_t snapshot, std::vector<Key>& vertices, std::vector<uint64_t>& triangles)
+{
+    std::vector<Key> edges;
+    std::vector<Key> neighbors;
+    std::vector<size_t> offsets(1, 0);
+
+    SnapshotVertices(snapshot, vertices);
+
+    for(Key vertex : vertices)
+    {
+        SnapshotNeighbors(snapshot, vertex, neighbors);
+
+        for(Key neighbor : neighbors)
+        {
+            if(neighbor != vertex)
+            {
+                edges.push_back(neighbor);
+            }
+        }
+
+        offsets.push_back(edges.size());
+    }
+
+    triangles.assign(vertices.size(), 0);
+
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        const Key* set = edges.data() + offsets[i];
+        size_t size = offsets[i + 1] - offsets[i];
+
+        for(size_t e = 0; e < size; e++)
+        {
+            size_t j = std::lower_bound(vertices.begin(), vertices.end(), set[e]) - vertices.begin();
+
+            if(j < vertices.size() && vertices[j] == set[e])
+            {
+                triangles[i] += IntersectCount(set, size, edges.data() + offsets[j], offsets[j + 1] - offsets[j]);
+            }
+        }
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::BatchStart(BatchSlot& slot, const Probe& probe, size_t index)
+{
+    slot.index = index;
+
+    if(vertex_table != NULL)
+    {
+        if(probe.vertex < dense_range)
+        {
+            __builtin_prefetch(&vertex_table[probe.vertex]);
+        }
+
+        slot.stage = BATCH_TABLE;
+        return;
+    }
+
+    slot.node = CLR_MARK(head->next);
+    __builtin_prefetch(slot.node);
+    slot.stage = BATCH_WALK;
+}
+
+//Runs the search of a probe up to its next cache miss, prefetches the line it misses on and returns
+//Returns true once the probe is resolved, with the result in found
+//The stages follow SnapshotLocateVertex, SnapshotFindEdge and MDList::LocatePred step for step
+template<typename Key>
+inline bool BasicAdjacencyList<Key>::BatchStep(BatchSlot& slot, const Probe& probe, uint64_t snapshot, bool& found)
+{
+    switch(slot.stage)
+    {
+    case BATCH_TABLE:
+        slot.node = probe.vertex < dense_range ? vertex_table[probe.vertex] : NULL;
+
+        if(slot.node == NULL)
+        {
+            found = false;
+            return true;
+        }
+
+        //The first inline edges are on the second line of the node
+        __builtin_prefetch(slot.node);
+        __builtin_prefetch((char*)slot.node + 64);
+        slot.stage = BATCH_WALK;
+        return false;
+
+    case BATCH_WALK:
+        if(slot.node->key < probe.vertex)
+        {
+            slot.node = CLR_MARK(slot.node->next);
+            __builtin_prefetch(slot.node);
+            return false;
+        }
+
+        if(slot.node == tail || slot.node->key != probe.vertex)
+        {
+            found = false;
+            return true;
+        }
+
+        __builtin_prefetch(SlotsOf(slot.node->edge_slots));
+        slot.node_desc = CLR_MARKD(slot.node->node_desc);
+        __builtin_prefetch(slot.node_desc);
+        slot.stage = BATCH_VERTEX_DESC;
+        return false;
+
+    case BATCH_VERTEX_DESC:
+        __builtin_prefetch(slot.node_desc->desc);
+        slot.stage = BATCH_VERTEX_TXN;
+        return false;
+
+    case BATCH_VERTEX_TXN:
+        if(!IsKeyVisible(slot.node_desc, snapshot))
+        {
+            if(vertex_table != NULL)
+            {
+                found = false;
+                return true;
+            }
+
+            //A node deleted before the snapshot may still be linked ahead of the node that replaced it
+            slot.node = CLR_MARK(slot.node->next);
+            __builtin_prefetch(slot.node);
+            slot.stage = BATCH_WALK;
+            return false;
+        }
+
+        if(!probe.find_edge)
+        {
+            found = true;
+            return true;
+        }
+
+        {
+            EdgeSlots* slots = SlotsOf(slot.node->edge_slots);
+            int inline_slot = LocateInlineEdge(slots, probe.edge, false);
+
+            if(inline_slot >= 0)
+            {
+                slot.node_desc = CLR_MARKD(slots->descs[inline_slot]);
+
+                if(slot.node_desc == NULL)
+                {
+                    found = false;
+                    return true;
+                }
+
+                __builtin_prefetch(slot.node_desc);
+                slot.stage = BATCH_EDGE_DESC;
+                return false;
+            }
+        }
+
+        if(ColdEdges* cold = ColdOf(slot.node))
+        {
+            found = cold->Contains(probe.edge);
+            return true;
+        }
+
+        slot.m_list = EdgeList(slot.node, probe.edge);
+
+        if(slot.m_list == NULL)
+        {
+            found = false;
+            return true;
+        }
+
+        __builtin_prefetch(slot.m_list);
+        slot.stage = BATCH_MDLIST;
+        return false;
+
+    case BATCH_MDLIST:
+        slot.md_current = slot.m_list->m_head;
+        slot.dim = 0;
+        __builtin_prefetch(slot.md_current);
+        __builtin_prefetch((char*)slot.md_current + 64);
+        slot.stage = BATCH_MDWALK;
+        return false;
+
+    case BATCH_MDWALK:
+        {
+            MDList* m_list = slot.m_list;
+            MDNode* curr = slot.md_current;
+            uint32_t dim = slot.dim;
+
+            while(dim < DIMENSION)
+            {
+                uint32_t coord = MDNode::Coord(probe.edge, dim);
+
+                if(curr != NULL && coord > MDNode::Coord(curr->m_key, dim))
+                {
+                    MDDesc* pending = curr->m_pending;
+                    if(pending && dim >= pending->pred_dim && dim <= pending->dim)
+                    {
+                        m_list->FinishInserting(curr, pending);
+                    }
+
+                    curr = m_list->Deref(curr->Child(dim));
+
+                    if(curr != NULL)
+                    {
+                        __builtin_prefetch(curr);
+                        __builtin_prefetch((char*)curr + 64);
+                        slot.md_current = curr;
+                        slot.dim = dim;
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                if(curr == NULL || coord < MDNode::Coord(curr->m_key, dim))
+                {
+                    break;
+                }
+
+                dim++;
+            }
+
+            if(dim < DIMENSION)
+            {
+                found = false;
+                return true;
+            }
+
+            slot.node_desc = CLR_MARKD(curr->node_desc);
+            __builtin_prefetch(slot.node_desc);
+            slot.stage = BATCH_EDGE_DESC;
+            return false;
+        }
+
+    case BATCH_EDGE_DESC:
+        __builtin_prefetch(slot.node_desc->desc);
+        slot.stage = BATCH_EDGE_TXN;
+        return false;
+
+    default:
+        found = IsKeyVisible(slot.node_desc, snapshot);
+        return true;
+    }
+}
+
+template<typename Key>
+void BasicAdjacencyList<Key>::SnapshotFindBatch(uint64_t snapshot, const Probe* probes, size_t count, bool* found)
+{
+    BatchSlot slots[batch_interleave];
+    size_t next = 0;
+    int active = 0;
+
+    while(active < (int)batch_interleave && next < count)
+    {
+        BatchStart(slots[active++], probes[next], next);
+        next++;
+    }
+
+    //Round robin over the probes in flight, a resolved probe hands its slot to the next one
+    while(active > 0)
+    {
+        for(int i = 0; i < active; i++)
+        {
+            BatchSlot& slot = slots[i];
+
+            if(BatchStep(slot, probes[slot.index], snapshot, found[slot.index]))
+            {
+                if(next < count)
+                {
+                    BatchStart(slot, probes[next], next);
+                    next++;
+                }
+                else
+                {
+                    slot = slots[--active];
+                    i--;
+                }
+            }
+        }
+    }
+}
+
+template<typename Key>
+template<typename T>
+void BasicAdjacencyList<Key>::AddAllocatorStats(const char* name, PreAllocator<T>* allocator, std::vector<AllocatorStats>& stats)
+{
+    AllocatorStats entry;
+    entry.name = name;
+    entry.reserved = allocator->reserved();
+    entry.handed_out = 0;
+
+    for(uint64_t i = 0; i < allocator->threads(); i++)
+    {
+        entry.thread_handed_out.push_back(allocator->thread_used(i));
+        entry.handed_out += entry.thread_handed_out.back();
+    }
+
+    stats.push_back(entry);
+}
+
+template<typename Key>
+uint64_t BasicAdjacencyList<Key>::Room()
+{
+    uint64_t room = std::min(node_allocator->room(), ndesc_allocator->room());
+    room = std::min(room, desc_allocator->room() / Desc::Units(1));
+    room = std::min(room, mdlist_allocator->room());
+    room = std::min(room, mdnode_allocator->room() / MDNode::Units(0));
+    room = std::min(room, mddesc_allocator->room());
+
+    return std::min(room, slots_allocator->room());
+}
+
+template<typename Key>
+void BasicAdjacencyList<Key>::MemoryUsage(std::vector<AllocatorStats>& stats)
+{
+    stats.clear();
+
+    AddAllocatorStats("Node", node_allocator, stats);
+    AddAllocatorStats("Desc", desc_allocator, stats);
+    AddAllocatorStats("NodeDesc", ndesc_allocator, stats);
+    AddAllocatorStats("MDList", mdlist_allocator, stats);
+    AddAllocatorStats("MDNode", mdnode_allocator, stats);
+    AddAllocatorStats("MDDesc", mddesc_allocator, stats);
+    AddAllocatorStats("Property", property_allocator, stats);
+    AddAllocatorStats("ColdEdges", cold_allocator, stats);
+    AddAllocatorStats("SplitEdges", split_allocator, stats);
+    AddAllocatorStats("EdgeSlots", slots_allocator, stats);
+
+    if(vertex_table != NULL)
+    {
+        AllocatorStats table = {"VertexTable", dense_range * sizeof(Node*), dense_range * sizeof(Node*), std::vector<uint64_t>()};
+        stats.push_back(table);
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::SampleDesc(NodeDesc* nodeDesc, LivenessStats& stats)
+{
+    if(nodeDesc == NULL)
+    {
+        return;
+    }
+
+    stats.node_descs++;
+
+    for(NodeDesc* prev = nodeDesc->prev; prev != NULL; prev = prev->prev)
+    {
+        stats.chained_versions++;
+    }
+}
+
+//Same traversal as SnapshotCollect, every node is counted whether or not it is visible
+template<typename Key>
+inline void BasicAdjacencyList<Key>::SampleEdges(MDList* m_list, MDNode* n, int dim, uint64_t snapshot, bool vertex_live, LivenessStats& stats)
+{
+    NodeDesc* node_desc = n->node_desc;
+
+    if(n != m_list->m_head)
+    {
+        stats.md_nodes++;
+
+        if(IS_MARKED(node_desc))
+        {
+            stats.marked_md_nodes++;
+        }
+
+        //The edges of a deleted vertex are dead whatever their own state
+        if(vertex_live && !IS_MARKED(node_desc) && IsKeyVisible(node_desc, snapshot))
+        {
+            stats.live_edges++;
+        }
+        else
+        {
+            stats.dead_edges++;
+        }
+    }
+
+    SampleDesc(CLR_MARKD(node_desc), stats);
+
+    MDDesc* pending = n->m_pending;
+    if(pending)
+    {
+        stats.pending_adoptions++;
+        m_list->FinishInserting(n, pending);
+    }
+
+    for(int i = DIMENSION - 1; i >= dim; --i)
+    {
+        MDNode* child = m_list->Deref(n->Child(i));
+
+        if(child != NULL)
+        {
+            SampleEdges(m_list, child, i, snapshot, vertex_live, stats);
+        }
+    }
+}
+
+template<typename Key>
+inline void BasicAdjacencyList<Key>::SampleNode(Node* node, uint64_t snapshot, LivenessStats& stats)
+{
+    bool vertex_live = IsKeyVisible(CLR_MARKD(node->node_desc), snapshot);
+
+    EdgeSlots* slots = SlotsOf(node->edge_slots);
+
+    //A claimed slot without a descriptor holds an edge that never committed
+    for(uint32_t i = 0; i < inline_edges && slots->keys[i] != 0; i++)
+    {
+        NodeDesc* edge_desc = CLR_MARKD(slots->descs[i]);
+
+        if(vertex_live && edge_desc != NULL && IsKeyVisible(edge_desc, snapshot))
+        {
+            stats.live_edges++;
+        }
+        else
+        {
+            stats.dead_edges++;
+        }
+
+        SampleDesc(edge_desc, stats);
+    }
+
+    NodeDesc* zero_desc = CLR_MARKD(slots->descs[ZERO_SLOT]);
+
+    if(zero_desc != NULL)
+    {
+        if(vertex_live && IsKeyVisible(zero_desc, snapshot))
+        {
+            stats.live_edges++;
+        }
+        else
+        {
+            stats.dead_edges++;
+        }
+
+        SampleDesc(zero_desc, stats);
+    }
+
+    //The mdlist a frozen array or the parts of a split were made from is no longer reachable
+    ColdEdges* cold = ColdOf(node);
+    SplitEdges* split = node->m_split;
+    MDList* m_list = node->m_list;
+
+    if(cold != NULL)
+    {
+        if(vertex_live)
+        {
+            stats.live_edges += cold->count;
+        }
+        else
+        {
+            stats.dead_edges += cold->count;
+        }
+    }
+    else if(split != NULL)
+    {
+        for(uint32_t i = 0; i < split_ways; i++)
+        {
+            MDList* part = split->parts[i];
+            SampleEdges(part, part->m_head, 0, snapshot, vertex_live, stats);
+        }
+    }
+    else if(m_list != NULL)
+    {
+        SampleEdges(m_list, m_list->m_head, 0, snapshot, vertex_live, stats);
+    }
+}
+
+template<typename Key>
+void BasicAdjacencyList<Key>::SampleLiveness(uint32_t sample_every, LivenessStats& stats)
+{
+    memset(&stats, 0, sizeof(stats));
+    sample_every = std::max(sample_every, 1u);
+
+    //Edge side counts of the sampled vertex nodes, scaled up at the end
+    LivenessStats sample;
+    memset(&sample, 0, sizeof(sample));
+
+    //A snapshot gives one point in time to judge liveness by and keeps deleted nodes linked while we walk
+    uint64_t snapshot = BeginSnapshot();
+
+    Node* current = NULL;
+    uint32_t key = 0;
+
+    while(true)
+    {
+        if(vertex_table != NULL)
+        {
+            while(key < dense_range && vertex_table[key] == NULL)
+            {
+                key++;
+            }
+
+            if(key == dense_range)
+            {
+                break;
+            }
+
+            current = vertex_table[key++];
+        }
+        else
+        {
+            current = CLR_MARK(current == NULL ? head->next : current->next);
+
+            if(current == tail)
+            {
+                break;
+            }
+        }
+
+        if(IsKeyVisible(CLR_MARKD(current->node_desc), snapshot))
+        {
+            stats.live_vertices++;
+        }
+        else
+        {
+            stats.dead_vertices++;
+        }
+
+        SampleDesc(CLR_MARKD(current->node_desc), stats);
+
+        ColdEdges* cold = ColdOf(current);
+
+        if(cold != NULL)
+        {
+            stats.cold_vertices++;
+            stats.cold_edges += cold->count;
+            stats.cold_bytes += ColdEdges::Units(cold->bytes) * sizeof(uint64_t);
+        }
+
+        stats.split_vertices += current->m_split != NULL;
+
+        if(stats.vertex_nodes++ % sample_every == 0)
+        {
+            stats.sampled_vertex_nodes++;
+            SampleNode(current, snapshot, sample);
+        }
+    }
+
+    EndSnapshot();
+
+    double scale = stats.sampled_vertex_nodes > 0 ? (double)stats.vertex_nodes / stats.sampled_vertex_nodes : 0;
+
+    stats.live_edges = sample.live_edges * scale;
+    stats.dead_edges = sample.dead_edges * scale;
+    stats.md_nodes = sample.md_nodes * scale;
+    stats.marked_md_nodes = sample.marked_md_nodes * scale;
+    stats.pending_adoptions = sample.pending_adoptions * scale;
+    stats.node_descs += sample.node_descs * scale;
+    stats.chained_versions += sample.chained_versions * scale;
+}
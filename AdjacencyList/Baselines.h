@@ -0,0 +1,145 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include "lftt.h"
+
+//Blocking and optimistic graphs to measure the list against, behind its transaction interface: Init, AllocateDesc and ExecuteOps
+//An op means what it means in the list and fails where the list's op fails, a transaction commits if all of its ops
+//succeed and otherwise leaves no trace. Unlike in the list, an op sees the earlier ops of its own transaction
+//
+//A transaction copies every vertex it touches, runs its ops on the copies and writes back the ones it changed on commit
+//A descriptor lives until the next AllocateDesc of the same thread, the graphs keep no reference to it
+template<typename Key>
+class BasicBaselineGraph
+{
+public:
+    typedef BasicOperator<Key> Operator;
+    typedef BasicDesc<Key> Desc;
+
+    void Init()
+    {
+    }
+
+    Desc* AllocateDesc(uint32_t size);
+
+    //Transactions re-executed after a conflict, only the optimistic graph has any
+    volatile uint64_t retries = 0;
+
+protected:
+    struct Vertex
+    {
+        bool present = false;
+        //Sorted
+        std::vector<Key> edges;
+    };
+
+    struct Entry
+    {
+        Key key;
+        bool written;
+        Vertex vertex;
+        //Version of the vertex the copy was taken from, see StmAdjacencyList
+        uint64_t version;
+    };
+
+    //One entry per distinct vertex key of desc in ascending order, the copies are left to the caller
+    //The entries are reused by the next transaction of the calling thread
+    static std::vector<Entry>& Entries(Desc* desc);
+    //Runs the ops on the entries, returns false at the first one that fails
+    static bool ApplyOps(Desc* desc, std::vector<Entry>& entries);
+};
+
+//Every transaction holds one mutex over a hash map of the vertices
+template<typename Key>
+class BasicLockedAdjacencyList : public BasicBaselineGraph<Key>
+{
+public:
+    typedef BasicDesc<Key> Desc;
+
+    bool ExecuteOps(Desc* desc);
+
+private:
+    typedef typename BasicBaselineGraph<Key>::Vertex Vertex;
+    typedef typename BasicBaselineGraph<Key>::Entry Entry;
+
+    std::mutex lock;
+    std::unordered_map<Key, Vertex> vertices;
+};
+
+//Two-phase locking with a mutex per vertex: a transaction locks its vertices in key order, so no two ever wait on each other in a cycle
+//Vertices are kept in a table indexed by key, a transaction with a vertex key past key_range fails
+template<typename Key>
+class BasicVertexLockedAdjacencyList : public BasicBaselineGraph<Key>
+{
+public:
+    typedef BasicDesc<Key> Desc;
+
+    BasicVertexLockedAdjacencyList(uint32_t _key_range);
+    ~BasicVertexLockedAdjacencyList();
+
+    bool ExecuteOps(Desc* desc);
+
+private:
+    typedef typename BasicBaselineGraph<Key>::Vertex Vertex;
+    typedef typename BasicBaselineGraph<Key>::Entry Entry;
+
+    struct __attribute__((aligned(64))) Slot
+    {
+        std::mutex lock;
+        Vertex vertex;
+    };
+
+    uint32_t key_range;
+    Slot* slots;
+};
+
+//Software transactional memory in the style of TL2, with one versioned lock per vertex
+//A transaction reads the vertices without locking as of the global version clock, a read of a vertex changed since then
+//or locked restarts it. On commit it locks the vertices it wrote, takes a new version and checks that nothing it read changed
+//Vertex states are immutable and replaced whole, so readers copy them without locks. Replaced states are freed with the graph
+//Vertices are kept in a table indexed by key, a transaction with a vertex key past key_range fails
+template<typename Key>
+class BasicStmAdjacencyList : public BasicBaselineGraph<Key>
+{
+public:
+    typedef BasicDesc<Key> Desc;
+
+    BasicStmAdjacencyList(uint32_t _key_range);
+    ~BasicStmAdjacencyList();
+
+    bool ExecuteOps(Desc* desc);
+
+private:
+    typedef typename BasicBaselineGraph<Key>::Vertex Vertex;
+    typedef typename BasicBaselineGraph<Key>::Entry Entry;
+
+    struct State
+    {
+        Vertex vertex;
+        //Next state replaced before this one
+        State* retired;
+    };
+
+    //The lock word is the version shifted left by one, the low bit is set while a committing transaction holds the vertex
+    //A NULL state is an absent vertex
+    struct __attribute__((aligned(64))) Slot
+    {
+        volatile uint64_t lock;
+        State* volatile state;
+    };
+
+    //Releases the locks of the written entries before end, unchanged
+    void Unlock(std::vector<Entry>& entries, size_t end);
+
+    uint32_t key_range;
+    Slot* slots;
+    volatile uint64_t clock;
+    State* volatile retired;
+};
+
+typedef BasicLockedAdjacencyList<uint32_t> LockedAdjacencyList;
+typedef BasicVertexLockedAdjacencyList<uint32_t> VertexLockedAdjacencyList;
+typedef BasicStmAdjacencyList<uint32_t> StmAdjacencyList;
+
+#include "Baselines_impl.h"
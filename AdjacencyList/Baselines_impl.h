@@ -0,0 +1,406 @@
+//Included at the end of Baselines.h, the baselines are templates and live in headers only
+#pragma once
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+
+template<typename Key>
+typename BasicBaselineGraph<Key>::Desc* BasicBaselineGraph<Key>::AllocateDesc(uint32_t size)
+{
+    static thread_local std::vector<uint64_t> buffer;
+
+    buffer.resize(Desc::Units(size) * DESC_UNIT / sizeof(uint64_t));
+
+    Desc* desc = (Desc*)buffer.data();
+    desc->status = ACTIVE;
+    desc->size = size;
+    desc->commit_ts = 0;
+    desc->wal_lsn = 0;
+    desc->coordinator = NULL;
+
+    return desc;
+}
+
+template<typename Key>
+std::vector<typename BasicBaselineGraph<Key>::Entry>& BasicBaselineGraph<Key>::Entries(Desc* desc)
+{
+    static thread_local std::vector<Entry> entries;
+    static thread_local std::vector<Key> keys;
+
+    keys.clear();
+
+    for (uint32_t i = 0; i < desc->size; i++)
+    {
+        keys.push_back(desc->ops[i].key);
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    //Entries keep the capacity of their edge vectors from earlier transactions
+    entries.resize(keys.size());
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        entries[i].key = keys[i];
+        entries[i].written = false;
+    }
+
+    return entries;
+}
+
+template<typename Key>
+bool BasicBaselineGraph<Key>::ApplyOps(Desc* desc, std::vector<Entry>& entries)
+{
+    for (uint32_t i = 0; i < desc->size; i++)
+    {
+        const Operator& op = desc->ops[i];
+        Entry& entry = *std::lower_bound(entries.begin(), entries.end(), op.key, [](const Entry& e, Key key) { return e.key < key; });
+        Vertex& vertex = entry.vertex;
+
+        switch (op.type)
+        {
+        //Properties are not kept, setting one only needs the vertex
+        case FIND:
+        case SET_PROPERTY:
+            if (!vertex.present)
+            {
+                return false;
+            }
+            break;
+
+        case INSERT:
+            if (vertex.present)
+            {
+                return false;
+            }
+            vertex.present = true;
+            vertex.edges.clear();
+            entry.written = true;
+            break;
+
+        case DELETE:
+            if (!vertex.present)
+            {
+                return false;
+            }
+            vertex.present = false;
+            vertex.edges.clear();
+            entry.written = true;
+            break;
+
+        case INSERT_EDGE:
+        {
+            if (!vertex.present)
+            {
+                return false;
+            }
+
+            typename std::vector<Key>::iterator it = std::lower_bound(vertex.edges.begin(), vertex.edges.end(), op.edge_key);
+            if (it != vertex.edges.end() && *it == op.edge_key)
+            {
+                return false;
+            }
+
+            vertex.edges.insert(it, op.edge_key);
+            entry.written = true;
+            break;
+        }
+
+        case DELETE_EDGE:
+        {
+            if (!vertex.present)
+            {
+                return false;
+            }
+
+            typename std::vector<Key>::iterator it = std::lower_bound(vertex.edges.begin(), vertex.edges.end(), op.edge_key);
+            if (it == vertex.edges.end() || *it != op.edge_key)
+            {
+                return false;
+            }
+
+            vertex.edges.erase(it);
+            entry.written = true;
+            break;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Key>
+bool BasicLockedAdjacencyList<Key>::ExecuteOps(Desc* desc)
+{
+    std::vector<Entry>& entries = this->Entries(desc);
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (Entry& entry : entries)
+    {
+        typename std::unordered_map<Key, Vertex>::iterator it = vertices.find(entry.key);
+
+        if (it != vertices.end())
+        {
+            entry.vertex = it->second;
+        }
+        else
+        {
+            entry.vertex.present = false;
+            entry.vertex.edges.clear();
+        }
+    }
+
+    if (!this->ApplyOps(desc, entries))
+    {
+        return false;
+    }
+
+    for (Entry& entry : entries)
+    {
+        if (!entry.written)
+        {
+            continue;
+        }
+
+        if (entry.vertex.present)
+        {
+            vertices[entry.key] = entry.vertex;
+        }
+        else
+        {
+            vertices.erase(entry.key);
+        }
+    }
+
+    return true;
+}
+
+template<typename Key>
+BasicVertexLockedAdjacencyList<Key>::BasicVertexLockedAdjacencyList(uint32_t _key_range)
+    : key_range(_key_range)
+    , slots(new Slot[_key_range])
+{
+}
+
+template<typename Key>
+BasicVertexLockedAdjacencyList<Key>::~BasicVertexLockedAdjacencyList()
+{
+    delete[] slots;
+}
+
+template<typename Key>
+bool BasicVertexLockedAdjacencyList<Key>::ExecuteOps(Desc* desc)
+{
+    std::vector<Entry>& entries = this->Entries(desc);
+
+    //Entries are sorted, the last one has the largest key
+    if (entries.empty() || entries.back().key >= key_range)
+    {
+        return entries.empty();
+    }
+
+    for (Entry& entry : entries)
+    {
+        Slot& slot = slots[entry.key];
+        slot.lock.lock();
+        entry.vertex = slot.vertex;
+    }
+
+    bool committed = this->ApplyOps(desc, entries);
+
+    for (Entry& entry : entries)
+    {
+        Slot& slot = slots[entry.key];
+
+        if (committed && entry.written)
+        {
+            slot.vertex = entry.vertex;
+        }
+
+        slot.lock.unlock();
+    }
+
+    return committed;
+}
+
+template<typename Key>
+BasicStmAdjacencyList<Key>::BasicStmAdjacencyList(uint32_t _key_range)
+    : key_range(_key_range)
+    , slots(new Slot[_key_range]())
+    , clock(0)
+    , retired(NULL)
+{
+}
+
+template<typename Key>
+BasicStmAdjacencyList<Key>::~BasicStmAdjacencyList()
+{
+    for (uint32_t i = 0; i < key_range; i++)
+    {
+        delete slots[i].state;
+    }
+
+    while (retired != NULL)
+    {
+        State* next = retired->retired;
+        delete retired;
+        retired = next;
+    }
+
+    delete[] slots;
+}
+
+template<typename Key>
+void BasicStmAdjacencyList<Key>::Unlock(std::vector<Entry>& entries, size_t end)
+{
+    for (size_t i = 0; i < end; i++)
+    {
+        if (entries[i].written)
+        {
+            __atomic_store_n(&slots[entries[i].key].lock, entries[i].version, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+template<typename Key>
+bool BasicStmAdjacencyList<Key>::ExecuteOps(Desc* desc)
+{
+    std::vector<Entry>& entries = this->Entries(desc);
+
+    if (entries.empty() || entries.back().key >= key_range)
+    {
+        return entries.empty();
+    }
+
+    while (true)
+    {
+        uint64_t read_version = __atomic_load_n(&clock, __ATOMIC_ACQUIRE);
+        bool consistent = true;
+
+        //A state goes with the lock word read before it if the word is unchanged after it
+        for (Entry& entry : entries)
+        {
+            Slot& slot = slots[entry.key];
+            uint64_t lock = __atomic_load_n(&slot.lock, __ATOMIC_ACQUIRE);
+            State* state = __atomic_load_n(&slot.state, __ATOMIC_ACQUIRE);
+
+            if ((lock & 1) || (lock >> 1) > read_version || __atomic_load_n(&slot.lock, __ATOMIC_ACQUIRE) != lock)
+            {
+                consistent = false;
+                break;
+            }
+
+            entry.version = lock;
+
+            if (state != NULL)
+            {
+                entry.vertex = state->vertex;
+            }
+            else
+            {
+                entry.vertex.present = false;
+                entry.vertex.edges.clear();
+            }
+        }
+
+        if (!consistent)
+        {
+            __sync_fetch_and_add(&this->retries, 1);
+            continue;
+        }
+
+        //Every read was of the graph as of read_version, a failing op fails there too
+        if (!this->ApplyOps(desc, entries))
+        {
+            return false;
+        }
+
+        //A read only transaction commits at read_version
+        bool writes = false;
+
+        for (Entry& entry : entries)
+        {
+            writes = writes || entry.written;
+        }
+
+        if (!writes)
+        {
+            return true;
+        }
+
+        //Locking a written vertex at the version it was read at also checks it did not change
+        size_t locked = 0;
+
+        for (; locked < entries.size(); locked++)
+        {
+            Entry& entry = entries[locked];
+
+            if (entry.written && !__sync_bool_compare_and_swap(&slots[entry.key].lock, entry.version, entry.version | 1))
+            {
+                break;
+            }
+        }
+
+        if (locked < entries.size())
+        {
+            Unlock(entries, locked);
+            __sync_fetch_and_add(&this->retries, 1);
+            continue;
+        }
+
+        uint64_t write_version = __sync_add_and_fetch(&clock, 1);
+
+        //No other transaction took a version in between, nothing read can have changed
+        if (write_version != read_version + 1)
+        {
+            for (Entry& entry : entries)
+            {
+                if (!entry.written && __atomic_load_n(&slots[entry.key].lock, __ATOMIC_ACQUIRE) != entry.version)
+                {
+                    consistent = false;
+                    break;
+                }
+            }
+        }
+
+        if (!consistent)
+        {
+            Unlock(entries, entries.size());
+            __sync_fetch_and_add(&this->retries, 1);
+            continue;
+        }
+
+        for (Entry& entry : entries)
+        {
+            if (!entry.written)
+            {
+                continue;
+            }
+
+            Slot& slot = slots[entry.key];
+            State* old_state = slot.state;
+            State* new_state = entry.vertex.present ? new State{entry.vertex, NULL} : NULL;
+
+            __atomic_store_n(&slot.state, new_state, __ATOMIC_RELEASE);
+            __atomic_store_n(&slot.lock, write_version << 1, __ATOMIC_RELEASE);
+
+            //Readers may still be copying the old state
+            if (old_state != NULL)
+            {
+                State* head = retired;
+
+                do
+                {
+                    old_state->retired = head;
+                }
+                while ((head = __sync_val_compare_and_swap(&retired, old_state->retired, old_state)) != old_state->retired);
+            }
+        }
+
+        return true;
+    }
+}
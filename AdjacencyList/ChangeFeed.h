@@ -0,0 +1,93 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include "AdjacencyList.h"
+
+//Optional feed of committed transactions in commit timestamp order, for caches and indexes that follow the graph
+//Every value drawn from the commit clock gets one record in a bounded ring: the transaction that took it as its commit timestamp,
+//or a hole for a value a concurrent draw made redundant. The thread that drew the value stores the record in slot ts % capacity
+//with a single CAS, the commit path never waits for consumers
+//
+//A record is the descriptor of its transaction, descriptors are never freed, so consumers read the ops in place
+//A consumer that falls a whole ring behind finds its records overwritten by later laps, it is told how many it lost
+//
+//Attach the feed after WriteAheadLog::Open, recovery moves the commit clock past values no transaction took
+//A shared list cannot have a feed, it lives in the heap of one process and the others could not follow list->feed
+template<typename Key>
+class BasicChangeFeed
+{
+public:
+    typedef BasicAdjacencyList<Key> List;
+    typedef BasicOperator<Key> Operator;
+    typedef BasicDesc<Key> Desc;
+
+    //A committed transaction, ops points into its descriptor and includes its FIND ops
+    struct Change
+    {
+        uint64_t commit_ts;
+        const Operator* ops;
+        uint32_t size;
+    };
+
+    enum ReadStatus
+    {
+        FEED_CHANGE = 0,    //change holds the next transaction
+        FEED_EMPTY,         //caught up, or the next transaction is still being published
+        FEED_OVERRUN        //records were overwritten before they were read, the cursor moved past them
+    };
+
+    //Read position of one consumer, a cursor is used by one thread at a time
+    class Cursor
+    {
+    public:
+        ReadStatus Next(Change& change);
+        //Clock values the cursor has not read past, holes and transactions still being published included
+        uint64_t Lag();
+
+        //Records overwritten before this cursor read them
+        uint64_t lost;
+
+    private:
+        friend class BasicChangeFeed;
+        Cursor(BasicChangeFeed* _feed, uint64_t _position);
+
+        BasicChangeFeed* feed;
+        //Commit timestamp of the next record to read
+        uint64_t position;
+    };
+
+    //Holds the last capacity clock values, rounded up to a power of two
+    BasicChangeFeed(List* _list, uint32_t capacity);
+    //Detaches from the list if attached, runs once no transactions are executing
+    ~BasicChangeFeed();
+
+    //Starts publishing the commits of the list, false without attaching if the list is shared
+    bool Attach();
+
+    //The cursor starts with the next transaction to commit
+    Cursor* Subscribe();
+    void Unsubscribe(Cursor* cursor);
+    //Largest lag of the subscribed cursors, approximate while they read
+    uint64_t MaxLag();
+
+    //Called by the thread that drew ts from the commit clock, with the transaction that took it or NULL for a hole
+    //Without subscribers this is a single load
+    void Publish(uint64_t ts, Desc* desc);
+
+private:
+    //A slot holds the descriptor of a record, which carries its timestamp, or a hole as (ts << 1) | 1
+    static uint64_t SlotTs(uintptr_t slot);
+
+    List* list;
+    bool attached;
+    uint64_t capacity;
+    volatile uintptr_t* slots;
+
+    volatile uint32_t subscribers;
+    std::mutex cursors_lock;
+    std::vector<Cursor*> cursors;
+};
+
+typedef BasicChangeFeed<uint32_t> ChangeFeed;
+
+#include "ChangeFeed_impl.h"
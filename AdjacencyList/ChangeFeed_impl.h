@@ -0,0 +1,182 @@
+//Included at the end of ChangeFeed.h, the feed is a template and lives in headers only
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+template<typename Key>
+BasicChangeFeed<Key>::BasicChangeFeed(List* _list, uint32_t _capacity)
+    : list(_list)
+    , attached(false)
+    , capacity(1)
+    , subscribers(0)
+{
+    while (capacity < _capacity)
+    {
+        capacity <<= 1;
+    }
+
+    slots = new uintptr_t[capacity]();
+}
+
+template<typename Key>
+BasicChangeFeed<Key>::~BasicChangeFeed()
+{
+    if (attached)
+    {
+        list->feed = NULL;
+    }
+
+    for (Cursor* cursor : cursors)
+    {
+        delete cursor;
+    }
+
+    delete[] slots;
+}
+
+template<typename Key>
+bool BasicChangeFeed<Key>::Attach()
+{
+    //The feed lives in the heap of this process, the other processes of a shared list could not follow list->feed
+    if (list->shared)
+    {
+        return false;
+    }
+
+    attached = true;
+    list->feed = this;
+
+    return true;
+}
+
+template<typename Key>
+uint64_t BasicChangeFeed<Key>::SlotTs(uintptr_t slot)
+{
+    if (slot & 1)
+    {
+        return slot >> 1;
+    }
+
+    return slot != 0 ? ((Desc*)slot)->commit_ts : 0;
+}
+
+template<typename Key>
+inline void BasicChangeFeed<Key>::Publish(uint64_t ts, Desc* desc)
+{
+    if (subscribers == 0)
+    {
+        return;
+    }
+
+    uintptr_t record = desc != NULL ? (uintptr_t)desc : (uintptr_t)((ts << 1) | 1);
+    volatile uintptr_t* slot = &slots[ts & (capacity - 1)];
+    uintptr_t current = *slot;
+
+    //A slow publisher must not overwrite the record of a later lap
+    while (SlotTs(current) < ts)
+    {
+        uintptr_t seen = __sync_val_compare_and_swap(slot, current, record);
+
+        if (seen == current)
+        {
+            return;
+        }
+
+        current = seen;
+    }
+}
+
+//Values drawn from the clock once subscribers is raised are all published, so the cursor starts right after the clock
+//A publisher reads subscribers after its draw, and the draw of every value past the one read here comes after the increment
+template<typename Key>
+typename BasicChangeFeed<Key>::Cursor* BasicChangeFeed<Key>::Subscribe()
+{
+    std::lock_guard<std::mutex> guard(cursors_lock);
+
+    __sync_fetch_and_add(&subscribers, 1);
+    Cursor* cursor = new Cursor(this, __sync_fetch_and_add(&list->commit_clock, 0) + 1);
+    cursors.push_back(cursor);
+
+    return cursor;
+}
+
+template<typename Key>
+void BasicChangeFeed<Key>::Unsubscribe(Cursor* cursor)
+{
+    std::lock_guard<std::mutex> guard(cursors_lock);
+
+    cursors.erase(std::remove(cursors.begin(), cursors.end(), cursor), cursors.end());
+    __sync_fetch_and_sub(&subscribers, 1);
+    delete cursor;
+}
+
+template<typename Key>
+uint64_t BasicChangeFeed<Key>::MaxLag()
+{
+    std::lock_guard<std::mutex> guard(cursors_lock);
+    uint64_t lag = 0;
+
+    for (Cursor* cursor : cursors)
+    {
+        lag = std::max(lag, cursor->Lag());
+    }
+
+    return lag;
+}
+
+template<typename Key>
+BasicChangeFeed<Key>::Cursor::Cursor(BasicChangeFeed* _feed, uint64_t _position)
+    : lost(0)
+    , feed(_feed)
+    , position(_position)
+{
+}
+
+template<typename Key>
+typename BasicChangeFeed<Key>::ReadStatus BasicChangeFeed<Key>::Cursor::Next(Change& change)
+{
+    while (true)
+    {
+        uintptr_t slot = feed->slots[position & (feed->capacity - 1)];
+        uint64_t ts = SlotTs(slot);
+
+        if (ts < position)
+        {
+            return FEED_EMPTY;
+        }
+
+        if (ts > position)
+        {
+            //Every value up to the clock may have been written a lap after the ones left in the ring
+            uint64_t clock = feed->list->commit_clock;
+            uint64_t oldest = clock >= feed->capacity ? clock - feed->capacity + 1 : 1;
+            uint64_t skip_to = std::max(position + 1, oldest);
+
+            lost += skip_to - position;
+            position = skip_to;
+
+            return FEED_OVERRUN;
+        }
+
+        position++;
+
+        if ((slot & 1) == 0)
+        {
+            Desc* desc = (Desc*)slot;
+            change.commit_ts = ts;
+            change.ops = desc->ops;
+            change.size = desc->size;
+
+            return FEED_CHANGE;
+        }
+    }
+}
+
+template<typename Key>
+uint64_t BasicChangeFeed<Key>::Cursor::Lag()
+{
+    uint64_t clock = feed->list->commit_clock;
+
+    return clock >= position ? clock - position + 1 : 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include "AdjacencyList.h"
+
+//Splits the graph over shard_count independent lists by a hash of the vertex key, each vertex lives with its edges in one shard
+//Shards share nothing but the threads that run on them, so each can be placed on its own NUMA node or socket
+//
+//A transaction whose ops all fall in one shard runs through that shard's ExecuteOps unchanged
+//Any other is split into one part per shard it touches, tied together by a Coordinator and committed in two phases:
+//every part runs its ops and prepares, then all parts commit or all abort. Threads help the parts of other transactions
+//they run into as they help transactions within a list, so the protocol never blocks
+//
+//Every shard keeps its own commit clock, a snapshot of a shard sees whole cross-shard transactions as far as that shard goes
+//Behind the same transaction interface as the list and the baselines: Init, AllocateDesc and ExecuteOps
+template<typename Key>
+class BasicShardedAdjacencyList
+{
+public:
+    typedef BasicAdjacencyList<Key> List;
+    typedef BasicOperator<Key> Operator;
+    typedef BasicDesc<Key> Desc;
+    typedef BasicCoordinator<Key> Coordinator;
+
+    //Every shard is a list for num_threads threads with room for ops items of each kind per thread
+    //A non zero dense_range gives every shard a direct table over all the keys, a shard only fills the entries of its own vertices
+    BasicShardedAdjacencyList(uint32_t shard_count, int num_threads, int transize, int ops, uint32_t dense_range = 0);
+    ~BasicShardedAdjacencyList();
+
+    //Each thread calls Init once, it is set up on every shard since it may help the parts of a transaction on any of them
+    void Init();
+    //A descriptor of the calling thread that lives until its next AllocateDesc, ExecuteOps copies the ops into the shards
+    Desc* AllocateDesc(uint32_t size);
+    bool ExecuteOps(Desc* desc);
+
+    //The splitmix64 finalizer, a multiplicative hash alone would put keys a fixed distance apart a fixed number of shards apart
+    static uint32_t ShardOf(Key vertex, uint32_t shard_count)
+    {
+        uint64_t hash = (uint64_t)vertex;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        hash = hash ^ (hash >> 31);
+
+        return (uint32_t)(hash % shard_count);
+    }
+
+    uint32_t ShardOf(Key vertex)
+    {
+        return ShardOf(vertex, shard_count);
+    }
+
+    List* ShardFor(Key vertex)
+    {
+        return shards[ShardOf(vertex)];
+    }
+
+    uint32_t shard_count;
+    std::vector<List*> shards;
+
+private:
+    PreAllocator<Coordinator>* coordinator_allocator;
+};
+
+typedef BasicShardedAdjacencyList<uint32_t> ShardedAdjacencyList;
+typedef BasicShardedAdjacencyList<uint64_t> ShardedAdjacencyList64;
+
+#include "ShardedAdjacencyList_impl.h"
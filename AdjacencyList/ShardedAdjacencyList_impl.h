@@ -0,0 +1,128 @@
+//Included at the end of ShardedAdjacencyList.h, the sharded graph is a template and lives in headers only
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+template<typename Key>
+BasicShardedAdjacencyList<Key>::BasicShardedAdjacencyList(uint32_t _shard_count, int num_threads, int transize, int ops, uint32_t dense_range)
+    : shard_count(_shard_count)
+{
+    if (shard_count == 0)
+    {
+        printf("Error: a sharded graph needs at least one shard\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    for (uint32_t i = 0; i < shard_count; i++)
+    {
+        shards.push_back(new List(num_threads, transize, ops, dense_range));
+        shards.back()->sharded = true;
+    }
+
+    //A transaction has a part on at most as many shards as it has ops
+    coordinator_allocator = new PreAllocator<Coordinator>(num_threads, DESC_UNIT, ops * Coordinator::Units(std::min<uint32_t>(shard_count, transize)));
+}
+
+template<typename Key>
+BasicShardedAdjacencyList<Key>::~BasicShardedAdjacencyList()
+{
+    for (List* shard : shards)
+    {
+        delete shard;
+    }
+
+    delete coordinator_allocator;
+}
+
+template<typename Key>
+void BasicShardedAdjacencyList<Key>::Init()
+{
+    for (List* shard : shards)
+    {
+        shard->Init();
+    }
+
+    coordinator_allocator->init();
+}
+
+template<typename Key>
+typename BasicShardedAdjacencyList<Key>::Desc* BasicShardedAdjacencyList<Key>::AllocateDesc(uint32_t size)
+{
+    static thread_local std::vector<uint64_t> buffer;
+
+    buffer.resize(Desc::Units(size) * DESC_UNIT / sizeof(uint64_t));
+
+    Desc* desc = (Desc*)buffer.data();
+    desc->status = ACTIVE;
+    desc->size = size;
+    desc->commit_ts = 0;
+    desc->wal_lsn = 0;
+    desc->coordinator = NULL;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        desc->ops[i].property = NULL;
+    }
+
+    return desc;
+}
+
+template<typename Key>
+bool BasicShardedAdjacencyList<Key>::ExecuteOps(Desc* desc)
+{
+    static thread_local std::vector<uint32_t> counts;
+    static thread_local std::vector<Desc*> parts;
+
+    counts.assign(shard_count, 0);
+    parts.assign(shard_count, NULL);
+
+    uint32_t touched = 0;
+    uint32_t last = 0;
+
+    for (uint32_t i = 0; i < desc->size; i++)
+    {
+        last = ShardOf(desc->ops[i].key);
+
+        if (counts[last]++ == 0)
+        {
+            touched++;
+        }
+    }
+
+    if (touched <= 1)
+    {
+        Desc* part = shards[last]->AllocateDesc(desc->size);
+        std::copy(desc->ops, desc->ops + desc->size, part->ops);
+
+        return shards[last]->ExecuteOps(part);
+    }
+
+    Coordinator* coordinator = coordinator_allocator->get_new(Coordinator::Units(touched));
+    coordinator->status = ACTIVE;
+    coordinator->size = 0;
+
+    for (uint32_t shard = 0; shard < shard_count; shard++)
+    {
+        if (counts[shard] == 0)
+        {
+            continue;
+        }
+
+        parts[shard] = shards[shard]->AllocateDesc(counts[shard]);
+        parts[shard]->coordinator = coordinator;
+        coordinator->parts[coordinator->size].shard = shards[shard];
+        coordinator->parts[coordinator->size].desc = parts[shard];
+        coordinator->size++;
+        counts[shard] = 0;
+    }
+
+    //Ops keep their order within each part
+    for (uint32_t i = 0; i < desc->size; i++)
+    {
+        uint32_t shard = ShardOf(desc->ops[i].key);
+        parts[shard]->ops[counts[shard]++] = desc->ops[i];
+    }
+
+    return List::ExecuteCoordinated(coordinator);
+}
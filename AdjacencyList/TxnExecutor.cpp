@@ -0,0 +1,413 @@
+#include <chrono>
+#include <cstring>
+#include "TxnExecutor.h"
+
+TxnFuture& TxnFuture::operator=(TxnFuture&& other)
+{
+    if (this != &other)
+    {
+        if (request != NULL)
+        {
+            request->Release();
+        }
+
+        request = other.request;
+        other.request = NULL;
+    }
+
+    return *this;
+}
+
+TxnFuture::~TxnFuture()
+{
+    if (request != NULL)
+    {
+        request->Release();
+    }
+}
+
+bool TxnFuture::Ready()
+{
+    return request->flags.load() & TxnRequest::DONE;
+}
+
+//Parks a thread in Get until the executor that ran its transaction wakes it
+struct GetWaiter
+{
+    std::mutex lock;
+    std::condition_variable wake;
+    bool done = false;
+};
+
+//The waiter lives on the stack of Get, it is only touched under its lock, which Get takes before returning
+static void WakeGetWaiter(void* arg, uint8_t status)
+{
+    GetWaiter* waiter = (GetWaiter*)arg;
+    std::lock_guard<std::mutex> guard(waiter->lock);
+
+    waiter->done = true;
+    waiter->wake.notify_one();
+}
+
+bool TxnFuture::Get()
+{
+    for (uint32_t spin = 0; spin < GET_SPINS && !Ready(); spin++)
+    {
+        std::this_thread::yield();
+    }
+
+    if (!Ready())
+    {
+        //The callback slot is taken by OnComplete or co_await, those waits stay on yield
+        if (request->flags.load() & TxnRequest::WAITING)
+        {
+            while (!Ready())
+            {
+                std::this_thread::yield();
+            }
+        }
+        else
+        {
+            GetWaiter waiter;
+
+            if (Register(&WakeGetWaiter, &waiter))
+            {
+                std::unique_lock<std::mutex> guard(waiter.lock);
+                waiter.wake.wait(guard, [&waiter] { return waiter.done; });
+            }
+        }
+    }
+
+    return request->status == COMMITTED;
+}
+
+bool TxnFuture::Register(TxnRequest::Callback callback, void* arg)
+{
+    request->callback = callback;
+    request->callback_arg = arg;
+
+    //The executor reads the callback only if it sees the waiting flag, after the fields above are written
+    return !(request->flags.fetch_or(TxnRequest::WAITING) & TxnRequest::DONE);
+}
+
+void TxnFuture::OnComplete(TxnRequest::Callback callback, void* arg)
+{
+    if (!Register(callback, arg))
+    {
+        callback(arg, request->status);
+    }
+}
+
+__thread TxnExecutor::Executor* TxnExecutor::local_executor;
+
+TxnExecutor::TxnExecutor(AdjacencyList* _list, int num_executors, const ExecutorConfig& _config)
+    : list(_list)
+    , config(_config)
+    , running(true)
+    , next_executor(0)
+{
+    if (config.batch_size == 0)
+    {
+        config.batch_size = 1;
+    }
+
+    for (int i = 0; i < num_executors; i++)
+    {
+        executors.push_back(new Executor(this, i, config.queue_capacity));
+    }
+
+    for (Executor* executor : executors)
+    {
+        executor->thread = std::thread(&TxnExecutor::Run, this, executor);
+    }
+}
+
+TxnExecutor::~TxnExecutor()
+{
+    running.store(false);
+
+    for (Executor* executor : executors)
+    {
+        Wake(executor);
+    }
+
+    //Executors may still steal from each other until all have drained, so none is freed before all exited
+    for (Executor* executor : executors)
+    {
+        executor->thread.join();
+    }
+
+    for (Executor* executor : executors)
+    {
+        delete executor;
+    }
+}
+
+TxnFuture TxnExecutor::Submit(Desc* desc)
+{
+    TxnRequest* request = new TxnRequest();
+    request->desc = desc;
+
+    return Enqueue(request);
+}
+
+TxnFuture TxnExecutor::Submit(const Operator* ops, uint32_t size)
+{
+    TxnRequest* request = new TxnRequest();
+    request->desc = NULL;
+    request->ops.assign(ops, ops + size);
+
+    return Enqueue(request);
+}
+
+int TxnExecutor::Executors()
+{
+    return executors.size();
+}
+
+ExecutorStats TxnExecutor::Stats(int executor)
+{
+    Executor* e = executors[executor];
+    ExecutorStats stats;
+
+    stats.executed = e->executed.load(std::memory_order_relaxed);
+    stats.steals = e->steals.load(std::memory_order_relaxed);
+    stats.queue_depth = e->inbox.Size() + e->deque.Size();
+
+    return stats;
+}
+
+TxnFuture TxnExecutor::Enqueue(TxnRequest* request)
+{
+    request->status = ACTIVE;
+    request->flags.store(0);
+    //One reference for the future and one for the executor
+    request->refs.store(2);
+    request->callback = NULL;
+    request->callback_arg = NULL;
+
+    //Submitted by one of our executors, keep it local where the other executors can still steal it
+    if (local_executor != NULL && local_executor->owner == this)
+    {
+        local_executor->deque.Push(request);
+        return TxnFuture(request);
+    }
+
+    uint32_t count = executors.size();
+    uint32_t start;
+
+    if (config.route_by_key)
+    {
+        uint32_t key = request->desc != NULL ? request->desc->ops[0].key : (request->ops.empty() ? 0 : request->ops[0].key);
+        start = key % count;
+    }
+    else
+    {
+        start = next_executor.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    while (true)
+    {
+        //Spill over to the next executor when an inbox is full
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Executor* executor = executors[(start + i) % count];
+
+            if (executor->inbox.Enqueue(request))
+            {
+                //Pairs with the fence in Sleep, either the executor sees the request or we see it sleeping
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (executor->sleeping.load())
+                {
+                    Wake(executor);
+                }
+
+                return TxnFuture(request);
+            }
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+void TxnExecutor::Wake(Executor* executor)
+{
+    std::lock_guard<std::mutex> guard(executor->lock);
+    executor->wake.notify_one();
+}
+
+void TxnExecutor::Run(Executor* executor)
+{
+    local_executor = executor;
+    list->Init();
+
+    std::vector<TxnRequest*> batch(config.batch_size);
+    uint32_t idle = 0;
+
+    while (true)
+    {
+        TxnRequest* request;
+
+        if (executor->deque.Pop(request))
+        {
+            Execute(executor, request);
+            idle = 0;
+            continue;
+        }
+
+        uint32_t count = FillBatch(executor, batch.data());
+
+        if (count > 0)
+        {
+            //Run the oldest now and park the rest on the deque, pushed newest first so they pop oldest first
+            for (uint32_t i = count - 1; i > 0; i--)
+            {
+                executor->deque.Push(batch[i]);
+            }
+
+            //Hand part of a burst to an executor that went to sleep
+            if (count > 1 && config.work_stealing)
+            {
+                for (Executor* peer : executors)
+                {
+                    if (peer != executor && peer->sleeping.load())
+                    {
+                        Wake(peer);
+                        break;
+                    }
+                }
+            }
+
+            Execute(executor, batch[0]);
+            idle = 0;
+            continue;
+        }
+
+        if (config.work_stealing && Steal(executor, request))
+        {
+            executor->steals.fetch_add(1, std::memory_order_relaxed);
+            Execute(executor, request);
+            idle = 0;
+            continue;
+        }
+
+        //Anything submitted before shutdown is already queued and has been drained
+        if (!running.load())
+        {
+            break;
+        }
+
+        if (++idle >= config.idle_spins)
+        {
+            Sleep(executor);
+            idle = 0;
+        }
+    }
+
+    local_executor = NULL;
+}
+
+uint32_t TxnExecutor::FillBatch(Executor* executor, TxnRequest** batch)
+{
+    uint32_t count = 0;
+
+    while (count < config.batch_size && executor->inbox.Dequeue(batch[count]))
+    {
+        count++;
+    }
+
+    if (count == 0 || count == config.batch_size || config.batch_latency_us == 0)
+    {
+        return count;
+    }
+
+    //Hold a partial batch until it fills or the oldest transaction in it reaches the latency target
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(config.batch_latency_us);
+
+    while (count < config.batch_size && running.load())
+    {
+        if (executor->inbox.Dequeue(batch[count]))
+        {
+            count++;
+        }
+        else if (std::chrono::steady_clock::now() >= deadline)
+        {
+            break;
+        }
+    }
+
+    return count;
+}
+
+bool TxnExecutor::Steal(Executor* executor, TxnRequest*& request)
+{
+    uint32_t count = executors.size();
+
+    //Start from the last victim, a loaded executor usually stays loaded for a while
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t id = (executor->victim + i) % count;
+        Executor* victim = executors[id];
+
+        if (victim == executor)
+        {
+            continue;
+        }
+
+        //Parked work first, then work its owner has not picked up yet
+        if (victim->deque.Steal(request) || victim->inbox.Dequeue(request))
+        {
+            executor->victim = id;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TxnExecutor::Execute(Executor* executor, TxnRequest* request)
+{
+    Desc* desc = request->desc;
+    uint64_t size = desc != NULL ? desc->size : request->ops.size();
+
+    if (config.room_per_op != 0 && list->Room() < config.room_per_op * size)
+    {
+        request->status = TxnRequest::EXHAUSTED;
+    }
+    else
+    {
+        if (desc == NULL)
+        {
+            desc = list->AllocateDesc(request->ops.size());
+            memcpy(desc->ops, request->ops.data(), sizeof(Operator) * request->ops.size());
+        }
+
+        request->status = list->ExecuteOps(desc) ? COMMITTED : ABORTED;
+        executor->executed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (request->flags.fetch_or(TxnRequest::DONE) & TxnRequest::WAITING)
+    {
+        request->callback(request->callback_arg, request->status);
+    }
+
+    request->Release();
+}
+
+void TxnExecutor::Sleep(Executor* executor)
+{
+    std::unique_lock<std::mutex> guard(executor->lock);
+
+    executor->sleeping.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    //A submitter that saw sleeping waits on the lock until we are in wait, so its notify is not lost
+    //Work parked on other deques does not wake us, the timeout bounds how long it can wait for a thief
+    if (executor->inbox.Empty() && running.load())
+    {
+        executor->wake.wait_for(guard, std::chrono::milliseconds(config.work_stealing ? 1 : 100));
+    }
+
+    executor->sleeping.store(false);
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+#include "AdjacencyList.h"
+#include "mpmc_queue.h"
+#include "ws_deque.h"
+
+//A submitted transaction, shared by the executor running it and the future waiting on it
+struct TxnRequest
+{
+    //status is COMMITTED, ABORTED or EXHAUSTED
+    typedef void (*Callback)(void* arg, uint8_t status);
+
+    //Status of a transaction that was not run, the executor's allocators had no room left for it, see ExecutorConfig::room_per_op
+    static const uint8_t EXHAUSTED = 0xFF;
+
+    //Flags of the completion handshake, whichever side sets its flag second runs the callback
+    static const uint8_t DONE = 1;
+    static const uint8_t WAITING = 2;
+
+    //Set when the caller allocated the descriptor, otherwise the executor builds one from ops
+    Desc* desc;
+    std::vector<Operator> ops;
+
+    volatile uint8_t status;
+    std::atomic<uint8_t> flags;
+    std::atomic<uint32_t> refs;
+    Callback callback;
+    void* callback_arg;
+
+    void Release()
+    {
+        if (refs.fetch_sub(1) == 1)
+        {
+            delete this;
+        }
+    }
+};
+
+//Result of an asynchronous submission, move only
+class TxnFuture
+{
+public:
+    TxnFuture(TxnRequest* _request = NULL) : request(_request) {}
+    TxnFuture(TxnFuture&& other) : request(other.request) { other.request = NULL; }
+    TxnFuture& operator=(TxnFuture&& other);
+    TxnFuture(const TxnFuture&) = delete;
+    TxnFuture& operator=(const TxnFuture&) = delete;
+    ~TxnFuture();
+
+    bool Ready();
+    //Blocks until the transaction finished, returns true if it committed, false if it aborted or was not run
+    //Yields for GET_SPINS polls, then sleeps until the executor wakes it through the completion callback
+    //A future with a callback registered can not take the wake up, its Get keeps yielding
+    bool Get();
+    //Runs callback on the executor thread once the transaction finished, or right away if it already has
+    //At most one callback can be registered per future
+    void OnComplete(TxnRequest::Callback callback, void* arg);
+
+#if defined(__cpp_impl_coroutine)
+    //co_await resumes the coroutine on the executor thread and yields whether the transaction committed
+    //Only built as C++20, bench_async_coro exercises it
+    bool await_ready()
+    {
+        return Ready();
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        return Register(&ResumeCoroutine, handle.address());
+    }
+
+    bool await_resume()
+    {
+        return Get();
+    }
+
+    static void ResumeCoroutine(void* arg, uint8_t status)
+    {
+        std::coroutine_handle<>::from_address(arg).resume();
+    }
+#endif
+
+private:
+    //Polls of Get before it sleeps, most transactions of a short queue finish within them
+    static const uint32_t GET_SPINS = 64;
+
+    //Returns false without registering if the transaction already finished
+    bool Register(TxnRequest::Callback callback, void* arg);
+
+    TxnRequest* request;
+};
+
+struct ExecutorConfig
+{
+    //Most transactions an executor takes from its queue in one batch
+    uint32_t batch_size = 32;
+    //Longest an executor holds a partial batch waiting for it to fill, 0 runs whatever is queued right away
+    uint32_t batch_latency_us = 0;
+    //Slots of each executor queue, submissions spill to the next queue and then wait while all are full
+    uint32_t queue_capacity = 4096;
+    //Empty polls before an idle executor goes to sleep
+    uint32_t idle_spins = 1024;
+    //Idle executors take queued transactions from the others
+    bool work_stealing = true;
+    //Allocations set aside per op, 0 runs every transaction, which exits in the allocator once an executor runs out of room
+    //Otherwise an executor with less room than room_per_op allocations per op of a transaction finishes it as EXHAUSTED unrun
+    //Helpers allocate for the transactions they help, room_per_op leaves room for them as well
+    uint32_t room_per_op = 0;
+    //Send a transaction to the executor picked by the vertex of its first op instead of round robin
+    //Transactions on the same vertex then mostly run on one thread and conflict less, at the cost of uneven queues
+    bool route_by_key = false;
+};
+
+//Counters of one executor, read while it runs
+struct ExecutorStats
+{
+    uint64_t executed;
+    //Transactions this executor took from other executors
+    uint64_t steals;
+    //Transactions waiting in its queue and deque
+    uint64_t queue_depth;
+};
+
+//Runs transactions on a fixed set of executor threads, so callers never need to Init the list
+//The list must be constructed with room for the executor threads in its thread count
+//Submissions land in a lock-free inbox per executor, which the executor moves in batches to its own work stealing deque
+//Idle executors steal from the deques and inboxes of the others, so uneven or bursty arrivals still keep every thread busy
+class TxnExecutor
+{
+public:
+    TxnExecutor(AdjacencyList* _list, int num_executors, const ExecutorConfig& _config = ExecutorConfig());
+    //Runs every submitted transaction before the executors exit
+    ~TxnExecutor();
+
+    //Submits a descriptor allocated by a thread that called Init on the list
+    TxnFuture Submit(Desc* desc);
+    //Submits a transaction from any thread, the executor allocates its descriptor
+    //Called from one of our executor threads, e.g. in a completion callback, it goes straight to that executor's deque
+    TxnFuture Submit(const Operator* ops, uint32_t size);
+
+    int Executors();
+    ExecutorStats Stats(int executor);
+
+private:
+    struct __attribute__((aligned(64))) Executor
+    {
+        Executor(TxnExecutor* _owner, uint32_t _id, uint32_t capacity)
+            : owner(_owner), id(_id), victim(_id), inbox(capacity), sleeping(false), executed(0), steals(0) {}
+
+        TxnExecutor* owner;
+        uint32_t id;
+        //Executor this one tries first when stealing, the last one it stole from
+        uint32_t victim;
+
+        MPMCQueue<TxnRequest*> inbox;
+        WSDeque<TxnRequest*> deque;
+        std::atomic<bool> sleeping;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::thread thread;
+
+        std::atomic<uint64_t> executed;
+        std::atomic<uint64_t> steals;
+    };
+
+    TxnFuture Enqueue(TxnRequest* request);
+    void Wake(Executor* executor);
+    void Run(Executor* executor);
+    uint32_t FillBatch(Executor* executor, TxnRequest** batch);
+    bool Steal(Executor* executor, TxnRequest*& request);
+    void Execute(Executor* executor, TxnRequest* request);
+    void Sleep(Executor* executor);
+
+    //Executor run by the calling thread, NULL on threads that are not executors
+    static __thread Executor* local_executor;
+
+    AdjacencyList* list;
+    ExecutorConfig config;
+    std::vector<Executor*> executors;
+    std::atomic<bool> running;
+    std::atomic<uint32_t> next_executor;
+};
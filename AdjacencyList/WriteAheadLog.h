@@ -0,0 +1,136 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string>
+#include <vector>
+#include "AdjacencyList.h"
+
+struct WalConfig
+{
+    //Longest the flusher waits to gather more commits into a group, 0 writes whatever is queued as soon as the disk is free
+    uint32_t group_commit_us = 0;
+    //ExecuteOps returns only once its commit record is on disk, otherwise a crash can lose the commits of the last groups
+    //Each committer then waits out its group's fsync, group commit shares the fsync but does not hide it, see readme.md
+    bool sync_commit = true;
+};
+
+//Optional write-ahead log of committed transactions
+//The thread that commits a transaction, or the first one to build on it, appends its write ops and commit timestamp to an in memory buffer
+//A flusher thread writes and syncs the buffer as one group, so many commits share each fsync
+//A transaction that builds on another one's result is appended after it, so a durable prefix of the log never holds a
+//transaction without the ones it read from. Recovery replays records in commit timestamp order
+//
+//Checkpoint writes a snapshot of the graph and drops the log it covers. Recovery loads the latest checkpoint and replays the
+//records committed after its snapshot, so the log only ever holds what happened since the last checkpoint
+//
+//Keys are written at their full width, a log is only read back by a list with the key type that wrote it
+template<typename Key>
+class BasicWriteAheadLog
+{
+public:
+    typedef BasicAdjacencyList<Key> List;
+    typedef BasicOperator<Key> Operator;
+    typedef BasicDesc<Key> Desc;
+
+    //The checkpoint is kept in log_path.ckpt, the log it is being rotated away from in log_path.prev
+    BasicWriteAheadLog(List* _list, const std::string& _log_path, const WalConfig& _config = WalConfig());
+    //Flushes what is buffered and detaches from the list
+    ~BasicWriteAheadLog();
+
+    //Rebuilds the graph into the empty list from a previous checkpoint and log, if any, checkpoints it and starts logging
+    //Runs before any transaction on the list, from a thread that called Init on it
+    //Returns the number of log records replayed, -1 if an existing file could not be read, or WAL_UNSUPPORTED without
+    //touching the files or the list if the list is shared or a shard, which cannot be logged
+    int64_t Open();
+    static const int64_t WAL_UNSUPPORTED = -2;
+
+    //Snapshots the graph into the checkpoint and truncates the log, safe while transactions run
+    bool Checkpoint();
+
+    //Appends the commit record of a committed transaction once, later calls return the same LSN
+    uint64_t Append(Desc* desc);
+    //Waits until the record at lsn is on disk, returns at once unless sync_commit is set
+    void WaitDurable(uint64_t lsn);
+
+    //Counters since Open
+    uint64_t records;
+    uint64_t groups;
+    uint64_t bytes;
+
+private:
+    //Commit record: header, op_count write ops, the bytes of their properties in op order, checksum of all three
+    struct __attribute__((packed)) RecordHeader
+    {
+        uint64_t commit_ts;
+        uint32_t op_count;
+    };
+
+    struct __attribute__((packed)) RecordOp
+    {
+        uint8_t type;
+        Key key;
+        Key edge_key;
+        //NO_PROPERTY for an op without one
+        uint32_t property_size;
+    };
+
+    static const uint32_t NO_PROPERTY = ~0u;
+
+    //Commit timestamp and write ops of a logged transaction
+    typedef std::pair<uint64_t, std::vector<Operator>> LogRecord;
+
+    //Marks a descriptor whose record another thread is appending
+    static const uint64_t CLAIMED = ~0ull;
+
+    void Flusher();
+    //Writes out what is buffered, caller holds io_lock
+    void FlushBuffer();
+    void WriteGroup(std::vector<char>& group);
+    bool WriteCheckpoint();
+    bool LoadCheckpoint(uint64_t& snapshot);
+    bool ReadLog(const std::string& path, uint64_t snapshot, std::vector<LogRecord>& log_records);
+    void Execute(std::vector<Operator>& ops);
+    void OpenLog();
+    //Properties are written as their size, NO_PROPERTY for none, and their bytes
+    static uint32_t PropertySize(const Property* property);
+    //Copies the bytes of a written property into the list
+    const Property* LoadProperty(const char* data, uint32_t size);
+
+    static uint32_t Checksum(const char* data, size_t size);
+    static bool FileExists(const std::string& path);
+    static bool ReadFile(const std::string& path, std::vector<char>& data);
+    static void SyncDirectory(const std::string& path);
+
+    List* list;
+    WalConfig config;
+    std::string log_path;
+    std::string prev_path;
+    std::string checkpoint_path;
+    int fd;
+
+    //Records appended since the last group was taken, guarded by lock
+    std::mutex lock;
+    std::condition_variable flush_wake;
+    std::vector<char> buffer;
+    //LSNs count logged bytes from 1, a record's LSN is the position right after it
+    uint64_t appended_lsn;
+
+    //Serializes writes to the log file between the flusher and checkpoints
+    std::mutex io_lock;
+    //Records being written, guarded by io_lock
+    std::vector<char> group;
+    std::mutex checkpoint_lock;
+
+    std::mutex durable_lock;
+    std::condition_variable durable_wake;
+    std::atomic<uint64_t> durable_lsn;
+
+    std::atomic<bool> running;
+    std::thread flusher;
+};
+
+typedef BasicWriteAheadLog<uint32_t> WriteAheadLog;
+
+#include "WriteAheadLog_impl.h"
@@ -0,0 +1,653 @@
+//Included at the end of WriteAheadLog.h, the log is a template and lives in headers only
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libgen.h>
+#include <sys/stat.h>
+
+static const uint64_t CHECKPOINT_MAGIC = 0x32504b4354464cull;   //"LFTCKP2", checkpoints with vertex properties
+
+//Transactions issued while loading a checkpoint
+static const uint32_t RECOVERY_TXN_OPS = 1024;
+
+template<typename Key>
+uint32_t BasicWriteAheadLog<Key>::Checksum(const char* data, size_t size)
+{
+    //FNV-1a
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ (uint8_t)data[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+template<typename Key>
+uint32_t BasicWriteAheadLog<Key>::PropertySize(const Property* property)
+{
+    return property != NULL ? property->size : NO_PROPERTY;
+}
+
+template<typename Key>
+const Property* BasicWriteAheadLog<Key>::LoadProperty(const char* data, uint32_t size)
+{
+    return size != NO_PROPERTY ? list->NewProperty(data, size) : NULL;
+}
+
+template<typename Key>
+bool BasicWriteAheadLog<Key>::FileExists(const std::string& path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+template<typename Key>
+bool BasicWriteAheadLog<Key>::ReadFile(const std::string& path, std::vector<char>& data)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    data.resize(size);
+    bool ok = size == 0 || fread(data.data(), 1, size, file) == (size_t)size;
+    fclose(file);
+
+    return ok;
+}
+
+//A rename is only durable once the directory holding it is synced
+template<typename Key>
+void BasicWriteAheadLog<Key>::SyncDirectory(const std::string& path)
+{
+    std::vector<char> copy(path.begin(), path.end());
+    copy.push_back('\0');
+
+    int dir = open(dirname(copy.data()), O_RDONLY);
+
+    if (dir >= 0)
+    {
+        fsync(dir);
+        close(dir);
+    }
+}
+
+template<typename Key>
+BasicWriteAheadLog<Key>::BasicWriteAheadLog(List* _list, const std::string& _log_path, const WalConfig& _config)
+    : records(0)
+    , groups(0)
+    , bytes(0)
+    , list(_list)
+    , config(_config)
+    , log_path(_log_path)
+    , prev_path(_log_path + ".prev")
+    , checkpoint_path(_log_path + ".ckpt")
+    , fd(-1)
+    , appended_lsn(1)
+    , durable_lsn(1)
+    , running(false)
+{
+}
+
+template<typename Key>
+BasicWriteAheadLog<Key>::~BasicWriteAheadLog()
+{
+    if (running.load())
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            running.store(false);
+            flush_wake.notify_one();
+        }
+
+        flusher.join();
+        list->wal = NULL;
+    }
+
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+template<typename Key>
+int64_t BasicWriteAheadLog<Key>::Open()
+{
+    //The log lives in the heap of this process, the other processes of a shared list could not follow list->wal
+    if (list->shared)
+    {
+        return WAL_UNSUPPORTED;
+    }
+
+    //Every shard keeps its own log and clock, a crash could keep the part of a cross-shard transaction in one log
+    //and lose it in another, recovery has no record that ties the parts together
+    if (list->sharded)
+    {
+        return WAL_UNSUPPORTED;
+    }
+
+    uint64_t snapshot = 0;
+
+    if (FileExists(checkpoint_path) && !LoadCheckpoint(snapshot))
+    {
+        return -1;
+    }
+
+    //A crash during a checkpoint leaves the rotated log behind, its records come before those in the current log
+    std::vector<LogRecord> log_records;
+    const std::string* logs[] = {&prev_path, &log_path};
+
+    for (const std::string* path : logs)
+    {
+        if (FileExists(*path) && !ReadLog(*path, snapshot, log_records))
+        {
+            return -1;
+        }
+    }
+
+    //Appends follow the order in which transactions read each other's results, but a delete vertex that removes
+    //a just committed edge may be appended before the edge insert, the commit timestamps order both correctly
+    std::stable_sort(log_records.begin(), log_records.end(), [](const LogRecord& a, const LogRecord& b) { return a.first < b.first; });
+
+    for (LogRecord& record : log_records)
+    {
+        Execute(record.second);
+    }
+
+    //Later commits must be numbered after every replayed timestamp, so that the checkpoint written below covers all of them
+    uint64_t max_ts = log_records.empty() ? snapshot : log_records.back().first;
+    list->commit_clock = std::max((uint64_t)list->commit_clock, std::max(snapshot, max_ts));
+
+    //The old log is only dropped once a checkpoint covers it
+    if (!WriteCheckpoint())
+    {
+        return -1;
+    }
+
+    unlink(prev_path.c_str());
+    OpenLog();
+
+    list->wal = this;
+    running.store(true);
+    flusher = std::thread(&BasicWriteAheadLog<Key>::Flusher, this);
+
+    return log_records.size();
+}
+
+template<typename Key>
+bool BasicWriteAheadLog<Key>::Checkpoint()
+{
+    std::lock_guard<std::mutex> checkpoint_guard(checkpoint_lock);
+
+    //Rotate the log first: every record in the rotated log then has a timestamp below the snapshot taken next
+    {
+        std::lock_guard<std::mutex> io_guard(io_lock);
+
+        FlushBuffer();
+        close(fd);
+
+        if (rename(log_path.c_str(), prev_path.c_str()) != 0)
+        {
+            perror("Error: rotating the log");
+            std::exit(EXIT_FAILURE);
+        }
+
+        OpenLog();
+    }
+
+    if (!WriteCheckpoint())
+    {
+        return false;
+    }
+
+    unlink(prev_path.c_str());
+
+    return true;
+}
+
+template<typename Key>
+uint64_t BasicWriteAheadLog<Key>::Append(Desc* desc)
+{
+    uint64_t lsn = desc->wal_lsn;
+
+    if (lsn == 0 && __sync_bool_compare_and_swap(&desc->wal_lsn, 0, CLAIMED))
+    {
+        static __thread std::vector<char>* record = NULL;
+        if (record == NULL)
+        {
+            record = new std::vector<char>();
+        }
+
+        record->resize(sizeof(RecordHeader));
+        uint32_t op_count = 0;
+
+        for (uint32_t i = 0; i < desc->size; i++)
+        {
+            const Operator& op = desc->ops[i];
+
+            if (op.type != FIND)
+            {
+                RecordOp record_op = {op.type, op.key, op.edge_key, PropertySize(op.property)};
+                const char* data = (const char*)&record_op;
+                record->insert(record->end(), data, data + sizeof(record_op));
+                op_count++;
+            }
+        }
+
+        for (uint32_t i = 0; i < desc->size; i++)
+        {
+            const Operator& op = desc->ops[i];
+
+            if (op.type != FIND && op.property != NULL)
+            {
+                const char* data = (const char*)op.property->data;
+                record->insert(record->end(), data, data + op.property->size);
+            }
+        }
+
+        RecordHeader header = {desc->commit_ts, op_count};
+        memcpy(record->data(), &header, sizeof(header));
+
+        uint32_t checksum = Checksum(record->data(), record->size());
+        const char* data = (const char*)&checksum;
+        record->insert(record->end(), data, data + sizeof(checksum));
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            //A read only transaction is not logged, it waits for whatever it may have read from instead
+            if (op_count > 0)
+            {
+                if (buffer.empty())
+                {
+                    flush_wake.notify_one();
+                }
+
+                buffer.insert(buffer.end(), record->begin(), record->end());
+                appended_lsn += record->size();
+                records++;
+            }
+
+            lsn = appended_lsn;
+        }
+
+        __atomic_store_n(&desc->wal_lsn, lsn, __ATOMIC_RELEASE);
+
+        return lsn;
+    }
+
+    //Another thread is appending the record, the LSN is only a few instructions away
+    while ((lsn = __atomic_load_n(&desc->wal_lsn, __ATOMIC_ACQUIRE)) == CLAIMED)
+    {
+        std::this_thread::yield();
+    }
+
+    return lsn;
+}
+
+template<typename Key>
+void BasicWriteAheadLog<Key>::WaitDurable(uint64_t lsn)
+{
+    if (!config.sync_commit || durable_lsn.load() >= lsn)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(durable_lock);
+    durable_wake.wait(guard, [&] { return durable_lsn.load() >= lsn; });
+}
+
+template<typename Key>
+void BasicWriteAheadLog<Key>::Flusher()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            flush_wake.wait_for(guard, std::chrono::milliseconds(10), [&] { return !buffer.empty() || !running.load(); });
+
+            if (buffer.empty())
+            {
+                if (!running.load())
+                {
+                    break;
+                }
+
+                continue;
+            }
+        }
+
+        //Let more commits join the group
+        if (config.group_commit_us > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(config.group_commit_us));
+        }
+
+        std::lock_guard<std::mutex> io_guard(io_lock);
+        FlushBuffer();
+    }
+}
+
+template<typename Key>
+void BasicWriteAheadLog<Key>::FlushBuffer()
+{
+    uint64_t lsn;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        group.swap(buffer);
+        lsn = appended_lsn;
+    }
+
+    if (!group.empty())
+    {
+        WriteGroup(group);
+        group.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(durable_lock);
+        durable_lsn.store(lsn);
+    }
+
+    durable_wake.notify_all();
+}
+
+template<typename Key>
+void BasicWriteAheadLog<Key>::WriteGroup(std::vector<char>& data)
+{
+    size_t written = 0;
+
+    while (written < data.size())
+    {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            perror("Error: writing the log");
+            std::exit(EXIT_FAILURE);
+        }
+
+        written += n;
+    }
+
+    if (fdatasync(fd) != 0)
+    {
+        perror("Error: syncing the log");
+        std::exit(EXIT_FAILURE);
+    }
+
+    groups++;
+    bytes += data.size();
+}
+
+template<typename Key>
+void BasicWriteAheadLog<Key>::OpenLog()
+{
+    fd = open(log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+
+    if (fd < 0)
+    {
+        perror("Error: opening the log");
+        std::exit(EXIT_FAILURE);
+    }
+
+    SyncDirectory(log_path);
+}
+
+//Checkpoint file: magic, snapshot timestamp, vertex count, then per vertex its key, property, edge count and edges
+template<typename Key>
+bool BasicWriteAheadLog<Key>::WriteCheckpoint()
+{
+    std::vector<char> data;
+    std::vector<Key> vertices;
+    std::vector<Key> edges;
+
+    uint64_t snapshot = list->BeginSnapshot();
+    list->SnapshotVertices(snapshot, vertices);
+
+    uint32_t vertex_count = vertices.size();
+    data.insert(data.end(), (const char*)&CHECKPOINT_MAGIC, (const char*)&CHECKPOINT_MAGIC + sizeof(uint64_t));
+    data.insert(data.end(), (const char*)&snapshot, (const char*)&snapshot + sizeof(snapshot));
+    data.insert(data.end(), (const char*)&vertex_count, (const char*)&vertex_count + sizeof(vertex_count));
+
+    for (Key vertex : vertices)
+    {
+        list->SnapshotNeighbors(snapshot, vertex, edges);
+
+        const Property* property = list->SnapshotProperty(snapshot, vertex);
+        uint32_t property_size = PropertySize(property);
+        uint32_t edge_count = edges.size();
+        data.insert(data.end(), (const char*)&vertex, (const char*)&vertex + sizeof(vertex));
+        data.insert(data.end(), (const char*)&property_size, (const char*)&property_size + sizeof(property_size));
+
+        if (property != NULL)
+        {
+            data.insert(data.end(), (const char*)property->data, (const char*)property->data + property->size);
+        }
+
+        data.insert(data.end(), (const char*)&edge_count, (const char*)&edge_count + sizeof(edge_count));
+        data.insert(data.end(), (const char*)edges.data(), (const char*)(edges.data() + edge_count));
+    }
+
+    list->EndSnapshot();
+
+    uint32_t checksum = Checksum(data.data(), data.size());
+    data.insert(data.end(), (const char*)&checksum, (const char*)&checksum + sizeof(checksum));
+
+    std::string tmp_path = checkpoint_path + ".tmp";
+    int ckpt_fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (ckpt_fd < 0)
+    {
+        perror("Error: writing the checkpoint");
+        return false;
+    }
+
+    bool ok = write(ckpt_fd, data.data(), data.size()) == (ssize_t)data.size() && fsync(ckpt_fd) == 0;
+    close(ckpt_fd);
+
+    if (!ok || rename(tmp_path.c_str(), checkpoint_path.c_str()) != 0)
+    {
+        perror("Error: writing the checkpoint");
+        return false;
+    }
+
+    SyncDirectory(checkpoint_path);
+
+    return true;
+}
+
+template<typename Key>
+bool BasicWriteAheadLog<Key>::LoadCheckpoint(uint64_t& snapshot)
+{
+    std::vector<char> data;
+    size_t header_size = sizeof(uint64_t) * 2 + sizeof(uint32_t);
+
+    if (!ReadFile(checkpoint_path, data) || data.size() < header_size + sizeof(uint32_t))
+    {
+        printf("Error: cannot read checkpoint %s\n", checkpoint_path.c_str());
+        return false;
+    }
+
+    uint64_t magic;
+    uint32_t checksum;
+    memcpy(&magic, data.data(), sizeof(magic));
+    memcpy(&checksum, data.data() + data.size() - sizeof(checksum), sizeof(checksum));
+
+    if (magic != CHECKPOINT_MAGIC || checksum != Checksum(data.data(), data.size() - sizeof(checksum)))
+    {
+        printf("Error: checkpoint %s is corrupt\n", checkpoint_path.c_str());
+        return false;
+    }
+
+    uint32_t vertex_count;
+    memcpy(&snapshot, data.data() + sizeof(uint64_t), sizeof(snapshot));
+    memcpy(&vertex_count, data.data() + sizeof(uint64_t) * 2, sizeof(vertex_count));
+
+    //Vertices go in before any edge so every edge finds its vertex
+    std::vector<Operator> ops;
+    std::vector<Operator> edge_ops;
+    size_t pos = header_size;
+
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        Key vertex;
+        uint32_t property_size;
+        uint32_t edge_count;
+        memcpy(&vertex, data.data() + pos, sizeof(vertex));
+        memcpy(&property_size, data.data() + pos + sizeof(vertex), sizeof(property_size));
+        pos += sizeof(vertex) + sizeof(property_size);
+
+        const Property* property = LoadProperty(data.data() + pos, property_size);
+        pos += property != NULL ? property_size : 0;
+
+        memcpy(&edge_count, data.data() + pos, sizeof(edge_count));
+        pos += sizeof(edge_count);
+
+        ops.push_back({INSERT, vertex, 0, property});
+        if (ops.size() == RECOVERY_TXN_OPS)
+        {
+            Execute(ops);
+        }
+
+        for (uint32_t e = 0; e < edge_count; e++)
+        {
+            Key edge;
+            memcpy(&edge, data.data() + pos, sizeof(edge));
+            pos += sizeof(edge);
+
+            edge_ops.push_back({INSERT_EDGE, vertex, edge, NULL});
+        }
+    }
+
+    Execute(ops);
+
+    for (size_t i = 0; i < edge_ops.size(); i += RECOVERY_TXN_OPS)
+    {
+        ops.assign(edge_ops.begin() + i, edge_ops.begin() + std::min(edge_ops.size(), i + RECOVERY_TXN_OPS));
+        Execute(ops);
+    }
+
+    return true;
+}
+
+//Reads the records committed after the snapshot, stops at the first torn or corrupt record
+template<typename Key>
+bool BasicWriteAheadLog<Key>::ReadLog(const std::string& path, uint64_t snapshot, std::vector<LogRecord>& log_records)
+{
+    std::vector<char> data;
+
+    if (!ReadFile(path, data))
+    {
+        printf("Error: cannot read log %s\n", path.c_str());
+        return false;
+    }
+
+    size_t pos = 0;
+
+    while (data.size() - pos >= sizeof(RecordHeader))
+    {
+        RecordHeader header;
+        memcpy(&header, data.data() + pos, sizeof(header));
+
+        size_t record_size = sizeof(RecordHeader) + header.op_count * sizeof(RecordOp);
+        uint32_t checksum;
+
+        if (data.size() - pos < record_size + sizeof(checksum))
+        {
+            break;
+        }
+
+        //The property bytes follow the ops, a torn record may hold any sizes so they are only trusted within the data
+        for (uint32_t i = 0; i < header.op_count && record_size <= data.size() - pos; i++)
+        {
+            RecordOp record_op;
+            memcpy(&record_op, data.data() + pos + sizeof(RecordHeader) + i * sizeof(RecordOp), sizeof(record_op));
+            record_size += record_op.property_size != NO_PROPERTY ? record_op.property_size : 0;
+        }
+
+        if (data.size() - pos < record_size + sizeof(checksum))
+        {
+            break;
+        }
+
+        memcpy(&checksum, data.data() + pos + record_size, sizeof(checksum));
+
+        if (checksum != Checksum(data.data() + pos, record_size))
+        {
+            break;
+        }
+
+        if (header.commit_ts > snapshot)
+        {
+            log_records.push_back(LogRecord((uint64_t)header.commit_ts, std::vector<Operator>(header.op_count)));
+            std::vector<Operator>& ops = log_records.back().second;
+
+            size_t property_pos = pos + sizeof(RecordHeader) + header.op_count * sizeof(RecordOp);
+
+            for (uint32_t i = 0; i < header.op_count; i++)
+            {
+                RecordOp record_op;
+                memcpy(&record_op, data.data() + pos + sizeof(RecordHeader) + i * sizeof(RecordOp), sizeof(record_op));
+                ops[i].type = record_op.type;
+                ops[i].key = record_op.key;
+                ops[i].edge_key = record_op.edge_key;
+                ops[i].property = LoadProperty(data.data() + property_pos, record_op.property_size);
+
+                if (ops[i].property != NULL)
+                {
+                    property_pos += record_op.property_size;
+                }
+            }
+        }
+
+        pos += record_size + sizeof(checksum);
+    }
+
+    if (pos < data.size())
+    {
+        printf("Log %s ends with %lu bytes of a torn record, ignoring them\n", path.c_str(), data.size() - pos);
+    }
+
+    return true;
+}
+
+//Runs a recovery transaction, they commit unless the files disagree with each other
+template<typename Key>
+void BasicWriteAheadLog<Key>::Execute(std::vector<Operator>& ops)
+{
+    if (ops.empty())
+    {
+        return;
+    }
+
+    Desc* desc = list->AllocateDesc(ops.size());
+    memcpy(desc->ops, ops.data(), sizeof(Operator) * ops.size());
+
+    if (!list->ExecuteOps(desc))
+    {
+        printf("Warning: a recovered transaction of %lu ops did not apply\n", ops.size());
+    }
+
+    ops.clear();
+}
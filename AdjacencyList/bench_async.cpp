@@ -0,0 +1,302 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "TxnExecutor.h"
+#include "ThreadData.h"
+
+int num_submitters = 4;
+int num_executors = 2;
+int txns_per_submitter = 10000;
+int num_vertices = 1024;
+int window = 64;
+int transaction_size = 4;
+bool skewed = false;
+bool bursty = false;
+bool route_by_key = false;
+bool work_stealing = true;
+bool coroutines = false;
+
+TxnExecutor *executor;
+ThreadData *t_data;
+
+//Submitters never call Init on the list, every transaction runs on an executor thread
+//Each keeps up to window transactions in flight and collects the oldest result once the window is full
+//Skewed submitters put 90% of their ops on 1/16th of the vertices, bursty ones drain their whole window before submitting again
+void *submitTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+    boost::uniform_int<uint32_t> hot_dist(1, std::max(num_vertices / 16, 1));
+    boost::uniform_int<uint32_t> skew_dist(0, 9);
+    boost::uniform_int<uint32_t> type_dist(0, 3);
+
+    std::deque<TxnFuture> in_flight;
+    Operator ops[transaction_size];
+
+    for (int i = 0; i < txns_per_submitter; i++)
+    {
+        for (int t = 0; t < transaction_size; t++)
+        {
+            ops[t].type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+            ops[t].key = skewed && skew_dist(randomGen) != 0 ? hot_dist(randomGen) : vertex_dist(randomGen);
+            ops[t].edge_key = vertex_dist(randomGen);
+        }
+
+        in_flight.push_back(executor->Submit(ops, transaction_size));
+
+        bool drain = bursty && (int)in_flight.size() >= window;
+
+        while ((int)in_flight.size() >= window || ((drain || i == txns_per_submitter - 1) && !in_flight.empty()))
+        {
+            if (in_flight.front().Get())
+            {
+                t_data[id].g_commits++;
+            }
+            else
+            {
+                t_data[id].g_aborts++;
+            }
+
+            in_flight.pop_front();
+        }
+    }
+
+    return NULL;
+}
+
+#if defined(__cpp_impl_coroutine)
+//Coroutine that starts right away and frees its frame when it returns, nothing waits on it
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() { return DetachedTask(); }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+//Counters of the coroutines of one submitter, updated on whichever executor resumed them
+struct CoroutineGroup
+{
+    std::atomic<int> commits{0};
+    std::atomic<int> aborts{0};
+    std::atomic<int> running{0};
+    std::mutex lock;
+    std::condition_variable finished;
+    bool done = false;
+};
+
+//Awaits one transaction at a time, after the first submission it runs and submits from the executor threads
+DetachedTask submitCoroutine(intptr_t seed, int txns, CoroutineGroup* group)
+{
+    boost::mt19937 randomGen;
+    randomGen.seed(seed);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+    boost::uniform_int<uint32_t> hot_dist(1, std::max(num_vertices / 16, 1));
+    boost::uniform_int<uint32_t> skew_dist(0, 9);
+    boost::uniform_int<uint32_t> type_dist(0, 3);
+
+    std::vector<Operator> ops(transaction_size);
+
+    for (int i = 0; i < txns; i++)
+    {
+        for (int t = 0; t < transaction_size; t++)
+        {
+            ops[t].type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+            ops[t].key = skewed && skew_dist(randomGen) != 0 ? hot_dist(randomGen) : vertex_dist(randomGen);
+            ops[t].edge_key = vertex_dist(randomGen);
+        }
+
+        if (co_await executor->Submit(ops.data(), transaction_size))
+        {
+            group->commits++;
+        }
+        else
+        {
+            group->aborts++;
+        }
+    }
+
+    if (group->running.fetch_sub(1) == 1)
+    {
+        std::lock_guard<std::mutex> guard(group->lock);
+        group->done = true;
+        group->finished.notify_one();
+    }
+}
+
+//Window coroutines share the transactions of the submitter, so as many are in flight as in submitTest
+void *coroutineTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+    CoroutineGroup group;
+
+    group.running = window;
+
+    for (int c = 0; c < window; c++)
+    {
+        int txns = txns_per_submitter / window + (c < txns_per_submitter % window ? 1 : 0);
+        submitCoroutine(id * window + c + 1, txns, &group);
+    }
+
+    std::unique_lock<std::mutex> guard(group.lock);
+    group.finished.wait(guard, [&group] { return group.done; });
+
+    t_data[id].g_commits = group.commits;
+    t_data[id].g_aborts = group.aborts;
+
+    return NULL;
+}
+#endif
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 6)
+    {
+        printf("Proper format: %s <#Submitters> <#Executors> <#TxnsPerSubmitter> <#Vertices> <#Window> [<#BatchSize> ...] [--skewed] [--bursty] [--route] [--no-steal]\n", argv[0]);
+        printf("Reports commit throughput of transactions submitted asynchronously for each executor batch size (default 1 8 32)\n");
+        printf("--skewed: concentrate ops on a few hot vertices\n");
+        printf("--bursty: submitters wait for their whole window to finish before submitting again\n");
+        printf("--route: send each transaction to the executor picked by its first vertex\n");
+        printf("--no-steal: disable work stealing between executors\n");
+#if defined(__cpp_impl_coroutine)
+        printf("--coroutine: submit from coroutines that co_await every transaction instead of from a window of futures\n");
+#endif
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_submitters = atoi(argv[1]);
+    num_executors = atoi(argv[2]);
+    txns_per_submitter = atoi(argv[3]);
+    num_vertices = atoi(argv[4]);
+    window = atoi(argv[5]);
+
+    std::vector<int> batch_sizes;
+    for (int a = 6; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--skewed") == 0)
+        {
+            skewed = true;
+        }
+        else if (strcmp(argv[a], "--bursty") == 0)
+        {
+            bursty = true;
+        }
+        else if (strcmp(argv[a], "--route") == 0)
+        {
+            route_by_key = true;
+        }
+        else if (strcmp(argv[a], "--no-steal") == 0)
+        {
+            work_stealing = false;
+        }
+#if defined(__cpp_impl_coroutine)
+        else if (strcmp(argv[a], "--coroutine") == 0)
+        {
+            coroutines = true;
+        }
+#endif
+        else
+        {
+            batch_sizes.push_back(atoi(argv[a]));
+        }
+    }
+    if (batch_sizes.empty())
+    {
+        batch_sizes = {1, 8, 32};
+    }
+
+    printf("Batch Size, Commits/s, Commits, Aborts, Steals, Busiest Executor Share\n");
+
+    for (int batch_size : batch_sizes)
+    {
+        //Routing and stealing can leave any executor running most of the transactions, give each room for all of them
+        int allocator_ops = num_submitters * txns_per_submitter * transaction_size + num_vertices + 1024;
+        AdjacencyList *list = new AdjacencyList(num_executors, transaction_size, allocator_ops);
+
+        ExecutorConfig config;
+        config.batch_size = batch_size;
+        config.route_by_key = route_by_key;
+        config.work_stealing = work_stealing;
+        executor = new TxnExecutor(list, num_executors, config);
+        t_data = new ThreadData[num_submitters];
+
+        std::vector<Operator> populate(num_vertices);
+        for (int v = 0; v < num_vertices; v++)
+        {
+            populate[v].type = INSERT;
+            populate[v].key = v + 1;
+        }
+
+        if (!executor->Submit(populate.data(), num_vertices).Get())
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        struct timespec start, finish;
+        pthread_t threads[num_submitters];
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (intptr_t i = 0; i < num_submitters; i++)
+        {
+#if defined(__cpp_impl_coroutine)
+            pthread_create(&threads[i], NULL, coroutines ? &coroutineTest : &submitTest, (void *)i);
+#else
+            pthread_create(&threads[i], NULL, &submitTest, (void *)i);
+#endif
+        }
+
+        for (int i = 0; i < num_submitters; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+
+        double elapsed = (finish.tv_sec - start.tv_sec);
+        elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+        int g_commits = 0;
+        int g_aborts = 0;
+
+        for (int i = 0; i < num_submitters; i++)
+        {
+            g_commits += t_data[i].g_commits;
+            g_aborts += t_data[i].g_aborts;
+        }
+
+        uint64_t steals = 0;
+        uint64_t executed = 0;
+        uint64_t busiest = 0;
+
+        for (int i = 0; i < executor->Executors(); i++)
+        {
+            ExecutorStats stats = executor->Stats(i);
+            steals += stats.steals;
+            executed += stats.executed;
+            busiest = std::max(busiest, stats.executed);
+        }
+
+        printf("%d, %.0f, %d, %d, %lu, %.2f\n", batch_size, g_commits / elapsed, g_commits, g_aborts, steals, (double)busiest / executed);
+
+        delete executor;
+        delete[] t_data;
+    }
+}
@@ -0,0 +1,314 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+int num_thread = 4;
+int num_vertices = 100000;
+int edges_per_vertex = 32;
+int probes_per_thread = 1000000;
+bool list_mode = false;
+
+//Edges a transaction inserts while populating
+static const uint32_t POPULATE_TXN_OPS = 64;
+
+//Probes handed to SnapshotFindBatch per call, 0 loops over SnapshotFindVertex and SnapshotFindEdge instead
+const size_t batch_sizes[] = {0, 1, 4, 16, 64, 1024};
+
+typedef AdjacencyList::Probe Probe;
+
+struct BatchTest
+{
+    AdjacencyList *list;
+    std::vector<std::vector<uint32_t>> adjacency;
+    size_t batch_size;
+    //Probes of each thread and the answers the looped lookups gave them
+    std::vector<std::vector<Probe>> probes;
+    std::vector<std::vector<bool>> expected;
+    std::vector<uint64_t> found;
+    std::vector<uint64_t> mismatches;
+};
+
+struct ThreadArg
+{
+    BatchTest *test;
+    intptr_t id;
+};
+
+//Every vertex gets edges_per_vertex distinct edges to random keys, the first inline_edges stay inline and the rest go to an MDList
+void generateGraph(std::vector<std::vector<uint32_t>>& adjacency)
+{
+    boost::mt19937 randomGen;
+    randomGen.seed(1);
+    boost::uniform_int<uint32_t> edge_dist(1, 4 * num_vertices);
+
+    adjacency.assign(num_vertices + 1, std::vector<uint32_t>());
+
+    for (int v = 1; v <= num_vertices; v++)
+    {
+        std::vector<uint32_t>& edges = adjacency[v];
+
+        while ((int)edges.size() < edges_per_vertex)
+        {
+            uint32_t edge = edge_dist(randomGen);
+
+            if (std::find(edges.begin(), edges.end(), edge) == edges.end())
+            {
+                edges.push_back(edge);
+            }
+        }
+    }
+}
+
+void *populate(void *arg)
+{
+    BatchTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    for (int v = id + 1; v <= num_vertices; v += num_thread)
+    {
+        for (uint32_t edge : test->adjacency[v])
+        {
+            edges.push_back(std::make_pair(v, edge));
+        }
+    }
+
+    for (size_t i = 0; i < edges.size(); i += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min((size_t)POPULATE_TXN_OPS, edges.size() - i);
+
+        //Threads own the edges of distinct vertices, an abort can only come from helping and is retried
+        while (true)
+        {
+            Desc *desc = list->AllocateDesc(size);
+
+            for (uint32_t t = 0; t < size; t++)
+            {
+                desc->ops[t].type = INSERT_EDGE;
+                desc->ops[t].key = edges[i + t].first;
+                desc->ops[t].edge_key = edges[i + t].second;
+            }
+
+            if (list->ExecuteOps(desc))
+            {
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//Half vertex probes over twice the vertex range, half edge probes of which half hit a stored edge
+void generateProbes(BatchTest& test)
+{
+    test.probes.assign(num_thread, std::vector<Probe>());
+    test.expected.assign(num_thread, std::vector<bool>());
+
+    for (int id = 0; id < num_thread; id++)
+    {
+        boost::mt19937 randomGen;
+        randomGen.seed(id + 2);
+        boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+        boost::uniform_int<uint32_t> absent_dist(1, 2 * num_vertices);
+        boost::uniform_int<uint32_t> edge_dist(1, 4 * num_vertices);
+        boost::uniform_int<uint32_t> slot_dist(0, edges_per_vertex - 1);
+        boost::uniform_int<uint32_t> kind_dist(0, 3);
+
+        std::vector<Probe>& probes = test.probes[id];
+        probes.resize(probes_per_thread);
+
+        for (Probe& probe : probes)
+        {
+            uint32_t kind = kind_dist(randomGen);
+
+            if (kind < 2)
+            {
+                probe.vertex = absent_dist(randomGen);
+                probe.edge = 0;
+                probe.find_edge = false;
+            }
+            else
+            {
+                probe.vertex = vertex_dist(randomGen);
+                probe.edge = kind == 2 ? test.adjacency[probe.vertex][slot_dist(randomGen)] : edge_dist(randomGen);
+                probe.find_edge = true;
+            }
+        }
+    }
+}
+
+//Each thread answers its probes from one snapshot, looped or in batches, and checks them against the looped answers
+void *probeTest(void *arg)
+{
+    BatchTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    std::vector<Probe>& probes = test->probes[id];
+    std::vector<bool>& expected = test->expected[id];
+    bool *found = new bool[probes.size()];
+    uint64_t snapshot = list->BeginSnapshot();
+
+    if (test->batch_size == 0)
+    {
+        for (size_t i = 0; i < probes.size(); i++)
+        {
+            found[i] = !probes[i].find_edge ? list->SnapshotFindVertex(snapshot, probes[i].vertex) : list->SnapshotFindEdge(snapshot, probes[i].vertex, probes[i].edge);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < probes.size(); i += test->batch_size)
+        {
+            list->SnapshotFindBatch(snapshot, probes.data() + i, std::min(test->batch_size, probes.size() - i), found + i);
+        }
+    }
+
+    list->EndSnapshot();
+
+    if (expected.empty())
+    {
+        expected.assign(found, found + probes.size());
+    }
+
+    uint64_t hits = 0;
+    uint64_t mismatches = 0;
+
+    for (size_t i = 0; i < probes.size(); i++)
+    {
+        hits += found[i];
+        mismatches += found[i] != expected[i];
+    }
+
+    test->found[id] = hits;
+    test->mismatches[id] = mismatches;
+    delete[] found;
+
+    return NULL;
+}
+
+//Runs fn on every thread, returns the seconds taken
+double runThreads(BatchTest& test, void *(*fn)(void *))
+{
+    struct timespec start, finish;
+    pthread_t thread[num_thread];
+    ThreadArg args[num_thread];
+
+    test.found.assign(num_thread, 0);
+    test.mismatches.assign(num_thread, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_thread; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&thread[i], NULL, fn, &args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec);
+    elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+    return elapsed;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Threads> <#Vertices> <#EdgesPerVertex> <#ProbesPerThread> [--list]\n", argv[0]);
+        printf("Compares looped snapshot lookups of random vertices and edges against SnapshotFindBatch\n");
+        printf("--list: keep the vertices in the list instead of the dense table\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    num_vertices = atoi(argv[2]);
+    edges_per_vertex = atoi(argv[3]);
+    probes_per_thread = atoi(argv[4]);
+    list_mode = argc > 5 && strcmp(argv[5], "--list") == 0;
+
+    if (num_vertices < 1 || edges_per_vertex < 1)
+    {
+        printf("Error: the graph needs at least one vertex and one edge per vertex\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    BatchTest test;
+    generateGraph(test.adjacency);
+
+    //Every thread inserts about num_vertices * edges_per_vertex / num_thread edges with a pred override each
+    uint64_t edge_count = (uint64_t)num_vertices * edges_per_vertex;
+    int ops = 3 * (edge_count / num_thread + POPULATE_TXN_OPS) + num_vertices;
+    test.list = new AdjacencyList(num_thread + 1, POPULATE_TXN_OPS, ops, list_mode ? 0 : num_vertices + 1);
+
+    test.list->Init();
+
+    for (int v = 1; v <= num_vertices; v += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min(POPULATE_TXN_OPS, (uint32_t)(num_vertices - v + 1));
+        Desc *desc = test.list->AllocateDesc(size);
+
+        for (uint32_t t = 0; t < size; t++)
+        {
+            desc->ops[t].type = INSERT;
+            desc->ops[t].key = v + t;
+        }
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    double elapsed = runThreads(test, &populate);
+    printf("Populated %d vertices and %lu edges in %.2fs\n\n", num_vertices, edge_count, elapsed);
+
+    generateProbes(test);
+
+    //The looped run goes first and records the answers every batched run is checked against
+    printf("BatchSize, Probes/s, Found, Mismatches\n");
+
+    for (size_t batch_size : batch_sizes)
+    {
+        test.batch_size = batch_size;
+        elapsed = runThreads(test, &probeTest);
+
+        uint64_t found = 0;
+        uint64_t mismatches = 0;
+
+        for (int i = 0; i < num_thread; i++)
+        {
+            found += test.found[i];
+            mismatches += test.mismatches[i];
+        }
+
+        if (batch_size == 0)
+        {
+            printf("loop, ");
+        }
+        else
+        {
+            printf("%lu, ", batch_size);
+        }
+
+        printf("%.0f, %lu, %lu\n", (double)num_thread * probes_per_thread / elapsed, found, mismatches);
+    }
+}
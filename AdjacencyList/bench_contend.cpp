@@ -0,0 +1,195 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+//Defaults that lost edges on one core before FinishPendingTxn helped InsertEdge's pred overrides from the op itself
+int num_thread = 8;
+int keys_per_thread = 20;
+int txns_per_thread = 60000;
+
+//Every edge goes to this vertex, so all transactions meet on the preds of one mdlist
+static const uint32_t HUB = 1;
+
+struct ContendTest
+{
+    AdjacencyList *list;
+    //Edges each thread holds after its committed transactions, and its committed and failed transactions
+    std::vector<std::vector<uint32_t>> held;
+    std::vector<uint64_t> commits;
+    std::vector<uint64_t> failed;
+};
+
+struct ThreadArg
+{
+    ContendTest *test;
+    intptr_t id;
+};
+
+//The i-th edge key of a thread, no two threads share one
+uint32_t edgeKey(intptr_t id, uint32_t i)
+{
+    return 1 + id + i * num_thread;
+}
+
+//Each transaction toggles two edges of the thread, inserting the absent and deleting the present one
+//No other thread writes them, a transaction only aborts when helping runs in a cycle and then leaves both edges as they were
+void *contendTest(void *arg)
+{
+    ContendTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> key_dist(0, keys_per_thread - 1);
+
+    std::vector<bool> held(keys_per_thread, false);
+    uint64_t commits = 0;
+    uint64_t failed = 0;
+
+    for (int t = 0; t < txns_per_thread; t++)
+    {
+        uint32_t keys[2] = {key_dist(randomGen), key_dist(randomGen)};
+
+        if (keys[0] == keys[1])
+        {
+            continue;
+        }
+
+        Desc *desc = list->AllocateDesc(2);
+
+        for (int i = 0; i < 2; i++)
+        {
+            desc->ops[i].type = held[keys[i]] ? DELETE_EDGE : INSERT_EDGE;
+            desc->ops[i].key = HUB;
+            desc->ops[i].edge_key = edgeKey(id, keys[i]);
+        }
+
+        if (list->ExecuteOps(desc))
+        {
+            held[keys[0]] = !held[keys[0]];
+            held[keys[1]] = !held[keys[1]];
+            commits++;
+        }
+        else
+        {
+            failed++;
+        }
+    }
+
+    for (int i = 0; i < keys_per_thread; i++)
+    {
+        if (held[i])
+        {
+            test->held[id].push_back(edgeKey(id, i));
+        }
+    }
+
+    test->commits[id] = commits;
+    test->failed[id] = failed;
+
+    return NULL;
+}
+
+void usage(const char *name)
+{
+    printf("Proper format: %s [<#Threads> <#KeysPerThread> <#TxnsPerThread>]\n", name);
+    printf("Runs two-edge transactions of every thread on the mdlist of one vertex, each thread toggling edges of its own\n");
+    printf("Fails if the edges of the vertex differ from what the threads committed\n");
+    std::exit(EXIT_FAILURE);
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc > 1 && (argc != 4 || !isdigit(argv[1][0])))
+    {
+        usage(argv[0]);
+    }
+
+    if (argc == 4)
+    {
+        num_thread = atoi(argv[1]);
+        keys_per_thread = atoi(argv[2]);
+        txns_per_thread = atoi(argv[3]);
+    }
+
+    //A transaction takes a node, descriptors and a pred override per op, the hub needs its own
+    ContendTest test;
+    test.list = new AdjacencyList(num_thread + 1, 2, 6 * txns_per_thread + 10);
+    test.held.assign(num_thread, std::vector<uint32_t>());
+    test.commits.assign(num_thread, 0);
+    test.failed.assign(num_thread, 0);
+
+    test.list->Init();
+    Desc *desc = test.list->AllocateDesc(1);
+    desc->ops[0].type = INSERT;
+    desc->ops[0].key = HUB;
+
+    if (!test.list->ExecuteOps(desc))
+    {
+        printf("Error: inserting the vertex failed\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    struct timespec start, finish;
+    pthread_t thread[num_thread];
+    ThreadArg args[num_thread];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&thread[i], NULL, &contendTest, &args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec);
+    elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+    std::vector<uint32_t> expected;
+    uint64_t commits = 0;
+    uint64_t failed = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        expected.insert(expected.end(), test.held[i].begin(), test.held[i].end());
+        commits += test.commits[i];
+        failed += test.failed[i];
+    }
+
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<uint32_t> edges;
+    uint64_t snapshot = test.list->BeginSnapshot();
+    test.list->SnapshotNeighbors(snapshot, HUB, edges);
+    test.list->EndSnapshot();
+
+    std::vector<uint32_t> missing;
+    std::vector<uint32_t> extra;
+    std::set_difference(expected.begin(), expected.end(), edges.begin(), edges.end(), std::back_inserter(missing));
+    std::set_difference(edges.begin(), edges.end(), expected.begin(), expected.end(), std::back_inserter(extra));
+
+    printf("Commits/s, Commits, Failed, Edges, Missing, Extra\n");
+    printf("%.0f, %lu, %lu, %zu, %zu, %zu\n", commits / elapsed, commits, failed, expected.size(), missing.size(), extra.size());
+
+    if (!missing.empty() || !extra.empty())
+    {
+        printf("Error: the edges of the vertex differ from what the threads committed\n");
+        std::exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,296 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <vector>
+#include <sched.h>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "ChangeFeed.h"
+#include "ThreadData.h"
+
+enum FeedMode
+{
+    FEED_OFF = 0,
+    FEED_IDLE,
+    FEED_FOLLOW
+};
+
+const char* mode_names[] = {"off", "idle", "follow"};
+
+int num_writers = 4;
+int num_consumers = 1;
+int txns_per_writer = 100000;
+int num_vertices = 256;
+uint32_t feed_capacity = 1 << 16;
+
+AdjacencyList *list;
+ChangeFeed *feed;
+ThreadData *t_data;
+volatile int writers_done = 0;
+
+struct __attribute__((aligned(64))) ConsumerData
+{
+    ChangeFeed::Cursor *cursor;
+    uint64_t changes = 0;
+    uint64_t lost = 0;
+    uint64_t max_lag = 0;
+    //Edges of the graph rebuilt from the feed alone
+    std::set<std::pair<uint32_t, uint32_t>> mirror;
+};
+
+ConsumerData *c_data;
+
+//Random edge inserts and deletes in pairs, every committed insert added an absent edge and every delete removed a present one
+void *writerTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+    boost::uniform_int<uint32_t> edge_dist(1, 64);
+    boost::uniform_int<uint32_t> type_dist(0, 1);
+
+    for (int i = 0; i < txns_per_writer; i++)
+    {
+        Desc *desc = list->AllocateDesc(2);
+
+        for (int t = 0; t < 2; t++)
+        {
+            desc->ops[t].type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+            desc->ops[t].key = vertex_dist(randomGen);
+            desc->ops[t].edge_key = edge_dist(randomGen);
+        }
+
+        if (list->ExecuteOps(desc))
+        {
+            t_data[id].g_commits++;
+        }
+        else
+        {
+            t_data[id].g_aborts++;
+        }
+    }
+
+    __sync_fetch_and_add(&writers_done, 1);
+
+    return NULL;
+}
+
+//Applies every change to its mirror in commit order until the writers are done and the feed is drained
+void *consumerTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+    ConsumerData& data = c_data[id];
+    ChangeFeed::Change change;
+
+    while (true)
+    {
+        ChangeFeed::ReadStatus status = data.cursor->Next(change);
+
+        if (status == ChangeFeed::FEED_CHANGE)
+        {
+            for (uint32_t i = 0; i < change.size; i++)
+            {
+                const Operator& op = change.ops[i];
+
+                if (op.type == INSERT_EDGE)
+                {
+                    data.mirror.insert(std::make_pair(op.key, op.edge_key));
+                }
+                else if (op.type == DELETE_EDGE)
+                {
+                    data.mirror.erase(std::make_pair(op.key, op.edge_key));
+                }
+            }
+
+            data.changes++;
+        }
+        else if (status == ChangeFeed::FEED_EMPTY)
+        {
+            //Every value drawn from the clock is published once the writers are done, a lag left then is still in the ring
+            if (writers_done == num_writers && data.cursor->Lag() == 0)
+            {
+                break;
+            }
+
+            sched_yield();
+        }
+
+        data.max_lag = std::max(data.max_lag, data.cursor->Lag());
+    }
+
+    data.lost = data.cursor->lost;
+
+    return NULL;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 6)
+    {
+        printf("Proper format: %s <#Writers> <#Consumers> <#TxnsPerWriter> <#Vertices> <#FeedCapacity> [off|idle|follow ...]\n", argv[0]);
+        printf("Measures writer throughput without a change feed, with an unsubscribed one and with consumers following it (default all modes)\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_writers = atoi(argv[1]);
+    num_consumers = atoi(argv[2]);
+    txns_per_writer = atoi(argv[3]);
+    num_vertices = atoi(argv[4]);
+    feed_capacity = atoi(argv[5]);
+
+    std::vector<FeedMode> modes;
+    for (int a = 6; a < argc; a++)
+    {
+        if (strcmp(argv[a], "off") == 0)
+        {
+            modes.push_back(FEED_OFF);
+        }
+        else if (strcmp(argv[a], "idle") == 0)
+        {
+            modes.push_back(FEED_IDLE);
+        }
+        else if (strcmp(argv[a], "follow") == 0)
+        {
+            modes.push_back(FEED_FOLLOW);
+        }
+        else
+        {
+            printf("Unknown mode %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (modes.empty())
+    {
+        modes = {FEED_OFF, FEED_IDLE, FEED_FOLLOW};
+    }
+
+    printf("Mode, Commits/s, Commits, Aborts, Changes, Lost, MaxLag, Mirror\n");
+
+    for (FeedMode mode : modes)
+    {
+        int consumers = mode == FEED_FOLLOW ? num_consumers : 0;
+
+        list = new AdjacencyList(num_writers + 1, 2, 8 * std::max(txns_per_writer, num_vertices), num_vertices + 1);
+        feed = mode == FEED_OFF ? NULL : new ChangeFeed(list, feed_capacity);
+
+        if (feed != NULL && !feed->Attach())
+        {
+            printf("Error: the feed cannot attach to the list\n");
+            std::exit(EXIT_FAILURE);
+        }
+        t_data = new ThreadData[num_writers];
+        c_data = new ConsumerData[consumers];
+        writers_done = 0;
+
+        list->Init();
+
+        Desc *desc = list->AllocateDesc(num_vertices);
+        for (int v = 0; v < num_vertices; v++)
+        {
+            desc->ops[v].type = INSERT;
+            desc->ops[v].key = v + 1;
+        }
+
+        if (!list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        //Subscribed after the vertices went in, the mirrors start from a graph without edges
+        for (int i = 0; i < consumers; i++)
+        {
+            c_data[i].cursor = feed->Subscribe();
+        }
+
+        struct timespec start, finish;
+        pthread_t writers[num_writers];
+        pthread_t consumer_threads[consumers];
+
+        for (intptr_t i = 0; i < consumers; i++)
+        {
+            pthread_create(&consumer_threads[i], NULL, &consumerTest, (void *)i);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (intptr_t i = 0; i < num_writers; i++)
+        {
+            pthread_create(&writers[i], NULL, &writerTest, (void *)i);
+        }
+
+        for (int i = 0; i < num_writers; i++)
+        {
+            pthread_join(writers[i], NULL);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+
+        for (int i = 0; i < consumers; i++)
+        {
+            pthread_join(consumer_threads[i], NULL);
+        }
+
+        double elapsed = (finish.tv_sec - start.tv_sec);
+        elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+        int g_commits = 0;
+        int g_aborts = 0;
+
+        for (int i = 0; i < num_writers; i++)
+        {
+            g_commits += t_data[i].g_commits;
+            g_aborts += t_data[i].g_aborts;
+        }
+
+        //A mirror that lost no records must hold exactly the edges of the graph
+        std::set<std::pair<uint32_t, uint32_t>> graph;
+        uint64_t snapshot = list->BeginSnapshot();
+        std::vector<uint32_t> edges;
+
+        for (int v = 1; v <= num_vertices; v++)
+        {
+            list->SnapshotNeighbors(snapshot, v, edges);
+
+            for (uint32_t edge : edges)
+            {
+                graph.insert(std::make_pair(v, edge));
+            }
+        }
+
+        list->EndSnapshot();
+
+        uint64_t changes = 0;
+        uint64_t lost = 0;
+        uint64_t max_lag = 0;
+        const char* mirror = consumers > 0 ? "match" : "-";
+
+        for (int i = 0; i < consumers; i++)
+        {
+            changes += c_data[i].changes;
+            lost += c_data[i].lost;
+            max_lag = std::max(max_lag, c_data[i].max_lag);
+
+            if (c_data[i].lost > 0)
+            {
+                mirror = "overrun";
+            }
+            else if (c_data[i].mirror != graph)
+            {
+                mirror = "mismatch";
+                break;
+            }
+        }
+
+        printf("%s, %.0f, %d, %d, %lu, %lu, %lu, %s\n", mode_names[mode], g_commits / elapsed, g_commits, g_aborts, changes, lost, max_lag, mirror);
+
+        delete[] t_data;
+        delete[] c_data;
+    }
+}
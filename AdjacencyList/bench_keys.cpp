@@ -0,0 +1,238 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "ThreadData.h"
+
+int num_thread = 4;
+int vertices_per_thread = 1000;
+int edges_per_vertex = 16;
+
+ThreadData *t_data;
+
+//Bijective finalizers of MurmurHash3, distinct ids stay distinct keys spread over the whole key range and only 0 maps to 0
+uint32_t Mix(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+uint64_t Mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+template<typename Key>
+struct KeyTest
+{
+    BasicAdjacencyList<Key> *list;
+    //Edges each vertex should hold at the end, by owning thread
+    std::vector<std::vector<std::pair<Key, std::vector<Key>>>> expected;
+};
+
+template<typename Key>
+bool Execute(BasicAdjacencyList<Key> *list, uint8_t type, Key key, Key edge_key, intptr_t id)
+{
+    BasicDesc<Key> *desc = list->AllocateDesc(1);
+    desc->ops[0].type = type;
+    desc->ops[0].key = key;
+    desc->ops[0].edge_key = edge_key;
+
+    bool committed = list->ExecuteOps(desc);
+
+    if (committed)
+    {
+        t_data[id].g_commits++;
+    }
+    else
+    {
+        t_data[id].g_aborts++;
+    }
+
+    return committed;
+}
+
+//Each thread owns its vertices, inserts an edge to 0 and edges to hashed keys into them and deletes every fourth one again
+//Nothing conflicts, so every transaction is expected to commit and the final graph is known
+template<typename Key>
+void *keyTest(void *arg)
+{
+    KeyTest<Key> *test = (KeyTest<Key> *)((void **)arg)[0];
+    intptr_t id = (intptr_t)((void **)arg)[1];
+    BasicAdjacencyList<Key> *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint64_t> id_dist(1, std::numeric_limits<Key>::max());
+
+    for (int v = 0; v < vertices_per_thread; v++)
+    {
+        Key vertex = Mix((Key)(id * vertices_per_thread + v + 1));
+        std::vector<Key> edges;
+        std::vector<Key> kept;
+
+        Execute<Key>(list, INSERT, vertex, 0, id);
+
+        if (Execute<Key>(list, INSERT_EDGE, vertex, 0, id))
+        {
+            edges.push_back(0);
+        }
+
+        for (int e = 0; e < edges_per_vertex; e++)
+        {
+            Key edge = Mix((Key)id_dist(randomGen));
+
+            if (std::find(edges.begin(), edges.end(), edge) == edges.end() && Execute<Key>(list, INSERT_EDGE, vertex, edge, id))
+            {
+                edges.push_back(edge);
+            }
+        }
+
+        //Edge 0 is deleted from every fourth vertex
+        for (size_t e = 0; e < edges.size(); e++)
+        {
+            if ((e + v) % 4 != 0 || !Execute<Key>(list, DELETE_EDGE, vertex, edges[e], id))
+            {
+                kept.push_back(edges[e]);
+            }
+        }
+
+        std::sort(kept.begin(), kept.end());
+        test->expected[id].push_back(std::make_pair(vertex, kept));
+    }
+
+    return NULL;
+}
+
+template<typename Key>
+void runTest()
+{
+    KeyTest<Key> test;
+    test.list = new BasicAdjacencyList<Key>(num_thread + 1, 1, 4 * vertices_per_thread * (edges_per_vertex + 2));
+    test.expected.resize(num_thread);
+    t_data = new ThreadData[num_thread];
+
+    //The smallest and largest keys are vertices like any other, with edges to the smallest and largest key
+    //A transaction does not see its own vertex inserts, the edges go in a second one
+    test.list->Init();
+    Key extremes[2] = {0, std::numeric_limits<Key>::max()};
+    uint8_t types[2] = {INSERT, INSERT_EDGE};
+
+    for (uint8_t type : types)
+    {
+        BasicDesc<Key> *desc = test.list->AllocateDesc(type == INSERT ? 2 : 4);
+
+        for (uint32_t i = 0; i < desc->size; i++)
+        {
+            desc->ops[i].type = type;
+            desc->ops[i].key = extremes[i % 2];
+            desc->ops[i].edge_key = extremes[i / 2];
+        }
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: inserting the extreme keys failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    struct timespec start, finish;
+    pthread_t thread[num_thread];
+    void *args[num_thread][2];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_thread; i++)
+    {
+        args[i][0] = &test;
+        args[i][1] = (void *)i;
+        pthread_create(&thread[i], NULL, &keyTest<Key>, args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec);
+    elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+    int g_commits = 0;
+    int g_aborts = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        g_commits += t_data[i].g_commits;
+        g_aborts += t_data[i].g_aborts;
+    }
+
+    //Compare the graph to what the threads committed
+    uint64_t snapshot = test.list->BeginSnapshot();
+    std::vector<Key> edges;
+    std::vector<Key> vertices;
+    bool match = true;
+    size_t vertex_count = 2;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        for (auto& vertex : test.expected[i])
+        {
+            match = match && test.list->SnapshotNeighbors(snapshot, vertex.first, edges) && edges == vertex.second;
+        }
+
+        vertex_count += test.expected[i].size();
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        match = match && test.list->SnapshotNeighbors(snapshot, extremes[i], edges) && edges == std::vector<Key>(extremes, extremes + 2);
+    }
+
+    test.list->SnapshotVertices(snapshot, vertices);
+    match = match && vertices.size() == vertex_count && vertices.front() == extremes[0] && vertices.back() == extremes[1];
+    test.list->EndSnapshot();
+
+    printf("%lu, %.0f, %d, %d, %s\n", sizeof(Key) * 8, g_commits / elapsed, g_commits, g_aborts, match ? "match" : "mismatch");
+
+    delete[] t_data;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 3)
+    {
+        printf("Proper format: %s <#Threads> <#VerticesPerThread> [<#EdgesPerVertex>]\n", argv[0]);
+        printf("Runs the same workload on hashed 32-bit and 64-bit keys and checks the resulting graphs\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    vertices_per_thread = atoi(argv[2]);
+
+    if (argc > 3)
+    {
+        edges_per_vertex = atoi(argv[3]);
+    }
+
+    printf("KeyBits, Commits/s, Commits, Aborts, Graph\n");
+
+    runTest<uint32_t>();
+    runTest<uint64_t>();
+}
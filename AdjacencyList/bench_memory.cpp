@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+//MDNode layout with full width pointer children and stored coordinates, for comparison
+struct FullWidthMDNode
+{
+    MDNode* m_child[MDList::DIMENSION];
+    uint8_t m_coord[MDList::DIMENSION];
+    uint32_t m_key;
+    MDDesc* m_pending;
+    NodeDesc* node_desc;
+};
+
+AdjacencyList *list;
+
+bool executeOp(uint8_t type, uint32_t key, uint32_t edge_key)
+{
+    Desc *desc = list->AllocateDesc(1);
+
+    desc->ops[0].type = type;
+    desc->ops[0].key = key;
+    desc->ops[0].edge_key = edge_key;
+
+    return list->ExecuteOps(desc);
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 4)
+    {
+        printf("Proper format: %s <#Vertices> <#EdgesPerVertex> <#KeyRange> [<#DeletePercent>]\n", argv[0]);
+        printf("DeletePercent: share of the edges and then of the vertices deleted before the live objects are sampled\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    int num_vertices = atoi(argv[1]);
+    int edges_per_vertex = atoi(argv[2]);
+    uint32_t key_range = atoi(argv[3]);
+    int delete_percent = argc > 4 ? atoi(argv[4]) : 0;
+
+    if ((uint32_t)edges_per_vertex > key_range)
+    {
+        printf("Error, more edges per vertex than keys in the range\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    uint64_t edges = (uint64_t)num_vertices * edges_per_vertex;
+    list = new AdjacencyList(1, 1, 4 * (num_vertices + edges));
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(1);
+    boost::uniform_int<uint32_t> key_dist(1, key_range);
+
+    for (int v = 1; v <= num_vertices; v++)
+    {
+        executeOp(INSERT, v, 0);
+    }
+
+    printf("Vertex bytes %.1f\n", (double)list->node_allocator->used() / num_vertices);
+
+    uint64_t mdlist_bytes = list->mdlist_allocator->used();
+    uint64_t mdnode_bytes = list->mdnode_allocator->used();
+    uint64_t mddesc_bytes = list->mddesc_allocator->used();
+    uint64_t ndesc_bytes = list->ndesc_allocator->used();
+    uint64_t desc_bytes = list->desc_allocator->used();
+
+    std::vector<std::pair<uint32_t, uint32_t>> inserted;
+
+    for (int v = 1; v <= num_vertices; v++)
+    {
+        for (int e = 0; e < edges_per_vertex; )
+        {
+            uint32_t edge = key_dist(randomGen);
+
+            if (executeOp(INSERT_EDGE, v, edge))
+            {
+                inserted.push_back(std::make_pair(v, edge));
+                e++;
+            }
+        }
+    }
+
+    mdlist_bytes = list->mdlist_allocator->used() - mdlist_bytes;
+    mdnode_bytes = list->mdnode_allocator->used() - mdnode_bytes;
+    mddesc_bytes = list->mddesc_allocator->used() - mddesc_bytes;
+    ndesc_bytes = list->ndesc_allocator->used() - ndesc_bytes;
+    desc_bytes = list->desc_allocator->used() - desc_bytes;
+
+    printf("Edges: %lu\n", edges);
+    printf("MDList bytes/edge %.1f\n", (double)mdlist_bytes / edges);
+    printf("MDNode bytes/edge %.1f (full width layout: %lu)\n", (double)mdnode_bytes / edges, sizeof(FullWidthMDNode));
+    printf("MDDesc bytes/edge %.1f\n", (double)mddesc_bytes / edges);
+    printf("NodeDesc bytes/edge %.1f\n", (double)ndesc_bytes / edges);
+    printf("Desc bytes/edge %.1f\n", (double)desc_bytes / edges);
+    printf("Total bytes/edge %.1f\n", (double)(mdlist_bytes + mdnode_bytes + mddesc_bytes + ndesc_bytes + desc_bytes) / edges);
+
+    boost::uniform_int<uint32_t> percent_dist(0, 99);
+
+    for (size_t i = 0; i < inserted.size(); i++)
+    {
+        if (percent_dist(randomGen) < (uint32_t)delete_percent)
+        {
+            executeOp(DELETE_EDGE, inserted[i].first, inserted[i].second);
+        }
+    }
+
+    for (int v = 1; v <= num_vertices; v++)
+    {
+        if (percent_dist(randomGen) < (uint32_t)delete_percent)
+        {
+            executeOp(DELETE, v, 0);
+        }
+    }
+
+    std::vector<AdjacencyList::AllocatorStats> allocators;
+    list->MemoryUsage(allocators);
+
+    printf("\nAllocator, Reserved, Handed out, Per thread\n");
+    for (const AdjacencyList::AllocatorStats& allocator : allocators)
+    {
+        printf("%s, %lu, %lu,", allocator.name, allocator.reserved, allocator.handed_out);
+        for (uint64_t bytes : allocator.thread_handed_out)
+        {
+            printf(" %lu", bytes);
+        }
+        printf("\n");
+    }
+
+    AdjacencyList::LivenessStats liveness;
+    list->SampleLiveness(16, liveness);
+
+    printf("\nVertices live %lu, dead %lu\n", liveness.live_vertices, liveness.dead_vertices);
+    printf("Edges live %lu, dead %lu (from %lu of %lu vertex nodes)\n", liveness.live_edges, liveness.dead_edges,
+        liveness.sampled_vertex_nodes, liveness.vertex_nodes);
+    printf("MDNodes %lu, marked %lu, pending adoptions %lu\n", liveness.md_nodes, liveness.marked_md_nodes, liveness.pending_adoptions);
+    printf("NodeDescs installed %lu, older versions %lu, handed out %lu\n", liveness.node_descs, liveness.chained_versions,
+        list->ndesc_allocator->total_used() / sizeof(NodeDesc));
+}
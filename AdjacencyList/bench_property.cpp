@@ -0,0 +1,330 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+int num_thread = 4;
+int num_vertices = 100000;
+int reads_per_thread = 1000000;
+uint32_t property_bytes = 64;
+bool dense = false;
+
+//Vertices a transaction inserts while populating
+static const uint32_t POPULATE_TXN_OPS = 64;
+
+//Reads between two snapshots
+static const int READS_PER_SNAPSHOT = 1024;
+
+//A property holds its vertex key, its version, then a byte derived from both repeated, so a read can tell whether it is whole
+void fillProperty(std::vector<uint8_t>& bytes, uint32_t vertex, uint32_t version)
+{
+    bytes.assign(property_bytes, (uint8_t)(vertex * 31 + version));
+    memcpy(bytes.data(), &vertex, sizeof(vertex));
+    memcpy(bytes.data() + sizeof(vertex), &version, sizeof(version));
+}
+
+bool wholeProperty(const uint8_t* data, uint32_t size, uint32_t vertex)
+{
+    uint32_t key;
+    uint32_t version;
+    memcpy(&key, data, sizeof(key));
+    memcpy(&version, data + sizeof(key), sizeof(version));
+
+    if (size != property_bytes || key != vertex)
+    {
+        return false;
+    }
+
+    for (uint32_t i = sizeof(key) + sizeof(version); i < size; i++)
+    {
+        if (data[i] != (uint8_t)(vertex * 31 + version))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+enum Mode
+{
+    EXTERNAL = 0,
+    INLINE,
+    UPDATE
+};
+
+const char* mode_names[] = {"external", "inline", "update"};
+
+struct PropertyTest
+{
+    AdjacencyList *list;
+    //Properties kept beside the graph, keyed by vertex like a separate attribute store would
+    std::unordered_map<uint32_t, std::vector<uint8_t>> store;
+    Mode mode;
+    int updaters;
+    std::vector<uint64_t> reads;
+    std::vector<uint64_t> sets;
+    std::vector<uint64_t> torn;
+    std::vector<uint64_t> checksums;
+};
+
+struct ThreadArg
+{
+    PropertyTest *test;
+    intptr_t id;
+};
+
+void *readerTest(void *arg)
+{
+    PropertyTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+
+    uint64_t checksum = 0;
+    uint64_t torn = 0;
+    uint64_t snapshot = 0;
+
+    for (int i = 0; i < reads_per_thread; i++)
+    {
+        if (i % READS_PER_SNAPSHOT == 0)
+        {
+            if (i > 0)
+            {
+                list->EndSnapshot();
+            }
+
+            snapshot = list->BeginSnapshot();
+        }
+
+        uint32_t vertex = vertex_dist(randomGen);
+        const uint8_t* data = NULL;
+        uint32_t size = 0;
+
+        if (test->mode == EXTERNAL)
+        {
+            //The graph answers whether the vertex is there, the store holds what it carries
+            if (list->SnapshotFindVertex(snapshot, vertex))
+            {
+                const std::vector<uint8_t>& bytes = test->store.find(vertex)->second;
+                data = bytes.data();
+                size = bytes.size();
+            }
+        }
+        else
+        {
+            const Property* property = list->SnapshotProperty(snapshot, vertex);
+
+            if (property != NULL)
+            {
+                data = property->data;
+                size = property->size;
+            }
+        }
+
+        if (data == NULL)
+        {
+            torn++;
+            continue;
+        }
+
+        if (test->mode == UPDATE)
+        {
+            torn += !wholeProperty(data, size, vertex);
+        }
+
+        checksum += data[size - 1];
+    }
+
+    list->EndSnapshot();
+
+    test->reads[id] = reads_per_thread;
+    test->torn[id] = torn;
+    test->checksums[id] = checksum;
+
+    return NULL;
+}
+
+//Replaces the properties of random vertices, one SET_PROPERTY per transaction, every thread counting its own versions
+void *updaterTest(void *arg)
+{
+    PropertyTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+
+    std::vector<uint8_t> bytes;
+    uint64_t sets = 0;
+
+    for (int i = 0; i < reads_per_thread / 16; i++)
+    {
+        uint32_t vertex = vertex_dist(randomGen);
+        fillProperty(bytes, vertex, id * reads_per_thread + i + 1);
+
+        Desc *desc = list->AllocateDesc(1);
+        desc->ops[0].type = SET_PROPERTY;
+        desc->ops[0].key = vertex;
+        desc->ops[0].edge_key = 0;
+        desc->ops[0].property = list->NewProperty(bytes.data(), bytes.size());
+
+        sets += list->ExecuteOps(desc);
+    }
+
+    test->sets[id] = sets;
+
+    return NULL;
+}
+
+//The properties arrive with their vertices, each INSERT of a transaction carries its own
+void populate(PropertyTest &test)
+{
+    std::vector<uint8_t> bytes;
+
+    for (int v = 1; v <= num_vertices; v += POPULATE_TXN_OPS)
+    {
+        uint32_t count = std::min<int>(POPULATE_TXN_OPS, num_vertices - v + 1);
+        Desc *desc = test.list->AllocateDesc(count);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            fillProperty(bytes, v + i, 0);
+            desc->ops[i].type = INSERT;
+            desc->ops[i].key = v + i;
+            desc->ops[i].edge_key = 0;
+            desc->ops[i].property = test.list->NewProperty(bytes.data(), bytes.size());
+            test.store[v + i] = bytes;
+        }
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void runTest(Mode mode)
+{
+    //Every thread may set a property per op, the arena is sized for property_room bytes per op
+    uint64_t property_share = Property::Units(property_bytes) / Property::Units(AdjacencyList::property_room) + 1;
+    int ops = (num_vertices + reads_per_thread / 16) * property_share + num_vertices;
+
+    PropertyTest test;
+    test.list = new AdjacencyList(num_thread + 1, POPULATE_TXN_OPS, ops, dense ? num_vertices + 1 : 0);
+    test.mode = mode;
+    test.updaters = mode == UPDATE ? std::max(1, num_thread / 2) : 0;
+    test.reads.assign(num_thread, 0);
+    test.sets.assign(num_thread, 0);
+    test.torn.assign(num_thread, 0);
+    test.checksums.assign(num_thread, 0);
+
+    test.list->Init();
+    populate(test);
+
+    struct timespec start, finish;
+    pthread_t threads[num_thread];
+    ThreadArg args[num_thread];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_thread; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, i < test.updaters ? &updaterTest : &readerTest, &args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+    uint64_t reads = 0;
+    uint64_t sets = 0;
+    uint64_t torn = 0;
+    uint64_t checksum = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        reads += test.reads[i];
+        sets += test.sets[i];
+        torn += test.torn[i];
+        checksum += test.checksums[i];
+    }
+
+    printf("%s, %.0f, %.0f, %lu, %lu\n", mode_names[mode], reads / elapsed, sets / elapsed, torn, checksum);
+
+    delete test.list;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Threads> <#Vertices> <#ReadsPerThread> <#PropertyBytes> [external|inline|update ...] [--dense]\n", argv[0]);
+        printf("Reads the properties of random vertices kept in a map beside the graph and kept in the graph (default both)\n");
+        printf("update: half the threads replace properties while the others read and check them\n");
+        printf("--dense: map the vertex keys through a direct table\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    num_vertices = atoi(argv[2]);
+    reads_per_thread = atoi(argv[3]);
+    property_bytes = std::max(atoi(argv[4]), 9);
+
+    std::vector<Mode> modes;
+
+    for (int a = 5; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--dense") == 0)
+        {
+            dense = true;
+            continue;
+        }
+
+        size_t m = 0;
+        while (m < sizeof(mode_names) / sizeof(mode_names[0]) && strcmp(argv[a], mode_names[m]) != 0)
+        {
+            m++;
+        }
+
+        if (m == sizeof(mode_names) / sizeof(mode_names[0]))
+        {
+            printf("Unknown mode %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+
+        modes.push_back((Mode)m);
+    }
+
+    if (modes.empty())
+    {
+        modes = {EXTERNAL, INLINE};
+    }
+
+    printf("Mode, Reads/s, Sets/s, Missing or torn, Checksum\n");
+
+    for (Mode mode : modes)
+    {
+        runTest(mode);
+    }
+}
@@ -0,0 +1,424 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+int num_thread = 4;
+int num_vertices = 100000;
+int edges_per_vertex = 32;
+bool list_mode = false;
+bool churn = false;
+bool looped = true;
+
+//Edges a transaction inserts while populating
+static const uint32_t POPULATE_TXN_OPS = 64;
+
+//Ranges per scan worker, more ranges even out workers that draw slower ones
+static const uint32_t RANGES_PER_WORKER = 4;
+
+//Edges the churn thread gives a vertex it inserts again
+static const uint32_t CHURN_EDGES = 4;
+
+typedef AdjacencyList::ScanRange ScanRange;
+
+uint64_t mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return x;
+}
+
+//Order independent, so ranges scanned by different workers add up to the checksum of one scan of everything
+struct ScanResult
+{
+    uint64_t vertices = 0;
+    uint64_t edges = 0;
+    uint64_t checksum = 0;
+    //Vertices a range reported at or below the one before, any would be a duplicate or a lost order
+    uint64_t out_of_order = 0;
+
+    void add(uint32_t vertex, const std::vector<uint32_t>& adjacency)
+    {
+        vertices++;
+        edges += adjacency.size();
+        checksum += mix(vertex);
+
+        for (uint32_t edge : adjacency)
+        {
+            checksum += mix(((uint64_t)vertex << 32) | edge);
+        }
+    }
+
+    void add(const ScanResult& other)
+    {
+        vertices += other.vertices;
+        edges += other.edges;
+        checksum += other.checksum;
+        out_of_order += other.out_of_order;
+    }
+};
+
+struct ScanTest
+{
+    AdjacencyList *list;
+    uint64_t snapshot;
+    std::vector<ScanRange> ranges;
+    std::atomic<size_t> next_range;
+    std::vector<ScanResult> results;
+    std::atomic<bool> churning;
+    uint64_t churn_txns;
+};
+
+struct ThreadArg
+{
+    ScanTest *test;
+    intptr_t id;
+};
+
+void scanRange(AdjacencyList *list, uint64_t snapshot, const ScanRange &range, ScanResult &result)
+{
+    bool first = true;
+    uint32_t last = 0;
+
+    list->SnapshotScan(snapshot, range, [&](uint32_t vertex, const std::vector<uint32_t>& edges)
+    {
+        result.out_of_order += !first && vertex <= last;
+        first = false;
+        last = vertex;
+        result.add(vertex, edges);
+    });
+}
+
+//Workers take the next range until none are left
+void *scanWorker(void *arg)
+{
+    ScanTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+
+    for (size_t r = test->next_range++; r < test->ranges.size(); r = test->next_range++)
+    {
+        scanRange(test->list, test->snapshot, test->ranges[r], test->results[id]);
+    }
+
+    return NULL;
+}
+
+void *populate(void *arg)
+{
+    ScanTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> edge_dist(1, 4 * num_vertices);
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    for (int v = id + 1; v <= num_vertices; v += num_thread)
+    {
+        std::vector<uint32_t> adjacency;
+
+        while ((int)adjacency.size() < edges_per_vertex)
+        {
+            uint32_t edge = edge_dist(randomGen);
+
+            if (std::find(adjacency.begin(), adjacency.end(), edge) == adjacency.end())
+            {
+                adjacency.push_back(edge);
+                edges.push_back(std::make_pair(v, edge));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < edges.size(); i += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min((size_t)POPULATE_TXN_OPS, edges.size() - i);
+
+        //Threads own the edges of distinct vertices, an abort can only come from helping and is retried
+        while (true)
+        {
+            Desc *desc = list->AllocateDesc(size);
+
+            for (uint32_t t = 0; t < size; t++)
+            {
+                desc->ops[t].type = INSERT_EDGE;
+                desc->ops[t].key = edges[i + t].first;
+                desc->ops[t].edge_key = edges[i + t].second;
+            }
+
+            if (list->ExecuteOps(desc))
+            {
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//Deletes random vertices and inserts them again with a few edges while the scans run
+void *churnTest(void *arg)
+{
+    ScanTest *test = (ScanTest *)arg;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(num_thread + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+    boost::uniform_int<uint32_t> edge_dist(1, 4 * num_vertices);
+
+    for (int round = 0; round < num_vertices && test->churning.load(); round++)
+    {
+        uint32_t vertex = vertex_dist(randomGen);
+
+        for (uint8_t type : {DELETE, INSERT, INSERT_EDGE})
+        {
+            uint32_t size = type == INSERT_EDGE ? CHURN_EDGES : 1;
+            Desc *desc = list->AllocateDesc(size);
+
+            for (uint32_t t = 0; t < size; t++)
+            {
+                desc->ops[t].type = type;
+                desc->ops[t].key = vertex;
+                desc->ops[t].edge_key = type == INSERT_EDGE ? edge_dist(randomGen) : 0;
+            }
+
+            list->ExecuteOps(desc);
+            test->churn_txns++;
+        }
+    }
+
+    return NULL;
+}
+
+//SnapshotVertices, then SnapshotNeighbors on each vertex, the way to read the whole graph before scans
+ScanResult loopedScan(AdjacencyList *list, uint64_t snapshot)
+{
+    std::vector<uint32_t> vertices;
+    std::vector<uint32_t> edges;
+    ScanResult result;
+
+    list->SnapshotVertices(snapshot, vertices);
+
+    for (uint32_t vertex : vertices)
+    {
+        if (list->SnapshotNeighbors(snapshot, vertex, edges))
+        {
+            result.add(vertex, edges);
+        }
+    }
+
+    return result;
+}
+
+//Partitions the graph for workers threads and scans it, the partitioning is timed with the scan
+ScanResult parallelScan(ScanTest &test, int workers, double &elapsed)
+{
+    struct timespec start, finish;
+    pthread_t threads[workers];
+    ThreadArg args[workers];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    test.list->SnapshotPartition(test.snapshot, 0, UINT32_MAX, workers * RANGES_PER_WORKER, test.ranges);
+    test.next_range = 0;
+    test.results.assign(workers, ScanResult());
+
+    for (intptr_t i = 0; i < workers; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, &scanWorker, &args[i]);
+    }
+
+    for (int i = 0; i < workers; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+    ScanResult total;
+
+    for (const ScanResult &result : test.results)
+    {
+        total.add(result);
+    }
+
+    return total;
+}
+
+void report(const char *mode, int workers, size_t ranges, const ScanResult &result, double elapsed, bool match)
+{
+    printf("%s, %d, %lu, %lu, %lu, %.3f, %.0f, %s\n", mode, workers, ranges, result.vertices, result.edges, elapsed, result.edges / elapsed,
+        match && result.out_of_order == 0 ? "match" : "mismatch");
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 4)
+    {
+        printf("Proper format: %s <#Threads> <#Vertices> <#EdgesPerVertex> [--list] [--churn] [--no-looped]\n", argv[0]);
+        printf("Reads the whole graph from a snapshot with partitioned scans on 1, 2, 4 ... Threads workers\n");
+        printf("--list: keep the vertices in the list instead of the dense table\n");
+        printf("--churn: delete and insert vertices again while the scans run\n");
+        printf("--no-looped: skip the SnapshotVertices and SnapshotNeighbors loop, it takes quadratic time on the list\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    num_vertices = atoi(argv[2]);
+    edges_per_vertex = atoi(argv[3]);
+
+    for (int a = 4; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--list") == 0)
+        {
+            list_mode = true;
+        }
+        else if (strcmp(argv[a], "--churn") == 0)
+        {
+            churn = true;
+        }
+        else if (strcmp(argv[a], "--no-looped") == 0)
+        {
+            looped = false;
+        }
+        else
+        {
+            printf("Unknown option %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (num_vertices < 1 || edges_per_vertex < 0)
+    {
+        printf("Error: the graph needs at least one vertex\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    //Every thread inserts about num_vertices * edges_per_vertex / num_thread edges with a pred override each
+    //The churn thread runs up to num_vertices rounds of three transactions
+    uint64_t edge_count = (uint64_t)num_vertices * edges_per_vertex;
+    int ops = 3 * (edge_count / num_thread + POPULATE_TXN_OPS) + 3 * num_vertices * (CHURN_EDGES + 2);
+
+    ScanTest test;
+    test.list = new AdjacencyList(num_thread + 2, POPULATE_TXN_OPS, ops, list_mode ? 0 : num_vertices + 1);
+    test.churn_txns = 0;
+
+    test.list->Init();
+
+    for (int v = 1; v <= num_vertices; v += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min(POPULATE_TXN_OPS, (uint32_t)(num_vertices - v + 1));
+        Desc *desc = test.list->AllocateDesc(size);
+
+        for (uint32_t t = 0; t < size; t++)
+        {
+            desc->ops[t].type = INSERT;
+            desc->ops[t].key = v + t;
+        }
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    {
+        pthread_t threads[num_thread];
+        ThreadArg args[num_thread];
+
+        for (intptr_t i = 0; i < num_thread; i++)
+        {
+            args[i].test = &test;
+            args[i].id = i;
+            pthread_create(&threads[i], NULL, &populate, &args[i]);
+        }
+
+        for (int i = 0; i < num_thread; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    printf("Populated %d vertices and %lu edges\n\n", num_vertices, edge_count);
+
+    pthread_t churn_thread;
+    test.churning = churn;
+
+    if (churn)
+    {
+        pthread_create(&churn_thread, NULL, &churnTest, &test);
+    }
+
+    //Every scan is checked against one range scanned from the same snapshot, and against the looped read if there is one
+    printf("Mode, Workers, Ranges, Vertices, Edges, Seconds, Edges/s, Check\n");
+
+    if (looped)
+    {
+        struct timespec start, finish;
+        test.snapshot = test.list->BeginSnapshot();
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        ScanResult result = loopedScan(test.list, test.snapshot);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+
+        double elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+        double unused;
+        ScanResult whole = parallelScan(test, 1, unused);
+        test.list->EndSnapshot();
+
+        report("looped", 1, 1, result, elapsed, result.checksum == whole.checksum && result.vertices == whole.vertices);
+    }
+
+    for (int workers = 1; ; workers = std::min(2 * workers, num_thread))
+    {
+        test.snapshot = test.list->BeginSnapshot();
+
+        double elapsed;
+        ScanResult result = parallelScan(test, workers, elapsed);
+        size_t ranges = test.ranges.size();
+
+        std::vector<ScanRange> whole;
+        ScanResult expected;
+        test.list->SnapshotPartition(test.snapshot, 0, UINT32_MAX, 1, whole);
+
+        if (!whole.empty())
+        {
+            scanRange(test.list, test.snapshot, whole[0], expected);
+        }
+
+        test.list->EndSnapshot();
+
+        report("scan", workers, ranges, result, elapsed, result.checksum == expected.checksum && result.vertices == expected.vertices);
+
+        if (workers == num_thread)
+        {
+            break;
+        }
+    }
+
+    if (churn)
+    {
+        test.churning = false;
+        pthread_join(churn_thread, NULL);
+        printf("\nChurn transactions: %lu\n", test.churn_txns);
+    }
+
+    delete test.list;
+}
@@ -0,0 +1,295 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "ShardedAdjacencyList.h"
+#include "ThreadData.h"
+
+int num_threads = 4;
+int txns_per_thread = 100000;
+int num_vertices = 1024;
+uint32_t num_shards = 4;
+double pair_ratio = 0.5;
+bool dense = false;
+
+//Pair transactions add or remove an edge in [1, 32] on vertex v and its mirror v + num_vertices / 2 together
+//The others add or remove two edges in [33, 64] on one vertex, so they never touch the mirrored edges
+const uint32_t pair_edges = 32;
+
+template<typename Graph>
+struct ShardTest
+{
+    Graph *graph;
+    ThreadData *t_data;
+};
+
+template<typename Graph>
+struct ThreadArg
+{
+    ShardTest<Graph> *test;
+    intptr_t id;
+};
+
+template<typename Graph>
+void *writerTest(void *arg)
+{
+    ShardTest<Graph> *test = ((ThreadArg<Graph> *)arg)->test;
+    intptr_t id = ((ThreadArg<Graph> *)arg)->id;
+    Graph *graph = test->graph;
+
+    graph->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_real<double> ratio_dist(0, 1);
+    boost::uniform_int<uint32_t> pair_dist(1, num_vertices / 2);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+    boost::uniform_int<uint32_t> pair_edge_dist(1, pair_edges);
+    boost::uniform_int<uint32_t> edge_dist(pair_edges + 1, 2 * pair_edges);
+    boost::uniform_int<uint32_t> type_dist(0, 1);
+
+    for (int i = 0; i < txns_per_thread; i++)
+    {
+        typename Graph::Desc *desc = graph->AllocateDesc(2);
+
+        if (ratio_dist(randomGen) < pair_ratio)
+        {
+            uint32_t vertex = pair_dist(randomGen);
+            uint32_t edge = pair_edge_dist(randomGen);
+            uint8_t type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+
+            desc->ops[0].type = type;
+            desc->ops[0].key = vertex;
+            desc->ops[0].edge_key = edge;
+            desc->ops[1].type = type;
+            desc->ops[1].key = vertex + num_vertices / 2;
+            desc->ops[1].edge_key = edge;
+        }
+        else
+        {
+            uint32_t vertex = vertex_dist(randomGen);
+
+            for (int op = 0; op < 2; op++)
+            {
+                desc->ops[op].type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+                desc->ops[op].key = vertex;
+                desc->ops[op].edge_key = edge_dist(randomGen);
+            }
+        }
+
+        if (graph->ExecuteOps(desc))
+        {
+            test->t_data[id].g_commits++;
+        }
+        else
+        {
+            test->t_data[id].g_aborts++;
+        }
+    }
+
+    return NULL;
+}
+
+AdjacencyList *listOf(AdjacencyList *list, uint32_t)
+{
+    return list;
+}
+
+AdjacencyList *listOf(ShardedAdjacencyList *graph, uint32_t vertex)
+{
+    return graph->ShardFor(vertex);
+}
+
+std::vector<AdjacencyList *> listsOf(AdjacencyList *list)
+{
+    return {list};
+}
+
+std::vector<AdjacencyList *> listsOf(ShardedAdjacencyList *graph)
+{
+    return graph->shards;
+}
+
+//Every vertex must have the mirrored edges of its mirror, the graph is quiet by now so one snapshot per list will do
+template<typename Graph>
+bool consistent(Graph *graph)
+{
+    std::vector<AdjacencyList *> lists = listsOf(graph);
+    std::vector<uint64_t> snapshots;
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> mirror_edges;
+    bool match = true;
+
+    for (AdjacencyList *list : lists)
+    {
+        snapshots.push_back(list->BeginSnapshot());
+    }
+
+    for (int v = 1; v <= num_vertices / 2 && match; v++)
+    {
+        int mirror = v + num_vertices / 2;
+        AdjacencyList *list = listOf(graph, v);
+        AdjacencyList *mirror_list = listOf(graph, mirror);
+
+        list->SnapshotNeighbors(snapshots[std::find(lists.begin(), lists.end(), list) - lists.begin()], v, edges);
+        mirror_list->SnapshotNeighbors(snapshots[std::find(lists.begin(), lists.end(), mirror_list) - lists.begin()], mirror, mirror_edges);
+
+        edges.erase(std::lower_bound(edges.begin(), edges.end(), pair_edges + 1), edges.end());
+        mirror_edges.erase(std::lower_bound(mirror_edges.begin(), mirror_edges.end(), pair_edges + 1), mirror_edges.end());
+        match = edges == mirror_edges;
+    }
+
+    for (AdjacencyList *list : lists)
+    {
+        list->EndSnapshot();
+    }
+
+    return match;
+}
+
+//The list and every shard get room for each thread's transactions with a few descriptors per op
+int opsPerThread()
+{
+    return std::max(8 * txns_per_thread, 2 * num_vertices);
+}
+
+AdjacencyList *newGraph(AdjacencyList *)
+{
+    return new AdjacencyList(num_threads + 1, 2, opsPerThread(), dense ? num_vertices + 1 : 0);
+}
+
+ShardedAdjacencyList *newGraph(ShardedAdjacencyList *)
+{
+    return new ShardedAdjacencyList(num_shards, num_threads + 1, 2, opsPerThread(), dense ? num_vertices + 1 : 0);
+}
+
+template<typename Graph>
+void runTest(const char *mode)
+{
+    ShardTest<Graph> test;
+    test.graph = newGraph((Graph *)NULL);
+    test.t_data = new ThreadData[num_threads];
+
+    //Vertices go in one transaction each, a single one would span every shard
+    test.graph->Init();
+
+    for (int v = 1; v <= num_vertices; v++)
+    {
+        typename Graph::Desc *desc = test.graph->AllocateDesc(1);
+        desc->ops[0].type = INSERT;
+        desc->ops[0].key = v;
+
+        if (!test.graph->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    struct timespec start, finish;
+    pthread_t threads[num_threads];
+    ThreadArg<Graph> args[num_threads];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_threads; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, &writerTest<Graph>, &args[i]);
+    }
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+    int g_commits = 0;
+    int g_aborts = 0;
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        g_commits += test.t_data[i].g_commits;
+        g_aborts += test.t_data[i].g_aborts;
+    }
+
+    printf("%s, %.0f, %d, %d, %s\n", mode, g_commits / elapsed, g_commits, g_aborts, consistent(test.graph) ? "consistent" : "inconsistent");
+
+    delete test.graph;
+    delete[] test.t_data;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 6)
+    {
+        printf("Proper format: %s <#Threads> <#TxnsPerThread> <#Vertices> <#Shards> <PairRatio> [list|sharded ...] [--dense]\n", argv[0]);
+        printf("Runs edge transactions on one list and on a graph sharded by vertex (default both)\n");
+        printf("PairRatio of the transactions change an edge of two mirrored vertices, which mostly live in different shards\n");
+        printf("--dense: map the vertex keys through a direct table\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_threads = atoi(argv[1]);
+    txns_per_thread = atoi(argv[2]);
+    num_vertices = atoi(argv[3]) & ~1;
+    num_shards = atoi(argv[4]);
+    pair_ratio = atof(argv[5]);
+
+    bool run_list = false;
+    bool run_sharded = false;
+
+    for (int a = 6; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--dense") == 0)
+        {
+            dense = true;
+        }
+        else if (strcmp(argv[a], "list") == 0)
+        {
+            run_list = true;
+        }
+        else if (strcmp(argv[a], "sharded") == 0)
+        {
+            run_sharded = true;
+        }
+        else
+        {
+            printf("Unknown mode %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!run_list && !run_sharded)
+    {
+        run_list = run_sharded = true;
+    }
+
+    //Pairs whose two vertices fall in different shards run as cross-shard transactions
+    int cross_pairs = 0;
+
+    for (int v = 1; v <= num_vertices / 2; v++)
+    {
+        cross_pairs += ShardedAdjacencyList::ShardOf(v, num_shards) != ShardedAdjacencyList::ShardOf(v + num_vertices / 2, num_shards);
+    }
+
+    printf("Shards: %u, cross-shard pairs: %.1f%%\n", num_shards, 100.0 * cross_pairs / (num_vertices / 2));
+    printf("Mode, Commits/s, Commits, Aborts, Graph\n");
+
+    if (run_list)
+    {
+        runTest<AdjacencyList>("list");
+    }
+
+    if (run_sharded)
+    {
+        runTest<ShardedAdjacencyList>("sharded");
+    }
+}
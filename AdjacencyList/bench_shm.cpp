@@ -0,0 +1,274 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <spawn.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "ThreadData.h"
+
+extern char **environ;
+
+int num_processes = 2;
+int threads_per_process = 2;
+int txns_per_thread = 100000;
+int num_vertices = 256;
+bool dense = false;
+
+AdjacencyList *list;
+//One per thread of every process, in the segment when the list is shared
+ThreadData *t_data;
+//Index of this process' first thread in t_data
+int first_thread = 0;
+
+//Vertex v and its mirror v + num_vertices / 2 always gain and lose the same edge in one transaction
+//Threads of all processes pick from the same vertices, so transactions of different processes conflict and help each other
+void *writerTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices / 2);
+    boost::uniform_int<uint32_t> edge_dist(1, 64);
+    boost::uniform_int<uint32_t> type_dist(0, 1);
+
+    for (int i = 0; i < txns_per_thread; i++)
+    {
+        Desc *desc = list->AllocateDesc(2);
+        uint32_t vertex = vertex_dist(randomGen);
+        uint32_t edge = edge_dist(randomGen);
+        uint8_t type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+
+        desc->ops[0].type = type;
+        desc->ops[0].key = vertex;
+        desc->ops[0].edge_key = edge;
+        desc->ops[1].type = type;
+        desc->ops[1].key = vertex + num_vertices / 2;
+        desc->ops[1].edge_key = edge;
+
+        if (list->ExecuteOps(desc))
+        {
+            t_data[id].g_commits++;
+        }
+        else
+        {
+            t_data[id].g_aborts++;
+        }
+    }
+
+    return NULL;
+}
+
+//Runs count writer threads of this process, numbered from first_thread
+void runWriters(int count)
+{
+    pthread_t threads[count];
+
+    for (intptr_t i = 0; i < count; i++)
+    {
+        pthread_create(&threads[i], NULL, &writerTest, (void *)(first_thread + i));
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+//The process a parent spawned with --worker: attaches to the shared list and runs its threads
+int runWorker(const char *argv[])
+{
+    SharedSegment *segment = SharedSegment::Open(argv[2]);
+
+    if (segment == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
+    list = AdjacencyList::AttachShared(segment);
+    first_thread = atoi(argv[3]);
+    threads_per_process = atoi(argv[4]);
+    txns_per_thread = atoi(argv[5]);
+    num_vertices = atoi(argv[6]);
+    //The segment is at the same address here, the parent's pointer is good as it is
+    t_data = (ThreadData *)strtoull(argv[7], NULL, 16);
+
+    if (list == NULL)
+    {
+        printf("Error: no list in %s\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    runWriters(threads_per_process);
+    delete segment;
+
+    return EXIT_SUCCESS;
+}
+
+void populate()
+{
+    list->Init();
+
+    Desc *desc = list->AllocateDesc(num_vertices);
+    for (int v = 0; v < num_vertices; v++)
+    {
+        desc->ops[v].type = INSERT;
+        desc->ops[v].key = v + 1;
+    }
+
+    if (!list->ExecuteOps(desc))
+    {
+        printf("Error: populating vertices failed\n");
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+//Every vertex must have the edges of its mirror, whichever process committed them
+bool consistent()
+{
+    uint64_t snapshot = list->BeginSnapshot();
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> mirror_edges;
+    bool match = true;
+
+    for (int v = 1; v <= num_vertices / 2 && match; v++)
+    {
+        list->SnapshotNeighbors(snapshot, v, edges);
+        list->SnapshotNeighbors(snapshot, v + num_vertices / 2, mirror_edges);
+        match = edges == mirror_edges;
+    }
+
+    list->EndSnapshot();
+
+    return match;
+}
+
+void report(const char *mode, double elapsed)
+{
+    int g_commits = 0;
+    int g_aborts = 0;
+
+    for (int i = 0; i < num_processes * threads_per_process; i++)
+    {
+        g_commits += t_data[i].g_commits;
+        g_aborts += t_data[i].g_aborts;
+    }
+
+    printf("%s, %.0f, %d, %d, %s\n", mode, g_commits / elapsed, g_commits, g_aborts, consistent() ? "consistent" : "inconsistent");
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc >= 8 && strcmp(argv[1], "--worker") == 0)
+    {
+        return runWorker(argv);
+    }
+
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Processes> <#ThreadsPerProcess> <#TxnsPerThread> <#Vertices> [--dense]\n", argv[0]);
+        printf("Runs the same threads in one process on a private list, then spread over processes sharing one list in shared memory\n");
+        printf("--dense: map the vertex keys through a direct table\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_processes = atoi(argv[1]);
+    threads_per_process = atoi(argv[2]);
+    txns_per_thread = atoi(argv[3]);
+    num_vertices = atoi(argv[4]) & ~1;
+    dense = argc > 5 && strcmp(argv[5], "--dense") == 0;
+
+    int total_threads = num_processes * threads_per_process;
+    //Every writer op may leave a node and a few descriptors behind
+    int ops = 8 * std::max(txns_per_thread, num_vertices);
+    uint32_t dense_range = dense ? num_vertices + 1 : 0;
+    struct timespec start, finish;
+    double elapsed;
+
+    printf("Mode, Commits/s, Commits, Aborts, Graph\n");
+
+    //All threads in this process on a private list
+    list = new AdjacencyList(total_threads + 1, 2, ops, dense_range);
+    t_data = new ThreadData[total_threads];
+    populate();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    runWriters(total_threads);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+    report("threads", elapsed);
+
+    delete list;
+    delete[] t_data;
+
+    //The same threads spread over worker processes that share one list, the time includes starting the processes
+    std::string name = "/lftt_bench_shm_" + std::to_string(getpid());
+    SharedSegment *segment = SharedSegment::Create(name.c_str(), AdjacencyList::SharedSize(total_threads + 1, ops, dense_range) + sizeof(ThreadData) * total_threads);
+
+    if (segment == NULL)
+    {
+        std::exit(EXIT_FAILURE);
+    }
+
+    list = AdjacencyList::CreateShared(segment, total_threads + 1, 2, ops, dense_range);
+    t_data = new(segment->Allocate(sizeof(ThreadData) * total_threads)) ThreadData[total_threads];
+    populate();
+
+    std::vector<pid_t> workers(num_processes);
+    char counters[32];
+    snprintf(counters, sizeof(counters), "%lx", (uintptr_t)t_data);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int p = 0; p < num_processes; p++)
+    {
+        std::string first = std::to_string(p * threads_per_process);
+        std::string threads = std::to_string(threads_per_process);
+        std::string txns = std::to_string(txns_per_thread);
+        std::string vertices = std::to_string(num_vertices);
+        const char *worker_argv[] = {argv[0], "--worker", name.c_str(), first.c_str(), threads.c_str(), txns.c_str(), vertices.c_str(), counters, NULL};
+
+        if (posix_spawn(&workers[p], argv[0], NULL, NULL, (char *const *)worker_argv, environ) != 0)
+        {
+            perror("Error: starting a worker process");
+            SharedSegment::Remove(name.c_str());
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    bool failed = false;
+
+    for (int p = 0; p < num_processes; p++)
+    {
+        int status;
+        waitpid(workers[p], &status, 0);
+        failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    if (failed)
+    {
+        printf("Error: a worker process failed\n");
+    }
+    else
+    {
+        elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+        report("processes", elapsed);
+    }
+
+    printf("Shared segment: %lu of %lu bytes used\n", segment->Used(), segment->Size());
+
+    SharedSegment::Remove(name.c_str());
+    delete segment;
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
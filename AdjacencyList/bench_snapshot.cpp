@@ -0,0 +1,260 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "ThreadData.h"
+
+enum ScanMode
+{
+    SCAN_NONE = 0,
+    SCAN_SNAPSHOT,
+    SCAN_TXN
+};
+
+const char* mode_names[] = {"none", "snapshot", "txn"};
+
+int num_writers = 4;
+int num_scanners = 1;
+int txns_per_writer = 100000;
+int num_vertices = 256;
+int allocator_ops = 0;
+ScanMode scan_mode = SCAN_NONE;
+
+AdjacencyList *list;
+ThreadData *t_data;
+volatile int writers_done = 0;
+
+struct __attribute__((aligned(64))) ScanData
+{
+    int scans = 0;
+    int inconsistent = 0;
+};
+
+ScanData *s_data;
+
+//Vertex v and its mirror v + num_vertices / 2 always gain and lose the same edge in one transaction
+//Any consistent view of the graph therefore shows them with the same adjacencies
+void *writerTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices / 2);
+    boost::uniform_int<uint32_t> edge_dist(1, 64);
+    boost::uniform_int<uint32_t> type_dist(0, 1);
+
+    for (int i = 0; i < txns_per_writer; i++)
+    {
+        Desc *desc = list->AllocateDesc(2);
+        uint32_t vertex = vertex_dist(randomGen);
+        uint32_t edge = edge_dist(randomGen);
+        uint8_t type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+
+        desc->ops[0].type = type;
+        desc->ops[0].key = vertex;
+        desc->ops[0].edge_key = edge;
+        desc->ops[1].type = type;
+        desc->ops[1].key = vertex + num_vertices / 2;
+        desc->ops[1].edge_key = edge;
+
+        if (list->ExecuteOps(desc))
+        {
+            t_data[id].g_commits++;
+        }
+        else
+        {
+            t_data[id].g_aborts++;
+        }
+    }
+
+    __sync_fetch_and_add(&writers_done, 1);
+
+    return NULL;
+}
+
+//Scans the whole graph until the writers finish, either from a snapshot or as a transaction of finds over every vertex
+void *scanTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+
+    list->Init();
+
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> mirror_edges;
+
+    //A find transaction takes a descriptor and a node descriptor per vertex, stop before the allocators run out
+    int max_txn_scans = allocator_ops / (2 * num_vertices);
+
+    while (writers_done < num_writers)
+    {
+        if (scan_mode == SCAN_SNAPSHOT)
+        {
+            uint64_t snapshot = list->BeginSnapshot();
+
+            for (int v = 1; v <= num_vertices / 2; v++)
+            {
+                list->SnapshotNeighbors(snapshot, v, edges);
+                list->SnapshotNeighbors(snapshot, v + num_vertices / 2, mirror_edges);
+
+                if (edges != mirror_edges)
+                {
+                    s_data[id].inconsistent++;
+                    break;
+                }
+            }
+
+            list->EndSnapshot();
+        }
+        else
+        {
+            if (s_data[id].scans >= max_txn_scans)
+            {
+                break;
+            }
+
+            Desc *desc = list->AllocateDesc(num_vertices);
+
+            for (int v = 0; v < num_vertices; v++)
+            {
+                desc->ops[v].type = FIND;
+                desc->ops[v].key = v + 1;
+            }
+
+            list->ExecuteOps(desc);
+        }
+
+        s_data[id].scans++;
+    }
+
+    return NULL;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Writers> <#Scanners> <#TxnsPerWriter> <#Vertices> [none|snapshot|txn ...]\n", argv[0]);
+        printf("Measures writer throughput while scanners read the whole graph, from snapshots or as find transactions (default all modes)\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_writers = atoi(argv[1]);
+    num_scanners = atoi(argv[2]);
+    txns_per_writer = atoi(argv[3]);
+    num_vertices = atoi(argv[4]) & ~1;
+
+    std::vector<ScanMode> modes;
+    for (int a = 5; a < argc; a++)
+    {
+        if (strcmp(argv[a], "none") == 0)
+        {
+            modes.push_back(SCAN_NONE);
+        }
+        else if (strcmp(argv[a], "snapshot") == 0)
+        {
+            modes.push_back(SCAN_SNAPSHOT);
+        }
+        else if (strcmp(argv[a], "txn") == 0)
+        {
+            modes.push_back(SCAN_TXN);
+        }
+        else
+        {
+            printf("Unknown mode %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (modes.empty())
+    {
+        modes = {SCAN_NONE, SCAN_SNAPSHOT, SCAN_TXN};
+    }
+
+    printf("Mode, Writer Commits/s, Commits, Aborts, Scans, Inconsistent\n");
+
+    for (ScanMode mode : modes)
+    {
+        scan_mode = mode;
+        int scanners = mode == SCAN_NONE ? 0 : num_scanners;
+
+        //Snapshots keep deleted edges linked, every writer op may leave a node and a few descriptors behind
+        allocator_ops = 8 * std::max(txns_per_writer, num_vertices);
+        list = new AdjacencyList(num_writers + scanners + 1, 2, allocator_ops, num_vertices + 1);
+        t_data = new ThreadData[num_writers];
+        s_data = new ScanData[scanners];
+        writers_done = 0;
+
+        list->Init();
+
+        Desc *desc = list->AllocateDesc(num_vertices);
+        for (int v = 0; v < num_vertices; v++)
+        {
+            desc->ops[v].type = INSERT;
+            desc->ops[v].key = v + 1;
+        }
+
+        if (!list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        struct timespec start, finish;
+        pthread_t writers[num_writers];
+        pthread_t scan_threads[scanners];
+
+        for (intptr_t i = 0; i < scanners; i++)
+        {
+            pthread_create(&scan_threads[i], NULL, &scanTest, (void *)i);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (intptr_t i = 0; i < num_writers; i++)
+        {
+            pthread_create(&writers[i], NULL, &writerTest, (void *)i);
+        }
+
+        for (int i = 0; i < num_writers; i++)
+        {
+            pthread_join(writers[i], NULL);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+
+        for (int i = 0; i < scanners; i++)
+        {
+            pthread_join(scan_threads[i], NULL);
+        }
+
+        double elapsed = (finish.tv_sec - start.tv_sec);
+        elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+        int g_commits = 0;
+        int g_aborts = 0;
+        int scans = 0;
+        int inconsistent = 0;
+
+        for (int i = 0; i < num_writers; i++)
+        {
+            g_commits += t_data[i].g_commits;
+            g_aborts += t_data[i].g_aborts;
+        }
+
+        for (int i = 0; i < scanners; i++)
+        {
+            scans += s_data[i].scans;
+            inconsistent += s_data[i].inconsistent;
+        }
+
+        printf("%s, %.0f, %d, %d, %d, %d\n", mode_names[mode], g_commits / elapsed, g_commits, g_aborts, scans, inconsistent);
+
+        delete[] t_data;
+        delete[] s_data;
+    }
+}
@@ -0,0 +1,276 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+//Defaults that split every hub even on one core: more writers than cores overlap on the hubs whenever one is preempted
+int num_thread = 8;
+int num_hubs = 2;
+int edges_per_thread = 50000;
+
+//Every DELETE_STRIDE-th edge a thread inserted is deleted again
+static const int DELETE_STRIDE = 4;
+
+enum Mode
+{
+    SINGLE = 0,
+    SPLIT
+};
+
+const char* mode_names[] = {"single", "split"};
+
+struct SplitTest
+{
+    AdjacencyList *list;
+    std::vector<uint64_t> failed;
+    std::atomic<bool> writing;
+    uint64_t reads;
+    uint64_t unsorted;
+};
+
+struct ThreadArg
+{
+    SplitTest *test;
+    intptr_t id;
+};
+
+//The i-th edge of a thread, distinct for every thread and i and spread over the key range by an odd multiplier
+uint32_t edgeKey(intptr_t id, int i)
+{
+    return (uint32_t)(i * num_thread + id + 1) * 2654435761u;
+}
+
+uint32_t hubOf(uint32_t edge)
+{
+    return edge % num_hubs + 1;
+}
+
+//Inserts the edges of the thread one transaction each, then deletes every DELETE_STRIDE-th of them
+void *writerTest(void *arg)
+{
+    SplitTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    uint64_t failed = 0;
+
+    for (int round = 0; round < 2; round++)
+    {
+        for (int i = 0; i < edges_per_thread; i += round == 0 ? 1 : DELETE_STRIDE)
+        {
+            uint32_t edge = edgeKey(id, i);
+            Desc *desc = list->AllocateDesc(1);
+            desc->ops[0].type = round == 0 ? INSERT_EDGE : DELETE_EDGE;
+            desc->ops[0].key = hubOf(edge);
+            desc->ops[0].edge_key = edge;
+
+            failed += !list->ExecuteOps(desc);
+        }
+    }
+
+    test->failed[id] = failed;
+
+    return NULL;
+}
+
+//Reads the neighbors of the hubs while the writers run, whichever form they are in they must come sorted and unique
+void *readerTest(void *arg)
+{
+    SplitTest *test = (SplitTest *)arg;
+    std::vector<uint32_t> edges;
+
+    while (test->writing.load())
+    {
+        uint64_t snapshot = test->list->BeginSnapshot();
+
+        for (int hub = 1; hub <= num_hubs; hub++)
+        {
+            test->list->SnapshotNeighbors(snapshot, hub, edges);
+            test->unsorted += std::adjacent_find(edges.begin(), edges.end(), std::greater_equal<uint32_t>()) != edges.end();
+            test->reads++;
+        }
+
+        test->list->EndSnapshot();
+    }
+
+    return NULL;
+}
+
+void runTest(Mode mode)
+{
+    //Every edge is inserted once and may be deleted with a pred override each time,
+    //the thread that splits a hub copies every node of it into its own arena
+    uint64_t edge_count = (uint64_t)edges_per_thread * num_thread;
+    int ops = 4 * edges_per_thread + 2 * edge_count + num_hubs;
+
+    SplitTest test;
+    test.list = new AdjacencyList(num_thread + 1, 1, ops, num_hubs + 1);
+    test.list->split_hot_edges = mode == SPLIT;
+    test.failed.assign(num_thread, 0);
+    test.reads = 0;
+    test.unsorted = 0;
+
+    test.list->Init();
+
+    for (int hub = 1; hub <= num_hubs; hub++)
+    {
+        Desc *desc = test.list->AllocateDesc(1);
+        desc->ops[0].type = INSERT;
+        desc->ops[0].key = hub;
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: inserting the hubs failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    struct timespec start, finish;
+    pthread_t threads[num_thread];
+    pthread_t reader;
+    ThreadArg args[num_thread];
+
+    test.writing = true;
+    pthread_create(&reader, NULL, &readerTest, &test);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_thread; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, &writerTest, &args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    test.writing = false;
+    pthread_join(reader, NULL);
+
+    double elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+    uint64_t writes = edge_count + (uint64_t)num_thread * ((edges_per_thread + DELETE_STRIDE - 1) / DELETE_STRIDE);
+    uint64_t failed = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        failed += test.failed[i];
+    }
+
+    //Every hub against the edges the writers left it
+    std::vector<std::vector<uint32_t>> expected(num_hubs + 1);
+
+    for (intptr_t id = 0; id < num_thread; id++)
+    {
+        for (int i = 0; i < edges_per_thread; i++)
+        {
+            if (i % DELETE_STRIDE != 0)
+            {
+                uint32_t edge = edgeKey(id, i);
+                expected[hubOf(edge)].push_back(edge);
+            }
+        }
+    }
+
+    uint64_t mismatches = 0;
+    std::vector<uint32_t> edges;
+    uint64_t snapshot = test.list->BeginSnapshot();
+
+    for (int hub = 1; hub <= num_hubs; hub++)
+    {
+        std::sort(expected[hub].begin(), expected[hub].end());
+        test.list->SnapshotNeighbors(snapshot, hub, edges);
+        mismatches += edges != expected[hub];
+
+        for (size_t i = 0; i < expected[hub].size(); i += 97)
+        {
+            mismatches += !test.list->SnapshotFindEdge(snapshot, hub, expected[hub][i]);
+        }
+    }
+
+    test.list->EndSnapshot();
+
+    AdjacencyList::LivenessStats liveness;
+    test.list->SampleLiveness(1, liveness);
+
+    printf("%s, %.0f, %lu, %lu, %lu, %lu, %lu\n", mode_names[mode], writes / elapsed, failed, liveness.split_vertices, test.reads, test.unsorted, mismatches);
+
+    //A split run without a split measured nothing but the single mode again
+    if (mode == SPLIT && liveness.split_vertices == 0)
+    {
+        printf("Error: no hub reached %u contended writes and split, use more threads or edges per thread\n", AdjacencyList::split_contention);
+        std::exit(EXIT_FAILURE);
+    }
+
+    delete test.list;
+}
+
+void usage(const char* name)
+{
+    printf("Proper format: %s [<#Threads> <#Hubs> <#EdgesPerThread>] [single|split ...]\n", name);
+    printf("Every thread inserts its edges into a few hub vertices and deletes a quarter of them again while a thread reads the hubs\n");
+    printf("single: every hub keeps one mdlist, split: the edges of contended hubs are split over several (default both)\n");
+    printf("Defaults to %d threads, %d hubs and %d edges per thread, a split run fails if no hub split\n", num_thread, num_hubs, edges_per_thread);
+    std::exit(EXIT_FAILURE);
+}
+
+int main(int argc, const char *argv[])
+{
+    int first_mode = 1;
+
+    if (argc > 1 && isdigit(argv[1][0]))
+    {
+        if (argc < 4)
+        {
+            usage(argv[0]);
+        }
+
+        num_thread = atoi(argv[1]);
+        num_hubs = std::max(atoi(argv[2]), 1);
+        edges_per_thread = atoi(argv[3]);
+        first_mode = 4;
+    }
+
+    std::vector<Mode> modes;
+
+    for (int a = first_mode; a < argc; a++)
+    {
+        size_t m = 0;
+        while (m < sizeof(mode_names) / sizeof(mode_names[0]) && strcmp(argv[a], mode_names[m]) != 0)
+        {
+            m++;
+        }
+
+        if (m == sizeof(mode_names) / sizeof(mode_names[0]))
+        {
+            printf("Unknown mode %s\n", argv[a]);
+            usage(argv[0]);
+        }
+
+        modes.push_back((Mode)m);
+    }
+
+    if (modes.empty())
+    {
+        modes = {SINGLE, SPLIT};
+    }
+
+    printf("Mode, Writes/s, Failed, Split hubs, Hub reads, Unsorted reads, Mismatches\n");
+
+    for (Mode mode : modes)
+    {
+        runTest(mode);
+    }
+}
@@ -0,0 +1,459 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "workload.h"
+
+int num_thread = 4;
+int num_vertices = 16384;
+int edge_factor = GRAPH500_EDGE_FACTOR;
+int ops_per_thread = 100000;
+bool dense = false;
+
+//Ops of an ingest or populate transaction
+static const uint32_t INGEST_TXN_OPS = 16;
+
+//Share of the read-heavy ops that read the neighbors of a vertex, the rest insert or delete an edge
+static const double READ_SHARE = 0.95;
+
+//Reads between two snapshots
+static const int READS_PER_SNAPSHOT = 64;
+
+//Edges a churn thread keeps inserted, every insert beyond them is followed by deleting its oldest
+static const uint32_t CHURN_WINDOW = 1024;
+
+//Room every thread gets for the ops of a scenario on top of the starting graph, vertex deletes copy a NodeDesc per edge
+static const int OPS_ROOM = 4;
+
+enum Scenario
+{
+    INGEST = 0,
+    READ,
+    CHURN,
+    STORM
+};
+
+const char* scenario_names[] = {"ingest", "read", "churn", "storm"};
+
+struct SuiteTest
+{
+    AdjacencyList *list;
+    Scenario scenario;
+    //The edges of the R-MAT graph in random order, for ingest
+    std::vector<std::pair<uint32_t, uint32_t>> shuffled;
+    pthread_barrier_t barrier;
+    std::vector<uint64_t> ops;
+    std::vector<uint64_t> aborts;
+    std::vector<uint64_t> edges_read;
+};
+
+struct ThreadArg
+{
+    SuiteTest *test;
+    intptr_t id;
+};
+
+bool executeOp(AdjacencyList *list, uint8_t type, uint32_t key, uint32_t edge_key)
+{
+    Desc *desc = list->AllocateDesc(1);
+    desc->ops[0].type = type;
+    desc->ops[0].key = key;
+    desc->ops[0].edge_key = edge_key;
+
+    return list->ExecuteOps(desc);
+}
+
+//Inserts the vertices [1, num_vertices] and then the edges of [begin, end) INGEST_TXN_OPS at a time
+//Vertex ops are numbered from 0 and edge ops from num_vertices, a transaction that aborts on a conflict is retried
+uint64_t insertRange(AdjacencyList *list, const std::vector<std::pair<uint32_t, uint32_t>>& edges, uint64_t begin, uint64_t end, uint64_t& aborts)
+{
+    for (uint64_t i = begin; i < end; )
+    {
+        uint32_t size = std::min<uint64_t>(INGEST_TXN_OPS, end - i);
+        Desc *desc = list->AllocateDesc(size);
+
+        for (uint32_t t = 0; t < size; t++)
+        {
+            uint64_t op = i + t;
+            bool vertex = op < (uint64_t)num_vertices;
+
+            desc->ops[t].type = vertex ? INSERT : INSERT_EDGE;
+            desc->ops[t].key = vertex ? op + 1 : edges[op - num_vertices].first;
+            desc->ops[t].edge_key = vertex ? 0 : edges[op - num_vertices].second;
+        }
+
+        if (list->ExecuteOps(desc))
+        {
+            i += size;
+        }
+        else
+        {
+            aborts++;
+        }
+    }
+
+    return end - begin;
+}
+
+//Every thread inserts its share of the vertices, then once all vertices are in its share of the shuffled edges
+void ingest(SuiteTest *test, intptr_t id)
+{
+    uint64_t vertices = num_vertices;
+    uint64_t edges = test->shuffled.size();
+    uint64_t ops = 0;
+    uint64_t aborts = 0;
+
+    ops += insertRange(test->list, test->shuffled, vertices * id / num_thread, vertices * (id + 1) / num_thread, aborts);
+    pthread_barrier_wait(&test->barrier);
+    ops += insertRange(test->list, test->shuffled, vertices + edges * id / num_thread, vertices + edges * (id + 1) / num_thread, aborts);
+
+    test->ops[id] = ops;
+    test->aborts[id] = aborts;
+}
+
+//Reads the neighbors of vertices drawn by degree, the hubs most, and now and then inserts or deletes an R-MAT edge
+void readHeavy(SuiteTest *test, intptr_t id)
+{
+    AdjacencyList *list = test->list;
+    RmatGenerator rmat(num_vertices, id + 2);
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_real<double> share_dist(0, 1);
+
+    std::vector<uint32_t> neighbors;
+    uint64_t ops = 0;
+    uint64_t aborts = 0;
+    uint64_t edges_read = 0;
+    uint64_t snapshot = list->BeginSnapshot();
+    int reads = 0;
+
+    for (int i = 0; i < ops_per_thread; i++)
+    {
+        if (share_dist(randomGen) < READ_SHARE)
+        {
+            if (++reads % READS_PER_SNAPSHOT == 0)
+            {
+                list->EndSnapshot();
+                snapshot = list->BeginSnapshot();
+            }
+
+            list->SnapshotNeighbors(snapshot, rmat.NextVertex(), neighbors);
+            edges_read += neighbors.size();
+            ops++;
+            continue;
+        }
+
+        uint32_t src;
+        uint32_t dst;
+        rmat.Next(src, dst);
+
+        //Deletes of edges that are not there and inserts of ones that are fail, which is an abort like any other
+        if (executeOp(list, i & 1 ? DELETE_EDGE : INSERT_EDGE, src, dst))
+        {
+            ops++;
+        }
+        else
+        {
+            aborts++;
+        }
+    }
+
+    list->EndSnapshot();
+
+    test->ops[id] = ops;
+    test->aborts[id] = aborts;
+    test->edges_read[id] = edges_read;
+}
+
+//Inserts R-MAT edges and deletes the ones it inserted CHURN_WINDOW inserts earlier, the edge count stays level
+void churn(SuiteTest *test, intptr_t id)
+{
+    AdjacencyList *list = test->list;
+    RmatGenerator rmat(num_vertices, id + 2);
+
+    std::vector<std::pair<uint32_t, uint32_t>> window(CHURN_WINDOW);
+    uint64_t inserted = 0;
+    uint64_t ops = 0;
+    uint64_t aborts = 0;
+
+    for (int i = 0; i < ops_per_thread; i++)
+    {
+        std::pair<uint32_t, uint32_t>& slot = window[inserted % CHURN_WINDOW];
+
+        if (inserted >= CHURN_WINDOW && slot.first != 0)
+        {
+            bool deleted = executeOp(list, DELETE_EDGE, slot.first, slot.second);
+            ops += deleted;
+            aborts += !deleted;
+            slot.first = 0;
+            continue;
+        }
+
+        uint32_t src;
+        uint32_t dst;
+        rmat.Next(src, dst);
+
+        //An edge that is already there fails to insert
+        if (executeOp(list, INSERT_EDGE, src, dst))
+        {
+            slot = std::make_pair(src, dst);
+            inserted++;
+            ops++;
+        }
+        else
+        {
+            aborts++;
+        }
+    }
+
+    test->ops[id] = ops;
+    test->aborts[id] = aborts;
+}
+
+//Half the threads delete vertices drawn by degree and insert them again without their edges, so the hubs with the most edges
+//to mark go first, while the other half insert R-MAT edges, which fail while their vertex is gone
+void storm(SuiteTest *test, intptr_t id)
+{
+    AdjacencyList *list = test->list;
+    RmatGenerator rmat(num_vertices, id + 2);
+    bool deleter = id < (num_thread + 1) / 2;
+
+    uint64_t ops = 0;
+    uint64_t aborts = 0;
+
+    for (int i = 0; i < ops_per_thread; i++)
+    {
+        uint32_t src;
+        uint32_t dst;
+        rmat.Next(src, dst);
+
+        if (!deleter)
+        {
+            bool inserted = executeOp(list, INSERT_EDGE, src, dst);
+            ops += inserted;
+            aborts += !inserted;
+            continue;
+        }
+
+        if (!executeOp(list, DELETE, src, 0))
+        {
+            aborts++;
+            continue;
+        }
+
+        //Only the thread that deleted a vertex inserts it again, an insert that aborts on a conflict is retried
+        while (!executeOp(list, INSERT, src, 0))
+        {
+            aborts++;
+        }
+
+        ops += 2;
+    }
+
+    test->ops[id] = ops;
+    test->aborts[id] = aborts;
+}
+
+void *suiteTest(void *arg)
+{
+    SuiteTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+
+    test->list->Init();
+
+    switch (test->scenario)
+    {
+    case INGEST:
+        ingest(test, id);
+        break;
+    case READ:
+        readHeavy(test, id);
+        break;
+    case CHURN:
+        churn(test, id);
+        break;
+    case STORM:
+        storm(test, id);
+        break;
+    }
+
+    return NULL;
+}
+
+void runTest(Scenario scenario, const std::vector<std::pair<uint32_t, uint32_t>>& edges)
+{
+    //The populating thread takes a slot of its own, an edge insert may install a NodeDesc in its pred as well as in its node
+    int ops = num_vertices + 2 * edges.size() + OPS_ROOM * ops_per_thread;
+
+    SuiteTest test;
+    test.list = new AdjacencyList(num_thread + 1, INGEST_TXN_OPS, ops, dense ? num_vertices + 1 : 0);
+    test.scenario = scenario;
+    test.ops.assign(num_thread, 0);
+    test.aborts.assign(num_thread, 0);
+    test.edges_read.assign(num_thread, 0);
+    pthread_barrier_init(&test.barrier, NULL, num_thread);
+
+    test.list->Init();
+
+    if (scenario == INGEST)
+    {
+        boost::mt19937 randomGen;
+        randomGen.seed(1);
+        test.shuffled = edges;
+
+        for (size_t i = test.shuffled.size(); i > 1; i--)
+        {
+            boost::uniform_int<size_t> index_dist(0, i - 1);
+            std::swap(test.shuffled[i - 1], test.shuffled[index_dist(randomGen)]);
+        }
+    }
+    else
+    {
+        uint64_t aborts = 0;
+        insertRange(test.list, edges, 0, num_vertices + edges.size(), aborts);
+    }
+
+    struct timespec start, finish;
+    pthread_t threads[num_thread];
+    ThreadArg args[num_thread];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_thread; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, &suiteTest, &args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+    uint64_t total_ops = 0;
+    uint64_t aborts = 0;
+    uint64_t edges_read = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        total_ops += test.ops[i];
+        aborts += test.aborts[i];
+        edges_read += test.edges_read[i];
+    }
+
+    std::vector<AdjacencyList::AllocatorStats> allocators;
+    test.list->MemoryUsage(allocators);
+
+    uint64_t handed_out = 0;
+    for (const AdjacencyList::AllocatorStats& allocator : allocators)
+    {
+        handed_out += allocator.handed_out;
+    }
+
+    AdjacencyList::LivenessStats liveness;
+    //Every vertex is walked, a sample would be thrown off by whether it caught the hubs
+    test.list->SampleLiveness(1, liveness);
+
+    printf("%s, %.0f, %lu, %lu, %lu, %lu, %.1f, %.1f\n", scenario_names[scenario], total_ops / elapsed, aborts, edges_read,
+        liveness.live_vertices, liveness.live_edges, handed_out / 1048576.0, liveness.live_edges ? (double)handed_out / liveness.live_edges : 0.0);
+
+    pthread_barrier_destroy(&test.barrier);
+    delete test.list;
+}
+
+//Vertices, edges, the largest degree and the share of the edges held by the 1% of the vertices with the most
+void reportGraph(const std::vector<std::pair<uint32_t, uint32_t>>& edges)
+{
+    std::vector<uint32_t> degrees(num_vertices + 1, 0);
+
+    for (const std::pair<uint32_t, uint32_t>& edge : edges)
+    {
+        degrees[edge.first]++;
+    }
+
+    std::sort(degrees.begin(), degrees.end(), std::greater<uint32_t>());
+
+    uint64_t top = 0;
+    for (int v = 0; v < std::max(1, num_vertices / 100); v++)
+    {
+        top += degrees[v];
+    }
+
+    uint64_t isolated = std::count(degrees.begin(), degrees.end() - 1, 0);
+
+    printf("R-MAT graph: %d vertices, %lu edges, largest degree %u, %.1f%% of the edges on 1%% of the vertices, %lu without edges\n\n",
+        num_vertices, edges.size(), degrees[0], edges.empty() ? 0.0 : 100.0 * top / edges.size(), isolated);
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Threads> <#Vertices> <#EdgeFactor> <#OpsPerThread> [ingest|read|churn|storm ...] [--dense]\n", argv[0]);
+        printf("Builds an R-MAT graph with the Graph500 parameters, EdgeFactor * Vertices / 2 draws inserted in both directions\n");
+        printf("(Graph500 uses 16), then runs each scenario on a fresh copy of it (default all)\n");
+        printf("ingest: the threads insert the vertices and then the edges in random order into an empty graph\n");
+        printf("read: %.0f%% neighbor reads of vertices drawn by degree, the rest edge inserts and deletes\n", READ_SHARE * 100);
+        printf("churn: edge inserts, each thread deleting what it inserted %u inserts before\n", CHURN_WINDOW);
+        printf("storm: half the threads delete and reinsert vertices drawn by degree while the others insert edges\n");
+        printf("--dense: map the vertex keys through a direct table\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    num_vertices = atoi(argv[2]);
+    edge_factor = atoi(argv[3]);
+    ops_per_thread = atoi(argv[4]);
+
+    std::vector<Scenario> scenarios;
+
+    for (int a = 5; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--dense") == 0)
+        {
+            dense = true;
+            continue;
+        }
+
+        size_t s = 0;
+        while (s < sizeof(scenario_names) / sizeof(scenario_names[0]) && strcmp(argv[a], scenario_names[s]) != 0)
+        {
+            s++;
+        }
+
+        if (s == sizeof(scenario_names) / sizeof(scenario_names[0]))
+        {
+            printf("Unknown scenario %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+
+        scenarios.push_back((Scenario)s);
+    }
+
+    if (scenarios.empty())
+    {
+        scenarios = {INGEST, READ, CHURN, STORM};
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    RmatGenerator rmat(num_vertices, 1);
+    rmat.Edges((uint64_t)edge_factor * num_vertices / 2, edges);
+
+    reportGraph(edges);
+
+    printf("Scenario, Ops/s, Aborts, Edges read, Live vertices, Live edges, MB handed out, Bytes/live edge\n");
+
+    for (Scenario scenario : scenarios)
+    {
+        runTest(scenario, edges);
+    }
+}
@@ -0,0 +1,274 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "AdjacencyList.h"
+#include "Baselines.h"
+#include "ThreadData.h"
+#include "workload.h"
+
+enum Impl
+{
+    IMPL_LFTT = 0,
+    IMPL_MUTEX,
+    IMPL_VERTEX,
+    IMPL_STM
+};
+
+const char* impl_names[] = {"lftt", "mutex", "vertex", "stm"};
+
+//The first is the default mix of main
+const OpMix mixes[] = {
+    {"vertex-churn", .4, .4, .1, .1, 0},
+    {"edge-churn", .05, .05, .45, .45, 0},
+    {"balanced", .1, .1, .2, .2, .4},
+    {"read-mostly", .02, .02, .03, .03, .9}
+};
+
+int txns_per_thread = 10000;
+int transaction_size = 4;
+int key_range = 5000;
+int max_threads = 8;
+bool dense = false;
+
+template<typename List>
+struct SweepTest
+{
+    List *list;
+    const OpMix *mix;
+    ThreadData *t_data;
+};
+
+template<typename List>
+struct ThreadArg
+{
+    SweepTest<List> *test;
+    intptr_t id;
+};
+
+//The workload of main, seeded per thread so every implementation runs the same transactions
+template<typename List>
+void *sweepTest(void *arg)
+{
+    SweepTest<List> *test = ((ThreadArg<List> *)arg)->test;
+    intptr_t id = ((ThreadArg<List> *)arg)->id;
+    List *list = test->list;
+
+    list->Init();
+
+    WorkloadGenerator workload(*test->mix, key_range, id + 1);
+
+    for (int i = 0; i < txns_per_thread; i++)
+    {
+        typename List::Desc *desc = list->AllocateDesc(transaction_size);
+        workload.Fill(desc);
+
+        if (list->ExecuteOps(desc))
+        {
+            test->t_data[id].g_commits++;
+        }
+        else
+        {
+            test->t_data[id].g_aborts++;
+        }
+    }
+
+    return NULL;
+}
+
+AdjacencyList *newList(AdjacencyList *, int threads)
+{
+    //The calling thread populates the list, every worker runs its transactions with room for a descriptor copy per op
+    int ops = std::max(2 * txns_per_thread * transaction_size, 2 * key_range);
+    return new AdjacencyList(threads + 1, transaction_size, ops, dense ? key_range + 1 : 0);
+}
+
+LockedAdjacencyList *newList(LockedAdjacencyList *, int)
+{
+    return new LockedAdjacencyList();
+}
+
+VertexLockedAdjacencyList *newList(VertexLockedAdjacencyList *, int)
+{
+    return new VertexLockedAdjacencyList(key_range + 1);
+}
+
+StmAdjacencyList *newList(StmAdjacencyList *, int)
+{
+    return new StmAdjacencyList(key_range + 1);
+}
+
+uint64_t conflictRetries(AdjacencyList *)
+{
+    return 0;
+}
+
+template<typename List>
+uint64_t conflictRetries(List *list)
+{
+    return list->retries;
+}
+
+//Runs one point of the sweep on a fresh graph with every other key inserted, appends it to the CSV
+template<typename List>
+void runPoint(Impl impl, const OpMix& mix, int threads, FILE *csv)
+{
+    SweepTest<List> test;
+    test.list = newList((List *)NULL, threads);
+    test.mix = &mix;
+    test.t_data = new ThreadData[threads];
+
+    test.list->Init();
+
+    for (int key = 2; key <= key_range; key += 2)
+    {
+        typename List::Desc *desc = test.list->AllocateDesc(1);
+        desc->ops[0].type = INSERT;
+        desc->ops[0].key = key;
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: populating %s failed\n", impl_names[impl]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    struct timespec start, finish;
+    pthread_t thread[threads];
+    ThreadArg<List> args[threads];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < threads; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&thread[i], NULL, &sweepTest<List>, &args[i]);
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec);
+    elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+    uint64_t commits = 0;
+    uint64_t aborts = 0;
+
+    for (int i = 0; i < threads; i++)
+    {
+        commits += test.t_data[i].g_commits;
+        aborts += test.t_data[i].g_aborts;
+    }
+
+    uint64_t retries = conflictRetries(test.list);
+    double abort_rate = commits + aborts > 0 ? (double)aborts / (commits + aborts) : 0;
+
+    const char *format = "%s, %s, %d, %.0f, %.0f, %lu, %lu, %lu, %.4f\n";
+    double txns_per_s = (commits + aborts) / elapsed;
+    double commit_ops_per_s = commits * transaction_size / elapsed;
+
+    fprintf(csv, format, impl_names[impl], mix.name, threads, txns_per_s, commit_ops_per_s, commits, aborts, retries, abort_rate);
+    fflush(csv);
+    printf(format, impl_names[impl], mix.name, threads, txns_per_s, commit_ops_per_s, commits, aborts, retries, abort_rate);
+
+    delete test.list;
+    delete[] test.t_data;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 6)
+    {
+        printf("Proper format: %s <#TxnsPerThread> <#TransactionSize> <#KeyRange> <#MaxThreads> <CsvPath> [lftt|mutex|vertex|stm ...] [--dense]\n", argv[0]);
+        printf("Runs the workload of main on the list and the baselines for every op mix at 1, 2, 4 ... MaxThreads threads (default all implementations)\n");
+        printf("--dense: map the list's vertex keys through a direct table\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    txns_per_thread = atoi(argv[1]);
+    transaction_size = atoi(argv[2]);
+    key_range = atoi(argv[3]);
+    max_threads = atoi(argv[4]);
+    const char *csv_path = argv[5];
+
+    std::vector<Impl> impls;
+    for (int a = 6; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--dense") == 0)
+        {
+            dense = true;
+            continue;
+        }
+
+        size_t impl = 0;
+        while (impl <= IMPL_STM && strcmp(argv[a], impl_names[impl]) != 0)
+        {
+            impl++;
+        }
+
+        if (impl > IMPL_STM)
+        {
+            printf("Unknown implementation %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+
+        impls.push_back((Impl)impl);
+    }
+    if (impls.empty())
+    {
+        impls = {IMPL_LFTT, IMPL_MUTEX, IMPL_VERTEX, IMPL_STM};
+    }
+
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < max_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    FILE *csv = fopen(csv_path, "w");
+    if (csv == NULL)
+    {
+        perror("Error: opening the CSV file");
+        std::exit(EXIT_FAILURE);
+    }
+
+    //Txns/s counts every transaction, committed or aborted; Ops/s only the ops of committed ones
+    const char *header = "Impl, Mix, Threads, Txns/s, Ops/s, Commits, Aborts, Retries, AbortRate\n";
+    fprintf(csv, "%s", header);
+    printf("%s", header);
+
+    for (const OpMix& mix : mixes)
+    {
+        for (int threads : thread_counts)
+        {
+            for (Impl impl : impls)
+            {
+                switch (impl)
+                {
+                case IMPL_LFTT:
+                    runPoint<AdjacencyList>(impl, mix, threads, csv);
+                    break;
+                case IMPL_MUTEX:
+                    runPoint<LockedAdjacencyList>(impl, mix, threads, csv);
+                    break;
+                case IMPL_VERTEX:
+                    runPoint<VertexLockedAdjacencyList>(impl, mix, threads, csv);
+                    break;
+                case IMPL_STM:
+                    runPoint<StmAdjacencyList>(impl, mix, threads, csv);
+                    break;
+                }
+            }
+        }
+    }
+
+    fclose(csv);
+}
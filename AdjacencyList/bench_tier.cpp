@@ -0,0 +1,470 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+int num_thread = 4;
+int num_vertices = 100000;
+int edges_per_vertex = 64;
+int reads_per_thread = 100000;
+bool list_mode = false;
+
+//Edges a transaction inserts while populating
+static const uint32_t POPULATE_TXN_OPS = 64;
+
+//Reads between two snapshots, the freezer of the write phase only gets through while no snapshot is open
+static const int READS_PER_SNAPSHOT = 256;
+
+//Commits a vertex's edges go without a change before the background freezer takes them
+static const uint64_t FREEZE_AGE = 256;
+
+typedef AdjacencyList::AllocatorStats AllocatorStats;
+typedef AdjacencyList::LivenessStats LivenessStats;
+
+struct TierTest
+{
+    AdjacencyList *list;
+    //Sorted edges of every vertex as the writers expect them
+    std::vector<std::vector<uint32_t>> model;
+    std::vector<uint64_t> checksums;
+    std::vector<uint64_t> writes;
+    std::vector<uint64_t> mismatches;
+    std::atomic<bool> writing;
+    uint64_t freezes;
+};
+
+struct ThreadArg
+{
+    TierTest *test;
+    intptr_t id;
+};
+
+uint64_t mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return x;
+}
+
+void *populate(void *arg)
+{
+    TierTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> edge_dist(1, 4 * num_vertices);
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    for (int v = id + 1; v <= num_vertices; v += num_thread)
+    {
+        std::vector<uint32_t> adjacency;
+
+        while ((int)adjacency.size() < edges_per_vertex)
+        {
+            uint32_t edge = edge_dist(randomGen);
+
+            if (std::find(adjacency.begin(), adjacency.end(), edge) == adjacency.end())
+            {
+                adjacency.push_back(edge);
+                edges.push_back(std::make_pair(v, edge));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < edges.size(); i += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min((size_t)POPULATE_TXN_OPS, edges.size() - i);
+        Desc *desc = list->AllocateDesc(size);
+
+        for (uint32_t t = 0; t < size; t++)
+        {
+            desc->ops[t].type = INSERT_EDGE;
+            desc->ops[t].key = edges[i + t].first;
+            desc->ops[t].edge_key = edges[i + t].second;
+        }
+
+        if (!list->ExecuteOps(desc))
+        {
+            printf("Error: populating edges failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    return NULL;
+}
+
+//Reads the neighbors of random vertices and looks up one edge of each that is there and one that may not be
+//The same seeds on both forms of the edges give the same checksum
+void *readerTest(void *arg)
+{
+    TierTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+    boost::uniform_int<uint32_t> edge_dist(1, 4 * num_vertices);
+
+    std::vector<uint32_t> edges;
+    uint64_t checksum = 0;
+    uint64_t snapshot = 0;
+
+    for (int i = 0; i < reads_per_thread; i++)
+    {
+        if (i % READS_PER_SNAPSHOT == 0)
+        {
+            if (i > 0)
+            {
+                list->EndSnapshot();
+            }
+
+            snapshot = list->BeginSnapshot();
+        }
+
+        uint32_t vertex = vertex_dist(randomGen);
+        uint32_t probe = edge_dist(randomGen);
+
+        list->SnapshotNeighbors(snapshot, vertex, edges);
+
+        for (uint32_t edge : edges)
+        {
+            checksum += mix(((uint64_t)vertex << 32) | edge);
+        }
+
+        if (!edges.empty())
+        {
+            checksum += list->SnapshotFindEdge(snapshot, vertex, edges[probe % edges.size()]);
+        }
+
+        checksum += 2 * list->SnapshotFindEdge(snapshot, vertex, probe);
+    }
+
+    list->EndSnapshot();
+
+    test->checksums[id] = checksum;
+
+    return NULL;
+}
+
+//Every thread writes the edges of its own vertices, one INSERT_EDGE or DELETE_EDGE per transaction, and checks each
+//result against the model. The first write to a frozen vertex thaws it
+void *writerTest(void *arg)
+{
+    TierTest *test = ((ThreadArg *)arg)->test;
+    intptr_t id = ((ThreadArg *)arg)->id;
+    AdjacencyList *list = test->list;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(num_thread + id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(0, (num_vertices - id - 1) / num_thread);
+    boost::uniform_int<uint32_t> edge_dist(1, 4 * num_vertices);
+
+    uint64_t mismatches = 0;
+    int writes = std::max(reads_per_thread / 16, 1);
+
+    for (int i = 0; i < writes; i++)
+    {
+        uint32_t vertex = id + 1 + vertex_dist(randomGen) * num_thread;
+        std::vector<uint32_t> &adjacency = test->model[vertex];
+        uint32_t edge = edge_dist(randomGen);
+
+        //Half the writes delete an edge the vertex has
+        if (!adjacency.empty() && edge % 2 == 0)
+        {
+            edge = adjacency[edge % adjacency.size()];
+        }
+
+        auto it = std::lower_bound(adjacency.begin(), adjacency.end(), edge);
+        bool present = it != adjacency.end() && *it == edge;
+
+        Desc *desc = list->AllocateDesc(1);
+        desc->ops[0].type = present ? DELETE_EDGE : INSERT_EDGE;
+        desc->ops[0].key = vertex;
+        desc->ops[0].edge_key = edge;
+
+        if (!list->ExecuteOps(desc))
+        {
+            mismatches++;
+            continue;
+        }
+
+        if (present)
+        {
+            adjacency.erase(it);
+        }
+        else
+        {
+            adjacency.insert(it, edge);
+        }
+    }
+
+    test->writes[id] = writes;
+    test->mismatches[id] = mismatches;
+
+    return NULL;
+}
+
+//Freezes whatever the writers left alone for a while, until they are done
+void *freezerTest(void *arg)
+{
+    TierTest *test = (TierTest *)arg;
+
+    test->list->Init();
+
+    while (test->writing.load())
+    {
+        test->freezes += test->list->FreezeColdEdges(FREEZE_AGE, 1);
+    }
+
+    return NULL;
+}
+
+double runThreads(TierTest &test, void *(*body)(void *))
+{
+    struct timespec start, finish;
+    pthread_t threads[num_thread];
+    ThreadArg args[num_thread];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_thread; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, body, &args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    return (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+}
+
+uint64_t handedOut(AdjacencyList *list, const char *name)
+{
+    std::vector<AllocatorStats> stats;
+    list->MemoryUsage(stats);
+
+    for (const AllocatorStats &entry : stats)
+    {
+        if (strcmp(entry.name, name) == 0)
+        {
+            return entry.handed_out;
+        }
+    }
+
+    return 0;
+}
+
+//Bytes of everything an mdlist edge is made of: its node, its descriptor, the pred override it placed and the adoptions
+uint64_t mdlistBytes(AdjacencyList *list)
+{
+    return handedOut(list, "MDNode") + handedOut(list, "MDDesc") + handedOut(list, "MDList") + handedOut(list, "NodeDesc");
+}
+
+uint64_t readChecksum(TierTest &test, double &elapsed)
+{
+    elapsed = runThreads(test, &readerTest);
+
+    uint64_t checksum = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        checksum += test.checksums[i];
+    }
+
+    return checksum;
+}
+
+//Every vertex against the model, from a single snapshot
+uint64_t checkModel(TierTest &test)
+{
+    uint64_t mismatches = 0;
+    std::vector<uint32_t> edges;
+    uint64_t snapshot = test.list->BeginSnapshot();
+
+    for (int v = 1; v <= num_vertices; v++)
+    {
+        test.list->SnapshotNeighbors(snapshot, v, edges);
+        mismatches += edges != test.model[v];
+    }
+
+    test.list->EndSnapshot();
+
+    return mismatches;
+}
+
+void printLiveness(const char *form, TierTest &test)
+{
+    LivenessStats liveness;
+    test.list->SampleLiveness(1, liveness);
+
+    printf("%s, %lu, %lu, %lu, %lu, %lu\n", form, liveness.live_edges, liveness.md_nodes, liveness.cold_vertices, liveness.cold_edges,
+        liveness.cold_bytes);
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Threads> <#Vertices> <#EdgesPerVertex> <#ReadsPerThread> [--list]\n", argv[0]);
+        printf("Reads the edges of random vertices from their mdlists, freezes them and reads them again, then writes them\n");
+        printf("while a background thread freezes what the writers left alone, checking every result against a model\n");
+        printf("--list: keep the vertices in the list instead of the dense table\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    num_vertices = atoi(argv[2]);
+    edges_per_vertex = atoi(argv[3]);
+    reads_per_thread = atoi(argv[4]);
+
+    for (int a = 5; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--list") == 0)
+        {
+            list_mode = true;
+        }
+        else
+        {
+            printf("Unknown option %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (num_vertices < num_thread || edges_per_vertex < 0)
+    {
+        printf("Error: every thread needs a vertex of its own\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    //Every edge takes a node, a descriptor and a pred override, thaws rebuild the mdlists of the written vertices
+    //The thawing writer builds the whole mdlist of a vertex, which takes more of its ops the more edges there are
+    uint64_t edge_count = (uint64_t)num_vertices * edges_per_vertex;
+    int ops = 4 * (edge_count / num_thread + POPULATE_TXN_OPS) + 4 * reads_per_thread + num_vertices;
+
+    //The main thread, the populating threads, the writers and the freezer
+    TierTest test;
+    test.list = new AdjacencyList(2 * num_thread + 2, POPULATE_TXN_OPS, ops, list_mode ? 0 : num_vertices + 1);
+    test.checksums.assign(num_thread, 0);
+    test.writes.assign(num_thread, 0);
+    test.mismatches.assign(num_thread, 0);
+    test.freezes = 0;
+
+    test.list->Init();
+
+    for (int v = 1; v <= num_vertices; v += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min(POPULATE_TXN_OPS, (uint32_t)(num_vertices - v + 1));
+        Desc *desc = test.list->AllocateDesc(size);
+
+        for (uint32_t t = 0; t < size; t++)
+        {
+            desc->ops[t].type = INSERT;
+            desc->ops[t].key = v + t;
+        }
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    //Inline edges take one descriptor each and stay as they are, the rest of the bytes the edges took are mdlist bytes
+    uint64_t before = mdlistBytes(test.list);
+    runThreads(test, &populate);
+
+    uint64_t inline_count = (uint64_t)num_vertices * std::min<int>(edges_per_vertex, AdjacencyList::inline_edges);
+    uint64_t mdlist_count = edge_count - inline_count;
+    uint64_t mdlist_bytes = mdlistBytes(test.list) - before - inline_count * sizeof(NodeDesc);
+
+    printf("Populated %d vertices and %lu edges, %lu of them in mdlists\n\n", num_vertices, edge_count, mdlist_count);
+
+    double mdlist_elapsed;
+    uint64_t mdlist_checksum = readChecksum(test, mdlist_elapsed);
+
+    struct timespec start, finish;
+    uint64_t cold_before = handedOut(test.list, "ColdEdges");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t frozen = test.list->FreezeColdEdges(0, 1);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double freeze_elapsed = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+    uint64_t cold_bytes = handedOut(test.list, "ColdEdges") - cold_before;
+
+    double cold_elapsed;
+    uint64_t cold_checksum = readChecksum(test, cold_elapsed);
+
+    printf("Form, Bytes/edge, Reads/s, Check\n");
+    printf("mdlist, %.1f, %.0f, -\n", mdlist_count ? (double)mdlist_bytes / mdlist_count : 0.0, num_thread * reads_per_thread / mdlist_elapsed);
+    printf("cold, %.1f, %.0f, %s\n", mdlist_count ? (double)cold_bytes / mdlist_count : 0.0, num_thread * reads_per_thread / cold_elapsed,
+        cold_checksum == mdlist_checksum ? "match" : "mismatch");
+    printf("Froze %lu vertices in %.3f s\n\n", frozen, freeze_elapsed);
+
+    printf("Liveness, Live edges, Reachable mdlist nodes, Cold vertices, Cold edges, Cold bytes\n");
+    printLiveness("frozen", test);
+
+    //The model starts from the frozen edges, so reading them is checked too
+    test.model.resize(num_vertices + 1);
+    {
+        uint64_t snapshot = test.list->BeginSnapshot();
+
+        for (int v = 1; v <= num_vertices; v++)
+        {
+            test.list->SnapshotNeighbors(snapshot, v, test.model[v]);
+        }
+
+        test.list->EndSnapshot();
+    }
+
+    pthread_t freezer;
+    test.writing = true;
+    pthread_create(&freezer, NULL, &freezerTest, &test);
+
+    double write_elapsed = runThreads(test, &writerTest);
+
+    test.writing = false;
+    pthread_join(freezer, NULL);
+
+    printLiveness("written", test);
+
+    uint64_t writes = 0;
+    uint64_t mismatches = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        writes += test.writes[i];
+        mismatches += test.mismatches[i];
+    }
+
+    uint64_t after_write = checkModel(test);
+    test.list->FreezeColdEdges(0, 1);
+    uint64_t after_refreeze = checkModel(test);
+
+    printLiveness("refrozen", test);
+
+    printf("\nWrites/s %.0f, refrozen in the background %lu, results off the model %lu, vertices off the model %lu after writes and %lu refrozen\n",
+        writes / write_elapsed, test.freezes, mismatches, after_write, after_refreeze);
+
+    delete test.list;
+}
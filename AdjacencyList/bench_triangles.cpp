@@ -0,0 +1,454 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+
+int num_thread = 4;
+int num_vertices = 100000;
+int attach_edges = 8;
+int num_queries = 100000;
+
+//Edges a transaction inserts while populating
+static const uint32_t POPULATE_TXN_OPS = 64;
+
+enum Mode
+{
+    LOOKUP = 0,
+    MERGE,
+    SIMD
+};
+
+const char* mode_names[] = {"lookup", "merge", "simd"};
+
+//Preferential attachment: every new vertex links to attach_edges distinct vertices picked in proportion to their degree
+//Edges are stored in both directions, degrees follow a power law with exponent 3
+void generateGraph(std::vector<std::vector<uint32_t>>& adjacency)
+{
+    boost::mt19937 randomGen;
+    randomGen.seed(1);
+
+    adjacency.assign(num_vertices + 1, std::vector<uint32_t>());
+
+    //Every edge adds both of its vertices, sampling this list picks a vertex in proportion to its degree
+    std::vector<uint32_t> endpoints;
+
+    //The first vertices form a clique to start from
+    for (int v = 1; v <= attach_edges + 1 && v <= num_vertices; v++)
+    {
+        for (int u = 1; u < v; u++)
+        {
+            adjacency[v].push_back(u);
+            adjacency[u].push_back(v);
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+
+    for (int v = attach_edges + 2; v <= num_vertices; v++)
+    {
+        std::vector<uint32_t>& targets = adjacency[v];
+
+        while ((int)targets.size() < attach_edges)
+        {
+            uint32_t u = endpoints[boost::uniform_int<size_t>(0, endpoints.size() - 1)(randomGen)];
+
+            if (std::find(targets.begin(), targets.end(), u) == targets.end())
+            {
+                targets.push_back(u);
+            }
+        }
+
+        for (uint32_t u : targets)
+        {
+            adjacency[u].push_back(v);
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+}
+
+template<typename Key>
+struct TriangleTest
+{
+    BasicAdjacencyList<Key> *list;
+    std::vector<std::vector<uint32_t>> *adjacency;
+    //Vertex pairs two hops apart
+    std::vector<std::pair<Key, Key>> pairs;
+    Mode mode;
+    std::vector<uint64_t> results;
+};
+
+template<typename Key>
+struct ThreadArg
+{
+    TriangleTest<Key> *test;
+    intptr_t id;
+};
+
+template<typename Key>
+void *populate(void *arg)
+{
+    TriangleTest<Key> *test = ((ThreadArg<Key> *)arg)->test;
+    intptr_t id = ((ThreadArg<Key> *)arg)->id;
+    BasicAdjacencyList<Key> *list = test->list;
+
+    list->Init();
+
+    std::vector<std::pair<Key, Key>> edges;
+
+    for (int v = id + 1; v <= num_vertices; v += num_thread)
+    {
+        for (uint32_t u : (*test->adjacency)[v])
+        {
+            edges.push_back(std::make_pair((Key)v, (Key)u));
+        }
+    }
+
+    for (size_t i = 0; i < edges.size(); i += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min((size_t)POPULATE_TXN_OPS, edges.size() - i);
+
+        //Threads own the edges of distinct vertices, an abort can only come from helping and is retried
+        while (true)
+        {
+            BasicDesc<Key> *desc = list->AllocateDesc(size);
+
+            for (uint32_t t = 0; t < size; t++)
+            {
+                desc->ops[t].type = INSERT_EDGE;
+                desc->ops[t].key = edges[i + t].first;
+                desc->ops[t].edge_key = edges[i + t].second;
+            }
+
+            if (list->ExecuteOps(desc))
+            {
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//Local triangles of a vertex the way SnapshotTriangles counts them, with the scalar merge
+template<typename Key>
+uint64_t mergeTriangles(BasicAdjacencyList<Key> *list, uint64_t snapshot, Key vertex, std::vector<Key>& edges, std::vector<Key>& neighbor_edges)
+{
+    uint64_t triangles = 0;
+
+    if (!list->SnapshotNeighbors(snapshot, vertex, edges))
+    {
+        return 0;
+    }
+
+    edges.erase(std::remove(edges.begin(), edges.end(), vertex), edges.end());
+
+    for (Key neighbor : edges)
+    {
+        if (list->SnapshotNeighbors(snapshot, neighbor, neighbor_edges))
+        {
+            triangles += IntersectCountScalar(edges.data(), edges.size(), neighbor_edges.data(), neighbor_edges.size());
+            triangles -= std::binary_search(neighbor_edges.begin(), neighbor_edges.end(), neighbor);
+        }
+    }
+
+    return triangles;
+}
+
+//SnapshotAllTriangles with the scalar merge, returns the sum of the local counts
+template<typename Key>
+uint64_t mergeAllTriangles(BasicAdjacencyList<Key> *list, uint64_t snapshot)
+{
+    std::vector<Key> vertices;
+    std::vector<Key> neighbors;
+    std::vector<Key> edges;
+    std::vector<size_t> offsets(1, 0);
+    uint64_t total = 0;
+
+    list->SnapshotVertices(snapshot, vertices);
+
+    for (Key vertex : vertices)
+    {
+        list->SnapshotNeighbors(snapshot, vertex, neighbors);
+        neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), vertex), neighbors.end());
+        edges.insert(edges.end(), neighbors.begin(), neighbors.end());
+        offsets.push_back(edges.size());
+    }
+
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        for (size_t e = offsets[i]; e < offsets[i + 1]; e++)
+        {
+            size_t j = std::lower_bound(vertices.begin(), vertices.end(), edges[e]) - vertices.begin();
+
+            if (j < vertices.size() && vertices[j] == edges[e])
+            {
+                total += IntersectCountScalar(edges.data() + offsets[i], offsets[i + 1] - offsets[i], edges.data() + offsets[j], offsets[j + 1] - offsets[j]);
+            }
+        }
+    }
+
+    return total;
+}
+
+//Each thread answers its share of the common neighbor queries from one snapshot
+template<typename Key>
+void *commonTest(void *arg)
+{
+    TriangleTest<Key> *test = ((ThreadArg<Key> *)arg)->test;
+    intptr_t id = ((ThreadArg<Key> *)arg)->id;
+    BasicAdjacencyList<Key> *list = test->list;
+
+    std::vector<Key> u_edges;
+    std::vector<Key> v_edges;
+    uint64_t total = 0;
+    uint64_t snapshot = list->BeginSnapshot();
+
+    for (size_t q = id; q < test->pairs.size(); q += num_thread)
+    {
+        Key u = test->pairs[q].first;
+        Key v = test->pairs[q].second;
+
+        if (test->mode == LOOKUP)
+        {
+            //One edge lookup in v for every neighbor of u
+            list->SnapshotNeighbors(snapshot, u, u_edges);
+
+            for (Key edge : u_edges)
+            {
+                total += list->SnapshotFindEdge(snapshot, v, edge);
+            }
+        }
+        else if (test->mode == MERGE)
+        {
+            list->SnapshotNeighbors(snapshot, u, u_edges);
+            list->SnapshotNeighbors(snapshot, v, v_edges);
+            total += IntersectCountScalar(u_edges.data(), u_edges.size(), v_edges.data(), v_edges.size());
+        }
+        else
+        {
+            total += list->SnapshotCommonNeighbors(snapshot, u, v);
+        }
+    }
+
+    list->EndSnapshot();
+    test->results[id] = total;
+
+    return NULL;
+}
+
+//Each thread counts the local triangles of its share of the vertices from one snapshot
+template<typename Key>
+void *triangleTest(void *arg)
+{
+    TriangleTest<Key> *test = ((ThreadArg<Key> *)arg)->test;
+    intptr_t id = ((ThreadArg<Key> *)arg)->id;
+    BasicAdjacencyList<Key> *list = test->list;
+
+    std::vector<Key> edges;
+    std::vector<Key> neighbor_edges;
+    uint64_t total = 0;
+    uint64_t snapshot = list->BeginSnapshot();
+
+    for (int v = id + 1; v <= num_vertices; v += num_thread)
+    {
+        total += test->mode == SIMD ? list->SnapshotTriangles(snapshot, v) : mergeTriangles(list, snapshot, (Key)v, edges, neighbor_edges);
+    }
+
+    list->EndSnapshot();
+    test->results[id] = total;
+
+    return NULL;
+}
+
+//Runs fn on every thread, returns the seconds taken and the sum of the thread results
+template<typename Key>
+double runThreads(TriangleTest<Key>& test, void *(*fn)(void *), uint64_t& total)
+{
+    struct timespec start, finish;
+    pthread_t thread[num_thread];
+    ThreadArg<Key> args[num_thread];
+
+    test.results.assign(num_thread, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_thread; i++)
+    {
+        args[i].test = &test;
+        args[i].id = i;
+        pthread_create(&thread[i], NULL, fn, &args[i]);
+    }
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    total = 0;
+    for (int i = 0; i < num_thread; i++)
+    {
+        total += test.results[i];
+    }
+
+    double elapsed = (finish.tv_sec - start.tv_sec);
+    elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+    return elapsed;
+}
+
+template<typename Key>
+void runTest(std::vector<std::vector<uint32_t>>& adjacency, uint64_t edge_count)
+{
+    TriangleTest<Key> test;
+    test.adjacency = &adjacency;
+
+    //Vertices are dense, every thread inserts about edge_count / num_thread edges with a pred override each
+    int ops = 3 * (edge_count / num_thread + POPULATE_TXN_OPS) + num_vertices;
+    test.list = new BasicAdjacencyList<Key>(num_thread + 1, POPULATE_TXN_OPS, ops, num_vertices + 1);
+
+    test.list->Init();
+
+    for (int v = 1; v <= num_vertices; v += POPULATE_TXN_OPS)
+    {
+        uint32_t size = std::min(POPULATE_TXN_OPS, (uint32_t)(num_vertices - v + 1));
+        BasicDesc<Key> *desc = test.list->AllocateDesc(size);
+
+        for (uint32_t t = 0; t < size; t++)
+        {
+            desc->ops[t].type = INSERT;
+            desc->ops[t].key = v + t;
+        }
+
+        if (!test.list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    uint64_t total;
+    double elapsed = runThreads(test, &populate<Key>, total);
+    printf("Populated %d vertices and %lu edges in %.2fs\n\n", num_vertices, edge_count, elapsed);
+
+    //Pairs two hops apart mostly share neighbors, random pairs of a sparse graph would not
+    boost::mt19937 randomGen;
+    randomGen.seed(2);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+
+    while ((int)test.pairs.size() < num_queries)
+    {
+        uint32_t u = vertex_dist(randomGen);
+        std::vector<uint32_t>& u_adj = adjacency[u];
+        uint32_t w = u_adj[boost::uniform_int<size_t>(0, u_adj.size() - 1)(randomGen)];
+        std::vector<uint32_t>& w_adj = adjacency[w];
+        uint32_t v = w_adj[boost::uniform_int<size_t>(0, w_adj.size() - 1)(randomGen)];
+
+        if (v != u)
+        {
+            test.pairs.push_back(std::make_pair((Key)u, (Key)v));
+        }
+    }
+
+    printf("Query, Mode, Ops/s, Result\n");
+
+    for (int mode = LOOKUP; mode <= SIMD; mode++)
+    {
+        test.mode = (Mode)mode;
+        elapsed = runThreads(test, &commonTest<Key>, total);
+        printf("common, %s, %.0f, %lu\n", mode_names[mode], num_queries / elapsed, total);
+    }
+
+    //Every undirected triangle is counted twice at each of its three vertices
+    for (int mode = MERGE; mode <= SIMD; mode++)
+    {
+        test.mode = (Mode)mode;
+        elapsed = runThreads(test, &triangleTest<Key>, total);
+        printf("triangles, %s, %.0f, %lu\n", mode_names[mode], num_vertices / elapsed, total / 6);
+    }
+
+    //The whole graph at once from the calling thread, every adjacency set is materialized a single time
+    for (int mode = MERGE; mode <= SIMD; mode++)
+    {
+        struct timespec start, finish;
+        uint64_t snapshot = test.list->BeginSnapshot();
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        if (mode == SIMD)
+        {
+            std::vector<Key> vertices;
+            std::vector<uint64_t> triangles;
+            test.list->SnapshotAllTriangles(snapshot, vertices, triangles);
+
+            total = 0;
+            for (uint64_t count : triangles)
+            {
+                total += count;
+            }
+        }
+        else
+        {
+            total = mergeAllTriangles(test.list, snapshot);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        test.list->EndSnapshot();
+
+        elapsed = (finish.tv_sec - start.tv_sec);
+        elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+        printf("all-triangles, %s, %.0f, %lu\n", mode_names[mode], num_vertices / elapsed, total / 6);
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Threads> <#Vertices> <#EdgesPerNewVertex> <#Queries> [--wide]\n", argv[0]);
+        printf("Builds a power-law graph by preferential attachment and compares common neighbor and triangle queries\n");
+        printf("--wide: use 64-bit keys\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    num_vertices = atoi(argv[2]);
+    attach_edges = atoi(argv[3]);
+    num_queries = atoi(argv[4]);
+    bool wide = argc > 5 && strcmp(argv[5], "--wide") == 0;
+
+    if (num_vertices <= attach_edges + 1)
+    {
+        printf("Error: the graph needs more vertices than edges per new vertex\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::vector<uint32_t>> adjacency;
+    generateGraph(adjacency);
+
+    uint64_t edge_count = 0;
+    size_t max_degree = 0;
+
+    for (auto& edges : adjacency)
+    {
+        edge_count += edges.size();
+        max_degree = std::max(max_degree, edges.size());
+    }
+
+    printf("Average degree %.1f, max degree %lu\n", (double)edge_count / num_vertices, max_degree);
+
+    if (wide)
+    {
+        runTest<uint64_t>(adjacency, edge_count);
+    }
+    else
+    {
+        runTest<uint32_t>(adjacency, edge_count);
+    }
+}
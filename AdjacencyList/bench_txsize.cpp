@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "ThreadData.h"
+
+int num_thread = 4;
+int ops_per_thread = 100000;
+int num_vertices = 1024;
+uint32_t transaction_size = 1;
+
+AdjacencyList *list;
+ThreadData *t_data;
+
+//Each thread commits transactions of transaction_size edge inserts, edge keys are unique per thread so only helping and cyclic dependencies abort
+void *txnTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> vertex_dist(1, num_vertices);
+
+    uint32_t next_edge = id * ops_per_thread + 1;
+
+    for (int i = 0; i + (int)transaction_size <= ops_per_thread; i += transaction_size)
+    {
+        Desc *desc = list->AllocateDesc(transaction_size);
+
+        for (uint32_t t = 0; t < transaction_size; t++)
+        {
+            desc->ops[t].type = INSERT_EDGE;
+            desc->ops[t].key = vertex_dist(randomGen);
+            desc->ops[t].edge_key = next_edge++;
+        }
+
+        if (list->ExecuteOps(desc))
+        {
+            t_data[id].g_commits++;
+        }
+        else
+        {
+            t_data[id].g_aborts++;
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 4)
+    {
+        printf("Proper format: %s <#Threads> <#OpsPerThread> <#Vertices> [<#TransactionSize> ...]\n", argv[0]);
+        printf("Measures commit throughput of edge insert transactions for each transaction size (default 1 4 16 64 256 1024 4096)\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_thread = atoi(argv[1]);
+    ops_per_thread = atoi(argv[2]);
+    num_vertices = atoi(argv[3]);
+
+    std::vector<uint32_t> sizes;
+    for (int a = 4; a < argc; a++)
+    {
+        sizes.push_back(atoi(argv[a]));
+    }
+    if (sizes.empty())
+    {
+        sizes = {1, 4, 16, 64, 256, 1024, 4096};
+    }
+
+    printf("TxnSize, Commits/s, Ops/s, Commits, Aborts\n");
+
+    for (uint32_t size : sizes)
+    {
+        transaction_size = size;
+
+        //The main thread populates the vertices as a single transaction, the workers take the remaining allocator slots
+        list = new AdjacencyList(num_thread + 1, transaction_size, 4 * std::max(ops_per_thread, num_vertices), num_vertices + 1);
+        t_data = new ThreadData[num_thread];
+
+        list->Init();
+
+        Desc *desc = list->AllocateDesc(num_vertices);
+        for (int v = 0; v < num_vertices; v++)
+        {
+            desc->ops[v].type = INSERT;
+            desc->ops[v].key = v + 1;
+        }
+
+        if (!list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        struct timespec start, finish;
+        pthread_t thread[num_thread];
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (intptr_t i = 0; i < num_thread; i++)
+        {
+            pthread_create(&thread[i], NULL, &txnTest, (void *)i);
+        }
+
+        for (int i = 0; i < num_thread; i++)
+        {
+            pthread_join(thread[i], NULL);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+
+        double elapsed = (finish.tv_sec - start.tv_sec);
+        elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+        int g_commits = 0;
+        int g_aborts = 0;
+
+        for (int i = 0; i < num_thread; i++)
+        {
+            g_commits += t_data[i].g_commits;
+            g_aborts += t_data[i].g_aborts;
+        }
+
+        printf("%u, %.0f, %.0f, %d, %d\n", size, g_commits / elapsed, ((double)g_commits * size) / elapsed, g_commits, g_aborts);
+
+        delete[] t_data;
+    }
+}
@@ -0,0 +1,292 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "AdjacencyList.h"
+#include "WriteAheadLog.h"
+#include "ThreadData.h"
+
+enum DurabilityMode
+{
+    MODE_NONE = 0,
+    MODE_ASYNC,
+    MODE_SYNC
+};
+
+const char* mode_names[] = {"none", "async", "sync"};
+
+int num_threads = 4;
+int txns_per_thread = 10000;
+int num_vertices = 1024;
+int transaction_size = 4;
+
+//Vertices each writer inserts and deletes
+const uint32_t OWNED_VERTICES = 64;
+
+AdjacencyList *list;
+ThreadData *t_data;
+volatile int threads_done = 0;
+
+uint32_t ownedKey(intptr_t id, uint32_t owned)
+{
+    return num_vertices + 1 + owned * num_threads + id;
+}
+
+void *writerTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+
+    list->Init();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> key_dist(1, num_vertices);
+    boost::uniform_int<uint32_t> op_dist(0, 9);
+
+    //Edge deletes target edges this thread inserted so most transactions commit
+    //Vertex ops flip vertices of this thread's own above the edge range, an edge insert racing with the delete of its
+    //vertex can outlive it in memory, which is not something the log can reproduce
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<bool> present(OWNED_VERTICES, false);
+    boost::uniform_int<uint32_t> owned_dist(0, OWNED_VERTICES - 1);
+
+    for (int i = 0; i < txns_per_thread; i++)
+    {
+        Desc *desc = list->AllocateDesc(transaction_size);
+        size_t edges_used = 0;
+
+        for (int t = 0; t < transaction_size; t++)
+        {
+            uint32_t op = op_dist(randomGen);
+            Operator& o = desc->ops[t];
+
+            if (op < 4 && edges_used < edges.size())
+            {
+                boost::uniform_int<size_t> pick(edges_used, edges.size() - 1);
+                std::swap(edges[edges_used], edges[pick(randomGen)]);
+                o.type = DELETE_EDGE;
+                o.key = edges[edges_used].first;
+                o.edge_key = edges[edges_used].second;
+                edges_used++;
+            }
+            else if (op < 9)
+            {
+                o.type = INSERT_EDGE;
+                o.key = key_dist(randomGen);
+                o.edge_key = key_dist(randomGen);
+            }
+            else
+            {
+                //A vertex already flipped in this transaction is flipped back
+                uint32_t owned = owned_dist(randomGen);
+                bool exists = present[owned];
+
+                for (int p = 0; p < t; p++)
+                {
+                    if (desc->ops[p].key == ownedKey(id, owned))
+                    {
+                        exists = desc->ops[p].type == INSERT;
+                    }
+                }
+
+                o.type = exists ? DELETE : INSERT;
+                o.key = ownedKey(id, owned);
+            }
+        }
+
+        if (list->ExecuteOps(desc))
+        {
+            t_data[id].g_commits++;
+
+            edges.erase(edges.begin(), edges.begin() + edges_used);
+
+            for (int t = 0; t < transaction_size; t++)
+            {
+                if (desc->ops[t].type == INSERT_EDGE)
+                {
+                    edges.push_back(std::make_pair(desc->ops[t].key, desc->ops[t].edge_key));
+                }
+                else if (desc->ops[t].type == INSERT || desc->ops[t].type == DELETE)
+                {
+                    present[(desc->ops[t].key - num_vertices - 1) / num_threads] = desc->ops[t].type == INSERT;
+                }
+            }
+        }
+        else
+        {
+            t_data[id].g_aborts++;
+        }
+    }
+
+    __sync_fetch_and_add(&threads_done, 1);
+
+    return NULL;
+}
+
+//Reads the whole graph into vertices and their sorted adjacencies
+void dumpGraph(AdjacencyList* graph, std::vector<std::vector<uint32_t>>& dump)
+{
+    std::vector<uint32_t> vertices;
+    uint64_t snapshot = graph->BeginSnapshot();
+    graph->SnapshotVertices(snapshot, vertices);
+
+    dump.clear();
+    for (uint32_t vertex : vertices)
+    {
+        dump.push_back(std::vector<uint32_t>(1, vertex));
+        std::vector<uint32_t> edges;
+        graph->SnapshotNeighbors(snapshot, vertex, edges);
+        dump.back().insert(dump.back().end(), edges.begin(), edges.end());
+    }
+
+    graph->EndSnapshot();
+}
+
+void removeLog(const std::string& path)
+{
+    unlink(path.c_str());
+    unlink((path + ".prev").c_str());
+    unlink((path + ".ckpt").c_str());
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <#Threads> <#TxnsPerThread> <#Vertices> <LogPath> [<GroupCommitUs>]\n", argv[0]);
+        printf("Reports commit throughput without a log, with a log synced in the background and with commits waiting for their group's fsync\n");
+        printf("The durable runs checkpoint once midway, then the graph is recovered from the files and compared to the one in memory\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    num_threads = atoi(argv[1]);
+    txns_per_thread = atoi(argv[2]);
+    num_vertices = atoi(argv[3]);
+    std::string log_path = argv[4];
+
+    WalConfig config;
+    if (argc > 5)
+    {
+        config.group_commit_us = atoi(argv[5]);
+    }
+
+    printf("Mode, Commits/s, Overhead, Commits, Aborts, Groups, Records/Group, Recovered\n");
+
+    double base_rate = 0;
+
+    for (int mode = MODE_NONE; mode <= MODE_SYNC; mode++)
+    {
+        //Recovery replays through the allocators of the main thread, it gets a share like the writers
+        int allocator_ops = 2 * txns_per_thread * transaction_size + num_vertices;
+        list = new AdjacencyList(num_threads + 1, transaction_size, allocator_ops);
+        t_data = new ThreadData[num_threads];
+        threads_done = 0;
+
+        list->Init();
+
+        WriteAheadLog* wal = NULL;
+        if (mode != MODE_NONE)
+        {
+            removeLog(log_path);
+            config.sync_commit = mode == MODE_SYNC;
+            wal = new WriteAheadLog(list, log_path, config);
+
+            if (wal->Open() < 0)
+            {
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        Desc *desc = list->AllocateDesc(num_vertices);
+        for (int v = 0; v < num_vertices; v++)
+        {
+            desc->ops[v].type = INSERT;
+            desc->ops[v].key = v + 1;
+        }
+
+        if (!list->ExecuteOps(desc))
+        {
+            printf("Error: populating vertices failed\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        struct timespec start, finish;
+        pthread_t threads[num_threads];
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (intptr_t i = 0; i < num_threads; i++)
+        {
+            pthread_create(&threads[i], NULL, &writerTest, (void *)i);
+        }
+
+        //Checkpoint while the writers are still running
+        if (wal != NULL)
+        {
+            usleep(1000);
+
+            if (threads_done < num_threads && !wal->Checkpoint())
+            {
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        for (int i = 0; i < num_threads; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+
+        double elapsed = (finish.tv_sec - start.tv_sec);
+        elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+        int g_commits = 0;
+        int g_aborts = 0;
+
+        for (int i = 0; i < num_threads; i++)
+        {
+            g_commits += t_data[i].g_commits;
+            g_aborts += t_data[i].g_aborts;
+        }
+
+        double rate = g_commits / elapsed;
+        if (mode == MODE_NONE)
+        {
+            base_rate = rate;
+        }
+
+        const char* recovered = "-";
+        uint64_t groups = 0;
+        uint64_t records = 0;
+
+        if (wal != NULL)
+        {
+            groups = wal->groups;
+            records = wal->records;
+            delete wal;
+
+            //Recover into a fresh list as a restarted process would
+            AdjacencyList* restored = new AdjacencyList(1, transaction_size, allocator_ops * (num_threads + 1));
+            restored->Init();
+            WriteAheadLog recovery(restored, log_path, config);
+
+            std::vector<std::vector<uint32_t>> expected;
+            std::vector<std::vector<uint32_t>> actual;
+            dumpGraph(list, expected);
+
+            recovered = recovery.Open() >= 0 && (dumpGraph(restored, actual), actual == expected) ? "match" : "MISMATCH";
+        }
+
+        printf("%s, %.0f, %.1f%%, %d, %d, %lu, %.1f, %s\n", mode_names[mode], rate, 100 * (1 - rate / base_rate),
+            g_commits, g_aborts, groups, groups ? (double)records / groups : 0, recovered);
+
+        delete[] t_data;
+    }
+
+    removeLog(log_path);
+}
@@ -0,0 +1,310 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <errno.h>
+#include <pthread.h>
+#include <boost/random.hpp>
+#include "protocol.h"
+#include "ThreadData.h"
+
+//Load generator for graph_server
+//Every connection runs on its own thread and keeps up to Pipeline requests in flight, a refill is written with one send
+//Latency is measured per request from the send that carried it to the read that returned its response
+
+const char* address;
+int num_connections = 4;
+int requests_per_connection = 100000;
+int pipeline = 64;
+int transaction_size = 4;
+int key_range = 1024;
+bool populate = false;
+
+ThreadData *t_data;
+//SERVER_EXHAUSTED responses of a server that ran out of room, not counted as aborts
+std::atomic<int> g_exhausted(0);
+//Per connection latencies in microseconds
+std::vector<std::vector<double>> latencies;
+
+uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+int connectServer()
+{
+    sockaddr_storage addr;
+    int family;
+    socklen_t addr_len = ParseAddress(address, addr, family);
+
+    if (addr_len == 0)
+    {
+        printf("Error: malformed address %s\n", address);
+        std::exit(EXIT_FAILURE);
+    }
+
+    int fd = socket(family, SOCK_STREAM, 0);
+
+    if (connect(fd, (sockaddr*)&addr, addr_len) < 0)
+    {
+        perror("Error: connect");
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (family == AF_INET)
+    {
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    }
+
+    return fd;
+}
+
+void sendAll(int fd, const std::vector<char>& buffer)
+{
+    size_t sent = 0;
+
+    while (sent < buffer.size())
+    {
+        ssize_t n = send(fd, buffer.data() + sent, buffer.size() - sent, MSG_NOSIGNAL);
+
+        if (n < 0)
+        {
+            perror("Error: send");
+            std::exit(EXIT_FAILURE);
+        }
+
+        sent += n;
+    }
+}
+
+void appendRequest(std::vector<char>& buffer, uint32_t request_id, const std::vector<WireOp>& ops)
+{
+    RequestHeader header;
+    header.request_id = request_id;
+    header.op_count = ops.size();
+
+    const char* bytes = (const char*)&header;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(header));
+    bytes = (const char*)ops.data();
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(WireOp) * ops.size());
+}
+
+//Reads at least one response, calls handle for every complete response in the buffer
+template<typename Handler>
+void readResponses(int fd, std::vector<char>& in, Handler handle)
+{
+    char chunk[64 * 1024];
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+
+    if (n <= 0)
+    {
+        printf("Error: server closed the connection\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    in.insert(in.end(), chunk, chunk + n);
+
+    size_t pos = 0;
+    while (in.size() - pos >= sizeof(ResponseFrame))
+    {
+        ResponseFrame frame;
+        memcpy(&frame, in.data() + pos, sizeof(frame));
+        handle(frame);
+        pos += sizeof(ResponseFrame);
+    }
+
+    in.erase(in.begin(), in.begin() + pos);
+}
+
+//Inserts the vertices [1, key_range] so the edge ops have something to work on
+void populateVertices()
+{
+    int fd = connectServer();
+    std::vector<char> out;
+    std::vector<char> in;
+    std::vector<WireOp> ops;
+    uint32_t requests = 0;
+
+    for (int key = 1; key <= key_range; key++)
+    {
+        ops.push_back({INSERT, (uint32_t)key, 0});
+
+        if (ops.size() == MAX_WIRE_OPS || key == key_range)
+        {
+            appendRequest(out, requests++, ops);
+            ops.clear();
+        }
+    }
+
+    sendAll(fd, out);
+
+    uint32_t responses = 0;
+    while (responses < requests)
+    {
+        readResponses(fd, in, [&](const ResponseFrame& frame)
+        {
+            if (frame.status != COMMITTED)
+            {
+                printf(frame.status == SERVER_EXHAUSTED ? "Error: the server has no room to populate the vertices\n" : "Error: populating vertices failed\n");
+                std::exit(EXIT_FAILURE);
+            }
+
+            responses++;
+        });
+    }
+
+    close(fd);
+}
+
+void *connectionTest(void *threadid)
+{
+    intptr_t id = (intptr_t)threadid;
+    int fd = connectServer();
+
+    boost::mt19937 randomGen;
+    randomGen.seed(id + 1);
+    boost::uniform_int<uint32_t> key_dist(1, key_range);
+    boost::uniform_int<uint32_t> type_dist(0, 3);
+
+    std::vector<uint64_t> sent_at(requests_per_connection);
+    std::vector<double>& latency = latencies[id];
+    latency.reserve(requests_per_connection);
+
+    std::vector<char> out;
+    std::vector<char> in;
+    std::vector<WireOp> ops(transaction_size);
+    int sent = 0;
+    int received = 0;
+
+    while (received < requests_per_connection)
+    {
+        //Top the pipeline up with a single send
+        out.clear();
+        uint64_t now = nowNs();
+
+        while (sent < requests_per_connection && sent - received < pipeline)
+        {
+            for (int t = 0; t < transaction_size; t++)
+            {
+                ops[t].type = type_dist(randomGen) ? INSERT_EDGE : DELETE_EDGE;
+                ops[t].key = key_dist(randomGen);
+                ops[t].edge_key = key_dist(randomGen);
+            }
+
+            sent_at[sent] = now;
+            appendRequest(out, sent, ops);
+            sent++;
+        }
+
+        if (!out.empty())
+        {
+            sendAll(fd, out);
+        }
+
+        readResponses(fd, in, [&](const ResponseFrame& frame)
+        {
+            latency.push_back((nowNs() - sent_at[frame.request_id]) / 1000.0);
+
+            if (frame.status == COMMITTED)
+            {
+                t_data[id].g_commits++;
+            }
+            else if (frame.status == SERVER_EXHAUSTED)
+            {
+                g_exhausted++;
+            }
+            else
+            {
+                t_data[id].g_aborts++;
+            }
+
+            received++;
+        });
+    }
+
+    close(fd);
+
+    return NULL;
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 7)
+    {
+        printf("Proper format: %s <Address> <#Connections> <#RequestsPerConnection> <#Pipeline> <#TransactionSize> <#KeyRange> [--populate]\n", argv[0]);
+        printf("Address is unix:<path> or tcp:<port> on loopback\n");
+        printf("--populate: insert the vertices [1, KeyRange] before the measured run\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    address = argv[1];
+    num_connections = atoi(argv[2]);
+    requests_per_connection = atoi(argv[3]);
+    pipeline = atoi(argv[4]);
+    transaction_size = atoi(argv[5]);
+    key_range = atoi(argv[6]);
+
+    for (int a = 7; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--populate") == 0)
+        {
+            populate = true;
+        }
+        else
+        {
+            printf("Unknown option %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (populate)
+    {
+        populateVertices();
+    }
+
+    t_data = new ThreadData[num_connections];
+    latencies.resize(num_connections);
+
+    struct timespec start, finish;
+    pthread_t threads[num_connections];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (intptr_t i = 0; i < num_connections; i++)
+    {
+        pthread_create(&threads[i], NULL, &connectionTest, (void *)i);
+    }
+
+    for (int i = 0; i < num_connections; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double elapsed = (finish.tv_sec - start.tv_sec);
+    elapsed += (finish.tv_nsec - start.tv_nsec) / (double)1000000000.0;
+
+    int g_commits = 0;
+    int g_aborts = 0;
+    std::vector<double> all;
+
+    for (int i = 0; i < num_connections; i++)
+    {
+        g_commits += t_data[i].g_commits;
+        g_aborts += t_data[i].g_aborts;
+        all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+    }
+
+    std::sort(all.begin(), all.end());
+
+    printf("Requests/s %.0f\n", (g_commits + g_aborts + g_exhausted) / elapsed);
+    printf("Total Commits %d, Total Aborts: %d, Server Exhausted: %d \n", g_commits, g_aborts, g_exhausted.load());
+    printf("Latency us p50 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n",
+        all[all.size() / 2], all[all.size() * 99 / 100], all[all.size() * 999 / 1000], all.back());
+}
@@ -0,0 +1,561 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "AdjacencyList.h"
+#include "TxnExecutor.h"
+#include "protocol.h"
+
+//Serves the graph over the binary protocol in protocol.h
+//The main thread accepts connections and hands them round robin to the I/O threads, each running its own epoll loop
+//An I/O thread parses every complete request it has read and submits it to the TxnExecutor without waiting for earlier ones
+//Completion callbacks run on the executors, they queue the response to the connection's I/O thread and wake it through an eventfd
+//Responses that complete together are written to the socket together
+
+struct IOThread;
+
+struct Connection
+{
+    ~Connection()
+    {
+        free(in);
+    }
+
+    int fd;
+    IOThread* io;
+    //Bytes read but not yet parsed into requests are in[0, in_used), the buffer grows but is never cleared
+    char* in;
+    size_t in_used;
+    size_t in_capacity;
+    //Responses not yet accepted by the socket, starting at out_sent
+    std::vector<char> out;
+    size_t out_sent;
+    bool want_write;
+    bool closed;
+    //One reference for the open socket and one per request in flight, only touched by the I/O thread
+    uint32_t refs;
+};
+
+struct Completion
+{
+    Connection* conn;
+    ResponseFrame frame;
+};
+
+struct IOThread
+{
+    int epoll_fd;
+    int event_fd;
+    std::thread thread;
+
+    //Filled by completion callbacks on the executors
+    std::mutex lock;
+    std::vector<Completion> completions;
+};
+
+//Handed to a completion callback
+struct PendingTxn
+{
+    Connection* conn;
+    uint32_t request_id;
+};
+
+static const size_t READ_CHUNK = 64 * 1024;
+//Allocations of one executor an admitted op is charged for, its own run and one helper's, see g_budget
+static const uint32_t ALLOCS_PER_OP = 2;
+
+volatile sig_atomic_t stop = 0;
+std::atomic<bool> io_running(true);
+
+TxnExecutor* executor;
+std::atomic<uint64_t> g_requests(0);
+std::atomic<uint64_t> g_commits(0);
+std::atomic<uint64_t> g_aborts(0);
+std::atomic<uint64_t> g_exhausted(0);
+//Ops the server still admits over all executors, requests that do not fit are answered with SERVER_EXHAUSTED
+//Stealing and helping can still leave one executor short of room, it then finishes the request EXHAUSTED itself,
+//see ExecutorConfig::room_per_op, so remote input never runs an allocator out
+std::atomic<uint64_t> g_budget(0);
+
+void onSignal(int)
+{
+    stop = 1;
+}
+
+void release(Connection* conn)
+{
+    if (--conn->refs == 0)
+    {
+        delete conn;
+    }
+}
+
+void closeConnection(Connection* conn)
+{
+    if (conn->closed)
+    {
+        return;
+    }
+
+    conn->closed = true;
+    epoll_ctl(conn->io->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    release(conn);
+}
+
+//Hands a response to the I/O thread of conn, which holds a reference for it until it is queued for sending
+void queueResponse(Connection* conn, uint32_t request_id, uint8_t status)
+{
+    IOThread* io = conn->io;
+
+    Completion completion;
+    completion.conn = conn;
+    completion.frame.request_id = request_id;
+    completion.frame.status = status;
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> guard(io->lock);
+        //Only the first completion of a round needs to wake the I/O thread
+        wake = io->completions.empty();
+        io->completions.push_back(completion);
+    }
+
+    if (wake)
+    {
+        uint64_t one = 1;
+        if (write(io->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        {
+            perror("eventfd write");
+        }
+    }
+}
+
+//Runs on an executor thread, or on the I/O thread if the transaction finished before the callback was registered
+void onTxnComplete(void* arg, uint8_t status)
+{
+    PendingTxn* pending = (PendingTxn*)arg;
+
+    if (status == COMMITTED)
+    {
+        g_commits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (status == ABORTED)
+    {
+        g_aborts.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        g_exhausted.fetch_add(1, std::memory_order_relaxed);
+        status = SERVER_EXHAUSTED;
+    }
+
+    queueResponse(pending->conn, pending->request_id, status);
+    delete pending;
+}
+
+//Takes op_count ops from the budget, false if fewer are left
+bool admit(uint32_t op_count)
+{
+    uint64_t budget = g_budget.load();
+
+    do
+    {
+        if (budget < op_count)
+        {
+            return false;
+        }
+    }
+    while (!g_budget.compare_exchange_weak(budget, budget - op_count));
+
+    return true;
+}
+
+void flush(Connection* conn)
+{
+    while (conn->out_sent < conn->out.size())
+    {
+        ssize_t sent = send(conn->fd, conn->out.data() + conn->out_sent, conn->out.size() - conn->out_sent, MSG_NOSIGNAL);
+
+        if (sent < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+
+            closeConnection(conn);
+            return;
+        }
+
+        conn->out_sent += sent;
+    }
+
+    if (conn->out_sent == conn->out.size())
+    {
+        conn->out.clear();
+        conn->out_sent = 0;
+    }
+
+    //Only ask for writability while the socket is backed up
+    bool want_write = !conn->out.empty();
+    if (want_write != conn->want_write)
+    {
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP | (want_write ? EPOLLOUT : 0);
+        event.data.ptr = conn;
+        epoll_ctl(conn->io->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+        conn->want_write = want_write;
+    }
+}
+
+//Submits every complete request in the read buffer, returns false if the connection sent a malformed request
+bool submitRequests(Connection* conn, std::vector<Operator>& ops)
+{
+    size_t pos = 0;
+
+    while (conn->in_used - pos >= sizeof(RequestHeader))
+    {
+        RequestHeader header;
+        memcpy(&header, conn->in + pos, sizeof(header));
+
+        if (header.op_count == 0 || header.op_count > MAX_WIRE_OPS)
+        {
+            return false;
+        }
+
+        size_t frame_size = sizeof(RequestHeader) + header.op_count * sizeof(WireOp);
+        if (conn->in_used - pos < frame_size)
+        {
+            break;
+        }
+
+        const WireOp* wire_ops = (const WireOp*)(conn->in + pos + sizeof(RequestHeader));
+        ops.resize(header.op_count);
+
+        for (uint32_t i = 0; i < header.op_count; i++)
+        {
+            //The wire format has no room for properties, SET_PROPERTY is refused with the unknown types
+            if (wire_ops[i].type > DELETE_EDGE)
+            {
+                return false;
+            }
+
+            ops[i].type = wire_ops[i].type;
+            ops[i].key = wire_ops[i].key;
+            ops[i].edge_key = wire_ops[i].edge_key;
+        }
+
+        conn->refs++;
+        g_requests.fetch_add(1, std::memory_order_relaxed);
+
+        if (admit(header.op_count))
+        {
+            PendingTxn* pending = new PendingTxn();
+            pending->conn = conn;
+            pending->request_id = header.request_id;
+
+            executor->Submit(ops.data(), header.op_count).OnComplete(&onTxnComplete, pending);
+        }
+        else
+        {
+            g_exhausted.fetch_add(1, std::memory_order_relaxed);
+            queueResponse(conn, header.request_id, SERVER_EXHAUSTED);
+        }
+
+        pos += frame_size;
+    }
+
+    conn->in_used -= pos;
+    memmove(conn->in, conn->in + pos, conn->in_used);
+
+    return true;
+}
+
+void readConnection(Connection* conn, std::vector<Operator>& ops)
+{
+    while (true)
+    {
+        //Grown to hold the largest request, the bytes past in_used are never initialized
+        if (conn->in_capacity - conn->in_used < READ_CHUNK)
+        {
+            conn->in_capacity = std::max(conn->in_capacity * 2, conn->in_used + READ_CHUNK);
+            conn->in = (char*)realloc(conn->in, conn->in_capacity);
+
+            if (conn->in == NULL)
+            {
+                printf("Error: out of memory for a read buffer\n");
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        ssize_t received = recv(conn->fd, conn->in + conn->in_used, conn->in_capacity - conn->in_used, 0);
+
+        if (received <= 0)
+        {
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                return;
+            }
+
+            closeConnection(conn);
+            return;
+        }
+
+        conn->in_used += received;
+
+        if (!submitRequests(conn, ops))
+        {
+            printf("Closing connection after a malformed request\n");
+            closeConnection(conn);
+            return;
+        }
+    }
+}
+
+void drainCompletions(IOThread* io, std::vector<Completion>& completions, std::vector<Connection*>& touched)
+{
+    uint64_t count;
+    if (read(io->event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+    {
+        perror("eventfd read");
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(io->lock);
+        completions.swap(io->completions);
+    }
+
+    for (Completion& completion : completions)
+    {
+        Connection* conn = completion.conn;
+
+        if (!conn->closed)
+        {
+            //A touched connection holds a reference until it is flushed, reading may close it in the meantime
+            if (conn->out.empty())
+            {
+                conn->refs++;
+                touched.push_back(conn);
+            }
+
+            const char* frame = (const char*)&completion.frame;
+            conn->out.insert(conn->out.end(), frame, frame + sizeof(ResponseFrame));
+        }
+
+        release(conn);
+    }
+
+    completions.clear();
+}
+
+void ioLoop(IOThread* io)
+{
+    epoll_event events[64];
+    std::vector<Operator> ops;
+    std::vector<Completion> completions;
+    std::vector<Connection*> touched;
+
+    while (io_running.load())
+    {
+        int count = epoll_wait(io->epoll_fd, events, 64, 100);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.ptr == io)
+            {
+                drainCompletions(io, completions, touched);
+                continue;
+            }
+
+            Connection* conn = (Connection*)events[i].data.ptr;
+
+            if (conn->closed)
+            {
+                continue;
+            }
+
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+                readConnection(conn, ops);
+            }
+
+            if (!conn->closed && (events[i].events & EPOLLOUT))
+            {
+                flush(conn);
+            }
+        }
+
+        //One write per connection for all the responses gathered this round
+        for (Connection* conn : touched)
+        {
+            if (!conn->closed)
+            {
+                flush(conn);
+            }
+
+            release(conn);
+        }
+
+        touched.clear();
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 5)
+    {
+        printf("Proper format: %s <Address> <#IOThreads> <#Executors> <#OpsPerExecutor> [--dense <KeyRange>]\n", argv[0]);
+        printf("Address is unix:<path> or tcp:<port> on loopback\n");
+        printf("OpsPerExecutor sizes the allocators of each executor, the server runs #Executors * OpsPerExecutor / %u ops in all\n", ALLOCS_PER_OP);
+        printf("and answers the requests past that, or past the room left on the executor that takes them, with SERVER_EXHAUSTED\n");
+        std::exit(EXIT_FAILURE);
+    }
+
+    const char* address = argv[1];
+    int num_io = atoi(argv[2]);
+    int num_executors = atoi(argv[3]);
+    int ops = atoi(argv[4]);
+    uint32_t dense_range = 0;
+
+    for (int a = 5; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--dense") == 0 && a + 1 < argc)
+        {
+            dense_range = atoi(argv[++a]) + 1;
+        }
+        else
+        {
+            printf("Unknown option %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    sockaddr_storage addr;
+    int family;
+    socklen_t addr_len = ParseAddress(address, addr, family);
+
+    if (addr_len == 0)
+    {
+        printf("Error: malformed address %s\n", address);
+        std::exit(EXIT_FAILURE);
+    }
+
+    int listen_fd = socket(family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (family == AF_UNIX)
+    {
+        unlink(((sockaddr_un*)&addr)->sun_path);
+    }
+
+    if (bind(listen_fd, (sockaddr*)&addr, addr_len) < 0 || listen(listen_fd, 128) < 0)
+    {
+        perror("Error: listen");
+        std::exit(EXIT_FAILURE);
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    AdjacencyList* list = new AdjacencyList(num_executors, 1, ops, dense_range);
+    g_budget = (uint64_t)num_executors * ops / ALLOCS_PER_OP;
+    ExecutorConfig config;
+    config.room_per_op = ALLOCS_PER_OP;
+    executor = new TxnExecutor(list, num_executors, config);
+
+    std::vector<IOThread*> io_threads;
+    for (int i = 0; i < num_io; i++)
+    {
+        IOThread* io = new IOThread();
+        io->epoll_fd = epoll_create1(0);
+        io->event_fd = eventfd(0, EFD_NONBLOCK);
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = io;
+        epoll_ctl(io->epoll_fd, EPOLL_CTL_ADD, io->event_fd, &event);
+
+        io->thread = std::thread(ioLoop, io);
+        io_threads.push_back(io);
+    }
+
+    printf("Listening on %s\n", address);
+    fflush(stdout);
+
+    uint32_t next_io = 0;
+
+    while (!stop)
+    {
+        pollfd pfd;
+        pfd.fd = listen_fd;
+        pfd.events = POLLIN;
+
+        if (poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        int fd;
+        while ((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK)) >= 0)
+        {
+            if (family == AF_INET)
+            {
+                int nodelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            }
+
+            Connection* conn = new Connection();
+            conn->fd = fd;
+            conn->io = io_threads[next_io++ % num_io];
+            conn->in = NULL;
+            conn->in_used = 0;
+            conn->in_capacity = 0;
+            conn->out_sent = 0;
+            conn->want_write = false;
+            conn->closed = false;
+            conn->refs = 1;
+
+            epoll_event event;
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.ptr = conn;
+            epoll_ctl(conn->io->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        }
+    }
+
+    close(listen_fd);
+    if (family == AF_UNIX)
+    {
+        unlink(((sockaddr_un*)&addr)->sun_path);
+    }
+
+    io_running.store(false);
+    for (IOThread* io : io_threads)
+    {
+        io->thread.join();
+    }
+
+    //Runs what is still queued, the completions land on I/O threads that no longer send them
+    delete executor;
+
+    for (IOThread* io : io_threads)
+    {
+        close(io->epoll_fd);
+        close(io->event_fd);
+        delete io;
+    }
+
+    printf("Requests %lu, Commits %lu, Aborts %lu, Exhausted %lu\n", g_requests.load(), g_commits.load(), g_aborts.load(), g_exhausted.load());
+}
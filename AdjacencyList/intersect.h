@@ -0,0 +1,165 @@
+#pragma once
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//Sizes of the intersection of two sorted sets of unique keys
+
+//A set this many times larger than the other is searched for each key of the smaller one instead of merged
+static const size_t GALLOP_RATIO = 32;
+
+//Branchy merge, the reference the vector kernels are checked against
+template<typename Key>
+inline size_t IntersectCountScalar(const Key* a, size_t na, const Key* b, size_t nb)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+        {
+            i++;
+        }
+        else if (b[j] < a[i])
+        {
+            j++;
+        }
+        else
+        {
+            count++;
+            i++;
+            j++;
+        }
+    }
+
+    return count;
+}
+
+//Looks up every key of the small set in the large one, each search resumes where the previous one stopped
+//The window doubles until it passes the key, then a binary search finds it within the window
+template<typename Key>
+inline size_t IntersectCountGallop(const Key* small, size_t n_small, const Key* large, size_t n_large)
+{
+    size_t count = 0;
+    size_t low = 0;
+
+    for (size_t i = 0; i < n_small && low < n_large; i++)
+    {
+        Key key = small[i];
+        size_t step = 1;
+        size_t high = low;
+
+        while (high < n_large && large[high] < key)
+        {
+            low = high + 1;
+            high += step;
+            step <<= 1;
+        }
+
+        const Key* found = std::lower_bound(large + low, large + std::min(high + 1, n_large), key);
+        low = found - large;
+
+        if (low < n_large && *found == key)
+        {
+            count++;
+            low++;
+        }
+    }
+
+    return count;
+}
+
+//Vector merge of whole blocks of keys, specialized below for the key widths SSE2 compares
+template<typename Key>
+inline size_t IntersectCountBlocks(const Key* a, size_t na, const Key* b, size_t nb)
+{
+    return IntersectCountScalar(a, na, b, nb);
+}
+
+//Picks galloping for sets of very different sizes, the block merge otherwise
+template<typename Key>
+inline size_t IntersectCount(const Key* a, size_t na, const Key* b, size_t nb)
+{
+    if (na * GALLOP_RATIO < nb)
+    {
+        return IntersectCountGallop(a, na, b, nb);
+    }
+
+    if (nb * GALLOP_RATIO < na)
+    {
+        return IntersectCountGallop(b, nb, a, na);
+    }
+
+    return IntersectCountBlocks(a, na, b, nb);
+}
+
+#ifdef __SSE2__
+//Set lanes of a 4 bit movemask, __builtin_popcount would be a library call without -mpopcnt
+static const uint8_t LANE_COUNT[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+//Compares a block of 4 keys of a against every rotation of a block of 4 keys of b, then advances the block with the smaller last key
+//A key of a matches at most one key of b, so each match sets one lane. The remainder is merged one key at a time
+template<>
+inline size_t IntersectCountBlocks<uint32_t>(const uint32_t* a, size_t na, const uint32_t* b, size_t nb)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+
+    while (i + 4 <= na && j + 4 <= nb)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+
+        __m128i match = _mm_cmpeq_epi32(va, vb);
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+
+        count += LANE_COUNT[_mm_movemask_ps(_mm_castsi128_ps(match))];
+
+        uint32_t a_last = a[i + 3];
+        uint32_t b_last = b[j + 3];
+
+        i += a_last <= b_last ? 4 : 0;
+        j += b_last <= a_last ? 4 : 0;
+    }
+
+    return count + IntersectCountScalar(a + i, na - i, b + j, nb - j);
+}
+
+//SSE2 has no 64-bit compare, two 32-bit halves are equal when both of their lanes are
+template<>
+inline size_t IntersectCountBlocks<uint64_t>(const uint64_t* a, size_t na, const uint64_t* b, size_t nb)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+
+    while (i + 2 <= na && j + 2 <= nb)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+
+        __m128i half = _mm_cmpeq_epi32(va, vb);
+        __m128i match = _mm_and_si128(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        half = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        match = _mm_or_si128(match, _mm_and_si128(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1))));
+
+        count += LANE_COUNT[_mm_movemask_pd(_mm_castsi128_pd(match))];
+
+        uint64_t a_last = a[i + 1];
+        uint64_t b_last = b[j + 1];
+
+        i += a_last <= b_last ? 2 : 0;
+        j += b_last <= a_last ? 2 : 0;
+    }
+
+    return count + IntersectCountScalar(a + i, na - i, b + j, nb - j);
+}
+#endif
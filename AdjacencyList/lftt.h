@@ -7,6 +7,8 @@ enum OpStatus
     ACTIVE = 0,
     COMMITTED,
     ABORTED,
+    //Every op of a cross-shard transaction's part is done, the part commits or aborts with the other parts, see BasicCoordinator
+    PREPARED
 };
 
 enum ReturnCode
@@ -23,37 +25,94 @@ enum OpType
     INSERT,
     DELETE,
     INSERT_EDGE,
-    DELETE_EDGE
+    DELETE_EDGE,
+    //Replaces the property of an existing vertex, a FIND otherwise
+    SET_PROPERTY
 };
 
-struct Operator
+//Properties are variable sized and handed out in PROPERTY_UNIT steps
+static const uint64_t PROPERTY_UNIT = 8;
+
+//Opaque bytes attached to a vertex, written once and never changed, a new value is a new Property
+struct Property
+{
+    static uint64_t Units(uint32_t size)
+    {
+        return (sizeof(Property) + size + PROPERTY_UNIT - 1) / PROPERTY_UNIT;
+    }
+
+    uint32_t size;
+    uint8_t data[];
+};
+
+//Everything that holds a vertex or edge key is a template over the key type, the typedefs below are the 32-bit instances
+template<typename Key>
+struct BasicOperator
 {
     uint8_t type;
-    uint32_t key;
-    uint32_t edge_key;
+    Key key;
+    Key edge_key;
+    //Property an INSERT or SET_PROPERTY gives the vertex, NULL for none
+    const Property* property;
 };
 
-struct Desc
+//Descriptors are variable sized and handed out in DESC_UNIT steps
+static const uint64_t DESC_UNIT = 8;
+//BasicDesc::commit_ts while a thread draws the timestamp from the clock, see CommitTs
+static const uint64_t COMMIT_TS_DRAWING = ~0ull;
+
+template<typename Key>
+struct BasicCoordinator;
+
+template<typename Key>
+struct BasicDesc
 {
-    static size_t SizeOf(uint8_t size)
+    static size_t SizeOf(uint32_t size)
     {
-        return sizeof(uint8_t) + sizeof(uint8_t) + sizeof(Operator) * size + sizeof(bool) * size;
+        return sizeof(BasicDesc) + sizeof(BasicOperator<Key>) * size + sizeof(bool) * size;
     }
 
-    // Status of the transaction: values in [0, size] means live txn, values -1 means aborted, value -2 means committed.
+    static uint64_t Units(uint32_t size)
+    {
+        return (SizeOf(size) + DESC_UNIT - 1) / DESC_UNIT;
+    }
+
+    //The pending flags are stored right after the ops
+    bool* Pending()
+    {
+        return (bool*)(ops + size);
+    }
+
+    //OpStatus of the transaction: ACTIVE while its ops run, then COMMITTED or ABORTED for good
+    //A part of a cross-shard transaction goes through PREPARED once all its ops are done, until its coordinator decides
     volatile uint8_t status;
-    uint8_t size;
-    Operator ops[];
-    bool pending[];
+    uint32_t size;
+    //Position in the commit order, 0 until the first thread that needs it after commit draws one from the clock
+    //COMMIT_TS_DRAWING while it is drawn
+    volatile uint64_t commit_ts;
+    //Log sequence number of the commit record, 0 until the transaction is logged
+    volatile uint64_t wal_lsn;
+    //Set when this is one shard's part of a cross-shard transaction
+    BasicCoordinator<Key>* coordinator;
+    BasicOperator<Key> ops[];
 };
 
-struct NodeDesc
+template<typename Key>
+struct BasicNodeDesc
 {
-    NodeDesc(Desc* _desc, uint8_t _opid)
+    BasicNodeDesc(BasicDesc<Key>* _desc, uint32_t _opid)
         : desc(_desc), opid(_opid){}
 
-    Desc* desc;
-    uint8_t opid;
+    BasicDesc<Key>* desc;
+    uint32_t opid;
     bool override_as_find = false;
     bool override_as_delete = false;
-};
\ No newline at end of file
+    //Descriptor this one replaced in the same node or slot, snapshot reads walk back to the version they see
+    BasicNodeDesc* prev = NULL;
+    //Property of the vertex once this descriptor's transaction commits, set before a vertex descriptor is installed
+    const Property* property = NULL;
+};
+
+typedef BasicOperator<uint32_t> Operator;
+typedef BasicDesc<uint32_t> Desc;
+typedef BasicNodeDesc<uint32_t> NodeDesc;
@@ -1,5 +1,6 @@
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <cassert>
 #include <vector>
 #include <stdlib.h>
@@ -13,6 +14,8 @@
 #include <iomanip>
 #include "AdjacencyList.h"
 #include "ThreadData.h"
+#include "perf_counters.h"
+#include "workload.h"
 
 //Default Values
 int test_size = 10000;
@@ -24,65 +27,39 @@ double delete_vertex_ratio = .4;
 double insert_edge_ratio = .1;
 double delete_edge_ratio = .1;
 double find_ratio = 0;
-
-double insert_percent = (insert_vertex_ratio * 100);
-double delete_percent = insert_percent + (delete_vertex_ratio * 100);
-double insert_edge_percent = delete_percent + (insert_edge_ratio * 100);
-double delete_edge_percent = insert_edge_percent + (delete_edge_ratio * 100);
-double find_percent = delete_edge_percent + (find_ratio * 100);
+bool dense = false;
+bool ordered = false;
+bool perf = false;
+bool populate = false;
+//R-MAT edges per vertex the graph starts with, 0 for none
+int rmat_edge_factor = 0;
+const char* trace_path = NULL;
 
 AdjacencyList *list;
 ThreadData *t_data;
+PerfCounters *perf_counters;
 
 void *listTest(void *threadid)
 {
 	list->Init();
 
-    boost::mt19937 randomGen;
-    randomGen.seed(time(0));
-    boost::uniform_int<uint32_t> key_dist(1, key_range);
-    boost::uniform_int<uint32_t> operation_dist(0, 100);
+    //Each thread draws its own sequence, of the edges of the R-MAT graph when the list starts with one
+    OpMix mix = {"main", insert_vertex_ratio, delete_vertex_ratio, insert_edge_ratio, delete_edge_ratio, find_ratio};
+    RmatGenerator rmat(key_range, time(0) + (intptr_t)threadid);
+    WorkloadGenerator workload(mix, key_range, time(0) + (intptr_t)threadid, rmat_edge_factor > 0 ? &rmat : NULL);
+
+    //Only the transactions are counted, not the set up above
+    PerfCounters* counters = perf ? &perf_counters[(intptr_t)threadid] : NULL;
+    if (counters != NULL && counters->Open() > 0)
+    {
+        counters->Start();
+    }
 
     for(int i = 0; i < test_size; i++)
     {
     	Desc *desc = list->AllocateDesc(transaction_size);
 
-        for(int t = 0; t < transaction_size; t++)
-        {
-            int op = operation_dist(randomGen);
-
-	        if (op <= insert_percent)
-	        {
-                //std::cout << "Inserting\n";
-	            desc->ops[t].type = INSERT;
-	            desc->ops[t].key = key_dist(randomGen);
-	        }
-	        else if (op <= delete_percent)
-	        {
-                //std::cout << "Deleting\n";
-	            desc->ops[t].type = DELETE;
-	            desc->ops[t].key = key_dist(randomGen);
-	        }
-	        else if (op <= insert_edge_percent)
-	        {
-                //std::cout << "Inserting Edge\n";
-	        	desc->ops[t].type = INSERT_EDGE;
-	            desc->ops[t].key = key_dist(randomGen);
-	            desc->ops[t].edge_key = key_dist(randomGen);
-	        }
-	        else if (op <= delete_edge_percent)
-	        {
-                //std::cout << "Deleting Edge\n";
-	        	desc->ops[t].type = DELETE_EDGE;
-	            desc->ops[t].key = key_dist(randomGen);
-	            desc->ops[t].edge_key = key_dist(randomGen);
-	        }
-	        else if (op <= find_percent)
-	        {
-	        	desc->ops[t].type = FIND;
-	            desc->ops[t].key = key_dist(randomGen);
-	        }
-        }
+        workload.Fill(desc);
 
         if (list->ExecuteOps(desc))
         {
@@ -93,24 +70,127 @@ void *listTest(void *threadid)
             t_data[(intptr_t)threadid].g_aborts++;
         }
     }
+
+    if (counters != NULL)
+    {
+        counters->Stop();
+        counters->Close();
+    }
+
+    return NULL;
 }
 
+//Prints each counter per committed op, over all threads and then for every thread
+void reportPerf()
+{
+    uint32_t available = 0;
+
+    for (int i = 0; i < num_thread; i++)
+    {
+        available |= perf_counters[i].available;
+    }
+
+    if (available == 0)
+    {
+        printf("Perf counters unavailable: %s\n", strerror(perf_counters[0].error));
+        return;
+    }
+
+    printf("\nPer committed op (total, then per thread)\n");
+
+    for (int event = 0; event < PerfCounters::NUM_EVENTS; event++)
+    {
+        if (!(available & (1 << event)))
+        {
+            printf("%s unavailable\n", PerfCounters::Name(event));
+            continue;
+        }
+
+        uint64_t total = 0;
+        uint64_t total_ops = 0;
+
+        for (int i = 0; i < num_thread; i++)
+        {
+            if (perf_counters[i].Available(event))
+            {
+                total += perf_counters[i].values[event];
+                total_ops += (uint64_t)t_data[i].g_commits * transaction_size;
+            }
+        }
+
+        printf("%s %.1f:", PerfCounters::Name(event), total_ops ? (double)total / total_ops : 0);
+
+        for (int i = 0; i < num_thread; i++)
+        {
+            uint64_t ops = (uint64_t)t_data[i].g_commits * transaction_size;
+            printf(" %.1f", perf_counters[i].Available(event) && ops ? (double)perf_counters[i].values[event] / ops : 0);
+        }
+
+        printf("\n");
+    }
+
+    if ((available & (1 << PerfCounters::CYCLES)) && (available & (1 << PerfCounters::INSTRUCTIONS)))
+    {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+
+        for (int i = 0; i < num_thread; i++)
+        {
+            cycles += perf_counters[i].values[PerfCounters::CYCLES];
+            instructions += perf_counters[i].values[PerfCounters::INSTRUCTIONS];
+        }
+
+        printf("IPC %.2f\n", cycles ? (double)instructions / cycles : 0);
+    }
+}
+
+//Inserts the vertices [1, KeyRange], then with --rmat the edges of an R-MAT graph over them, transaction_size ops per transaction
+//Runs before the timed phase, on an allocator slot of its own
 void prePopulateList()
 {
     list->Init();
-    
-    for (int i = 1; i < key_range; i++)
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    if (rmat_edge_factor > 0)
     {
-        Desc *desc = list->AllocateDesc(transaction_size);
+        RmatGenerator rmat(key_range, 1);
+        rmat.Edges((uint64_t)rmat_edge_factor * key_range / 2, edges);
+    }
+
+    uint64_t count = key_range + edges.size();
+
+    for (uint64_t i = 0; i < count; i += transaction_size)
+    {
+        uint32_t size = std::min<uint64_t>(transaction_size, count - i);
+        Desc *desc = list->AllocateDesc(size);
 
-        desc->ops[0].type = INSERT;
-        desc->ops[0].key = i;
+        for (uint32_t t = 0; t < size; t++)
+        {
+            uint64_t op = i + t;
+
+            if (op < (uint64_t)key_range)
+            {
+                desc->ops[t].type = INSERT;
+                desc->ops[t].key = op + 1;
+                desc->ops[t].edge_key = 0;
+            }
+            else
+            {
+                desc->ops[t].type = INSERT_EDGE;
+                desc->ops[t].key = edges[op - key_range].first;
+                desc->ops[t].edge_key = edges[op - key_range].second;
+            }
+        }
 
         if (!list->ExecuteOps(desc))
         {
-            std::cout << "Error\n";
+            printf("Error: populating the graph failed\n");
+            std::exit(EXIT_FAILURE);
         }
     }
+
+    printf("Populated %d vertices and %lu edges\n", key_range, edges.size());
 }
 
 int main(int argc, const char *argv[])
@@ -118,10 +198,18 @@ int main(int argc, const char *argv[])
 	struct timespec start, finish;
     double elapsed;
 
-    if (argc < 9)
+    if (argc < 10)
     {
-        printf("Proper format: %s <#TestSize> <#TransactionSize> <#Threads> <#KeyRange> <InsertVertex Ratio> <DeleteVertex Ratio> <InsertEdge Ratio> <DeleteEdge Ratio> <Find Ratio>\n", argv[0]);
+        printf("Proper format: %s <#TestSize> <#TransactionSize> <#Threads> <#KeyRange> <InsertVertex Ratio> <DeleteVertex Ratio> <InsertEdge Ratio> <DeleteEdge Ratio> <Find Ratio> [--dense] [--ordered] [--perf] [--populate] [--rmat <EdgeFactor>] [--trace <File>]\n", argv[0]);
         printf("All operation ratios should sum to 1.0\n");
+        printf("--dense: map the vertex keys [0, KeyRange] through a direct table instead of the vertex list\n");
+        printf("--ordered: execute the ops of each transaction in vertex key order with finger searches of the vertex list\n");
+        printf("           edge ops still search each mdlist from its head\n");
+        printf("--perf: count cache, branch and TLB misses per committed op with perf_event_open\n");
+        printf("--populate: insert the vertices [1, KeyRange] before the timed phase\n");
+        printf("--rmat: populate, then insert EdgeFactor * KeyRange R-MAT edges with the Graph500 parameters (16 in Graph500)\n");
+        printf("        and draw the edge ops from the same distribution\n");
+        printf("--trace: write the traced calls of the last transactions of every thread to File as Chrome trace JSON, needs make TRACE=1\n");
         std::exit(EXIT_FAILURE);
     }
 
@@ -135,14 +223,64 @@ int main(int argc, const char *argv[])
     delete_edge_ratio = std::stod(argv[8]);
     find_ratio = std::stod(argv[9]);
 
+    for (int a = 10; a < argc; a++)
+    {
+        if (strcmp(argv[a], "--dense") == 0)
+        {
+            dense = true;
+        }
+        else if (strcmp(argv[a], "--ordered") == 0)
+        {
+            ordered = true;
+        }
+        else if (strcmp(argv[a], "--perf") == 0)
+        {
+            perf = true;
+        }
+        else if (strcmp(argv[a], "--populate") == 0)
+        {
+            populate = true;
+        }
+        else if (strcmp(argv[a], "--rmat") == 0 && a + 1 < argc)
+        {
+            populate = true;
+            rmat_edge_factor = atoi(argv[++a]);
+        }
+        else if (strcmp(argv[a], "--trace") == 0 && a + 1 < argc)
+        {
+            trace_path = argv[++a];
+        }
+        else
+        {
+            printf("Unknown option %s\n", argv[a]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
     if (insert_vertex_ratio + delete_vertex_ratio + insert_edge_ratio + delete_edge_ratio + find_ratio != 1.0)
     {
         printf("Error, operation ratios do not sum to 1.0\n");
         std::exit(EXIT_FAILURE);
     }
 
-    list = new AdjacencyList(num_thread, transaction_size, (test_size * transaction_size * 2));
+    //Populating takes one more slot of the allocators, and every slot room for the whole starting graph
+    //Each R-MAT draw is inserted in both directions, at most EdgeFactor * KeyRange edges, and an edge insert may install a
+    //NodeDesc in its pred as well as in its node
+    int ops = test_size * transaction_size * 2;
+    if (populate)
+    {
+        ops = std::max<int64_t>(ops, key_range + 2 * (int64_t)rmat_edge_factor * key_range + 1);
+    }
+
+    list = new AdjacencyList(num_thread + populate, transaction_size, ops, dense ? key_range + 1 : 0);
+    list->ordered_ops = ordered;
     t_data = new ThreadData[num_thread];
+    perf_counters = new PerfCounters[num_thread];
+
+    if (populate)
+    {
+        prePopulateList();
+    }
 
     printf("Starting test...\n\n");
     
@@ -185,5 +323,27 @@ int main(int argc, const char *argv[])
 
     printf("Ops/s %.0f\n", (g_commits*transaction_size)/elapsed);
     printf("Total Commits %d, Total Aborts: %d \n", g_commits, g_aborts);
-    printf("Success Rate: %f%% \n", 100*((double)g_commits/(test_size*transaction_size)));
+    //Every thread runs TestSize transactions, the baseline divided by TestSize * TransactionSize, which is not a count of anything
+    printf("Success Rate: %f%% \n", 100*((double)g_commits/(test_size*num_thread)));
+
+    if (perf)
+    {
+        reportPerf();
+    }
+
+    if (trace_path != NULL)
+    {
+#ifdef LFTT_TRACE
+        if (Tracer::Dump(trace_path))
+        {
+            printf("Traced %lu calls, wrote the last ones to %s\n", Tracer::Recorded(), trace_path);
+        }
+        else
+        {
+            printf("Error: could not write %s\n", trace_path);
+        }
+#else
+        printf("Tracing is compiled out, rebuild with make clean && make TRACE=1\n");
+#endif
+    }
 }
\ No newline at end of file
@@ -6,58 +6,117 @@
 #include <cmath>
 #include "pre_alloc.h"
 #include "lftt.h"
+#include "trace.h"
 
-#define SET_ADPINV(_p)    ((MDNode *)(((uintptr_t)(_p)) | 1))
-#define CLR_ADPINV(_p)    ((MDNode *)(((uintptr_t)(_p)) & ~1))
-#define IS_ADPINV(_p)     (((uintptr_t)(_p)) & 1)
+//Child links are 32-bit references into the MDNode arena, the two low bits carry the invalidation marks
+typedef uint32_t MDRef;
 
-#define SET_DELINV(_p)    ((MDNode *)(((uintptr_t)(_p)) | 2))
-#define CLR_DELINV(_p)    ((MDNode *)(((uintptr_t)(_p)) & ~2))
-#define IS_DELINV(_p)     (((uintptr_t)(_p)) & 2)
+#define SET_ADPINV(_r)    ((MDRef)((_r) | 1))
+#define CLR_ADPINV(_r)    ((MDRef)((_r) & ~1u))
+#define IS_ADPINV(_r)     ((_r) & 1)
 
-#define CLR_INVALID(_p)    ((MDNode *)(((uintptr_t)(_p)) & ~3))
-#define IS_INVALID(_p)     (((uintptr_t)(_p)) & 3)
+#define SET_DELINV(_r)    ((MDRef)((_r) | 2))
+#define CLR_DELINV(_r)    ((MDRef)((_r) & ~2u))
+#define IS_DELINV(_r)     ((_r) & 2)
 
-static const uint32_t DIMENSION = 16;
+#define CLR_INVALID(_r)    ((MDRef)((_r) & ~3u))
+#define IS_INVALID(_r)     ((_r) & 3)
 
-struct MDDesc;
+//Arena references count MDNode units, reference 0 is reserved for NULL
+static const uint64_t MDNODE_UNIT = 8;
+static const uint64_t MDNODE_MAX_UNITS = (1u << 30) - 1;
 
-struct MDNode
-{
-    MDNode* m_child[DIMENSION];
-    uint8_t m_coord[DIMENSION];
-    uint32_t m_key;             //key
-    MDDesc* m_pending;            //pending operation to adopt children 
+template<typename Key>
+struct BasicMDDesc;
 
-    NodeDesc* node_desc;
+//A node only stores the child slots it can ever use: a node inserted at pred_dim has all slots below pred_dim invalid,
+//so the slot array starts at m_base and is DIMENSION - m_base entries long. Coordinates are derived from m_key.
+template<typename Key>
+struct BasicMDNode
+{
+    //Every dimension takes two bits of the key, most significant first
+    static const uint32_t DIMENSION = sizeof(Key) * 4;
+
+    static uint32_t Units(uint32_t base)
+    {
+        return (sizeof(BasicMDNode) + sizeof(MDRef) * (DIMENSION - base) + MDNODE_UNIT - 1) / MDNODE_UNIT;
+    }
+
+    static uint32_t Coord(Key key, uint32_t dim)
+    {
+        return (key >> ((DIMENSION - 1 - dim) << 1)) & 0x3;
+    }
+
+    //Slots below m_base read as adoption invalidated, exactly as the full width layout stored them
+    MDRef Child(uint32_t dim)
+    {
+        return dim < m_base ? (MDRef)0x1 : m_child[dim - m_base];
+    }
+
+    MDRef* Slot(uint32_t dim)
+    {
+        return &m_child[dim - m_base];
+    }
+
+    BasicNodeDesc<Key>* node_desc;
+    BasicMDDesc<Key>* m_pending;          //pending operation to adopt children 
+    Key m_key;                  //key
+    uint8_t m_base;             //first child slot in use
+    uint8_t m_alloc_base;       //first child slot the allocation has room for
+    MDRef m_child[];
 };
 
 //Any insertion as a child of node in the rage [pred_dim, dim] needs to help finish the task
-struct MDDesc
+template<typename Key>
+struct BasicMDDesc
 {
-    MDNode* curr;
+    BasicMDNode<Key>* curr;
     uint8_t pred_dim;              //dimension of pred node
     uint8_t dim;                   //dimension of this node
 };
 
-class MDList 
+template<typename Key>
+class BasicMDList 
 {
 
 public:
-    MDList (uint32_t key_range, MDNode *head, PreAllocator<MDDesc> *& d_allocator);
-    ~MDList ();
+    typedef BasicMDNode<Key> MDNode;
+    typedef BasicMDDesc<Key> MDDesc;
+    typedef BasicNodeDesc<Key> NodeDesc;
+
+    static const uint32_t DIMENSION = MDNode::DIMENSION;
+
+    BasicMDList (uint32_t key_range, NodeDesc *head_desc, PreAllocator<MDNode> *& n_allocator, PreAllocator<MDDesc> *& d_allocator);
+    ~BasicMDList ();
     
     bool Insert(MDNode*& new_node, MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim);
     bool Delete(MDNode*& pred, MDNode*& curr, uint32_t pred_dim, uint32_t dim);
-    bool Find(uint32_t key);
+    bool Find(Key key);
+
+    MDNode* NewNode(Key key, NodeDesc* node_desc, uint32_t base);
+
+    MDNode* Deref(MDRef ref)
+    {
+        return ref & ~3u ? (MDNode*)(m_arena + ((ref >> 2) - 1) * MDNODE_UNIT) : NULL;
+    }
+
+    MDRef Ref(MDNode* node)
+    {
+        return node ? (MDRef)(((((uintptr_t)node - m_arena) / MDNODE_UNIT) + 1) << 2) : 0;
+    }
 
 public:
     //Procedures used by Insert()
-    template<int D>
-    void KeyToCoord(uint32_t key, uint8_t coord[]);
+    void KeyToCoord(Key key, uint8_t coord[])
+    {
+        for (uint32_t i = 0; i < DIMENSION ; ++i) 
+        {
+            coord[i] = MDNode::Coord(key, i);
+        }
+    }
 
     void LocatePred(uint8_t coord[], MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim);
-    MDDesc* FillNewNode(MDNode* new_node, MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim);
+    MDDesc* FillNewNode(MDNode* new_node, MDNode*& pred, MDRef curr, uint32_t& dim, uint32_t& pred_dim);
     void FinishInserting(MDNode* n, MDDesc* desc);
 
     void Traverse(MDNode* n, MDNode* parent, int dim, std::string& prefix);
@@ -65,8 +124,15 @@ public:
 public:
     MDNode* m_head;
     uint32_t m_basis;
+    uintptr_t m_arena;
+    PreAllocator<MDNode> *node_allocator;
     PreAllocator<MDDesc> *desc_allocator;
 };
 
+typedef BasicMDNode<uint32_t> MDNode;
+typedef BasicMDDesc<uint32_t> MDDesc;
+typedef BasicMDList<uint32_t> MDList;
+
+#include "mdlist_impl.h"
 
 #endif /* end of include guard: MDLIST_H */
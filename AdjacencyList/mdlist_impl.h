@@ -4,10 +4,11 @@
 //
 //------------------------------------------------------------------------------
 
+//Included at the end of mdlist.h, the list is a template and lives in headers only
+#pragma once
 #include <cstdio>
 #include <cstring>
 #include <immintrin.h>
-#include "mdlist.h"
 
 //------------------------------------------------------------------------------
 /*template<int D>
@@ -26,36 +27,46 @@ inline void MDList::KeyToCoord(uint32_t key, uint8_t coord[])
 }*/
 
 
-template<>
-inline void MDList::KeyToCoord<16>(uint32_t key, uint8_t coord[])
+//------------------------------------------------------------------------------
+template<typename Key>
+BasicMDList<Key>::BasicMDList(uint32_t key_range, NodeDesc *head_desc, PreAllocator<MDNode> *& n_allocator, PreAllocator<MDDesc> *& d_allocator)
+    : m_basis(3 + std::ceil(std::pow((float)key_range, 1.0 / (float)DIMENSION)))
+    , m_arena((uintptr_t)n_allocator->data)
 {
-    static const uint32_t MASK[16] = {0x3u << 30, 0x3u << 28, 0x3u << 26, 0x3u << 24, 0x3u << 22, 0x3u << 20, 0x3u << 18, 0x3u << 16,
-                                      0x3u << 14, 0x3u << 12, 0x3u << 10, 0x3u << 8, 0x3u << 6, 0x3u << 4, 0x3u << 2, 0x3u};
+    node_allocator = n_allocator;
+    desc_allocator = d_allocator;
 
-    for (uint32_t i = 0; i < 16 ; ++i) 
-    {
-        coord[i] = ((key & MASK[i]) >> (30 - (i << 1)));
-    }
+    //The sentinel head keeps every child slot
+    m_head = NewNode(0, head_desc, 0);
 }
 
-//------------------------------------------------------------------------------
-MDList::MDList(uint32_t key_range, MDNode *head, PreAllocator<MDDesc> *& d_allocator)
-    : m_head(head)
-    , m_basis(3 + std::ceil(std::pow((float)key_range, 1.0 / (float)DIMENSION)))
+template<typename Key>
+BasicMDList<Key>::~BasicMDList()
 {
-    //memset(m_head, 0, sizeof(MDNode));
-    desc_allocator = d_allocator;
 }
 
-MDList::~MDList()
+//Allocates a node with room for the child slots [base, DIMENSION)
+template<typename Key>
+typename BasicMDList<Key>::MDNode* BasicMDList<Key>::NewNode(Key key, NodeDesc* node_desc, uint32_t base)
 {
+    MDNode* node = node_allocator->get_new(MDNode::Units(base));
+
+    node->node_desc = node_desc;
+    node->m_pending = NULL;
+    node->m_key = key;
+    node->m_base = base;
+    node->m_alloc_base = base;
+    memset(node->m_child, 0, sizeof(MDRef) * (DIMENSION - base));
+
+    return node;
 }
 
 
 //------------------------------------------------------------------------------
-bool MDList::Insert(MDNode*& new_node, MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim)
+template<typename Key>
+bool BasicMDList<Key>::Insert(MDNode*& new_node, MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim)
 {
-    MDNode* pred_child = pred->m_child[pred_dim];
+    MDRef pred_child = *pred->Slot(pred_dim);
 
     //We are not updating existing node, remove this line to allow update
     if(dim == DIMENSION && !IS_DELINV(pred_child))
@@ -78,10 +89,10 @@ bool MDList::Insert(MDNode*& new_node, MDNode*& pred, MDNode*& curr, uint32_t& d
 
     //Atomically update pred node's child pointer
     //if cas fails, it means another node has succesfully inserted inbetween pred and curr
-    MDNode* expected = curr;
+    MDRef expected = Ref(curr);
     if(IS_DELINV(pred_child))
     {
-        expected = SET_DELINV(curr); 
+        expected = SET_DELINV(expected); 
         //if child adoption is need, we take the chance to do physical deletion
         //Otherwise, we CANNOT force full scale adoption
         if(dim == DIMENSION - 1)
@@ -92,9 +103,15 @@ bool MDList::Insert(MDNode*& new_node, MDNode*& pred, MDNode*& curr, uint32_t& d
 
     if(pred_child == expected)
     {
+        //The node may have been sized for a deeper position on an earlier attempt
+        if(pred_dim < new_node->m_alloc_base)
+        {
+            new_node = NewNode(new_node->m_key, new_node->node_desc, pred_dim);
+        }
+
         MDDesc* desc = FillNewNode(new_node, pred, expected, dim, pred_dim);
 
-        pred_child = __sync_val_compare_and_swap(&pred->m_child[pred_dim], expected, new_node);
+        pred_child = __sync_val_compare_and_swap(pred->Slot(pred_dim), expected, Ref(new_node));
 
         if(pred_child == expected)
         {
@@ -130,7 +147,7 @@ bool MDList::Insert(MDNode*& new_node, MDNode*& pred, MDNode*& curr, uint32_t& d
         dim = 0;
         pred_dim = 0;
     }
-    else if(CLR_INVALID(pred_child) != curr)
+    else if(Deref(pred_child) != curr)
     {
         curr = pred;
         dim = pred_dim;
@@ -152,14 +169,15 @@ bool MDList::Insert(MDNode*& new_node, MDNode*& pred, MDNode*& curr, uint32_t& d
     return false;
 }
 
-inline void MDList::LocatePred(uint8_t coord[], MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim)
+template<typename Key>
+void BasicMDList<Key>::LocatePred(uint8_t coord[], MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim)
 {
     //Locate the proper position to insert
     //traverse list from low dim to high dim
     while(dim < DIMENSION)
     {
         //Loacate predecessor and successor
-        while(curr && coord[dim] > curr->m_coord[dim])
+        while(curr && coord[dim] > MDNode::Coord(curr->m_key, dim))
         {
             pred_dim = dim;
             pred = curr;
@@ -170,12 +188,12 @@ inline void MDList::LocatePred(uint8_t coord[], MDNode*& pred, MDNode*& curr, ui
                 FinishInserting(curr, pending);
 
             }
-            curr = CLR_INVALID(curr->m_child[dim]);
+            curr = Deref(curr->Child(dim));
         }
 
         //no successor has greater coord at this dimension
         //the position after pred is the insertion position
-        if(curr == NULL || coord[dim] < curr->m_coord[dim]) 
+        if(curr == NULL || coord[dim] < MDNode::Coord(curr->m_key, dim)) 
         {
             //done searching
             break;
@@ -190,61 +208,58 @@ inline void MDList::LocatePred(uint8_t coord[], MDNode*& pred, MDNode*& curr, ui
     }
 }
 
-inline MDDesc* MDList::FillNewNode(MDNode* new_node, MDNode*& pred, MDNode*& curr, uint32_t& dim, uint32_t& pred_dim)
+template<typename Key>
+inline typename BasicMDList<Key>::MDDesc* BasicMDList<Key>::FillNewNode(MDNode* new_node, MDNode*& pred, MDRef curr, uint32_t& dim, uint32_t& pred_dim)
 {
     MDDesc* desc = NULL;
     if(pred_dim != dim)
     {
         //descriptor to instruct other insertion task to help migrate the children
         desc = (MDDesc*)desc_allocator->get_new();
-        desc->curr = CLR_DELINV(curr);
+        desc->curr = Deref(curr);
         desc->pred_dim = pred_dim;
         desc->dim = dim;
     }
 
-    //Fill values for new_node, m_child is set to 1 for all children before pred_dim
-    //pred_dim is the dimension where new_node is inserted, all dimension before that are invalid for new_node
-    for(uint32_t i = 0; i < pred_dim; ++i)
-    {
-        new_node->m_child[i] = (MDNode*)0x1;
-    }
+    //Fill values for new_node, pred_dim is the dimension where new_node is inserted, all dimension before that are invalid for new_node
+    //Those slots are not stored, the node only has to be allocated wide enough to start at pred_dim
+    new_node->m_base = pred_dim;
     //be careful with the length of memset, should be DIMENSION - pred_dim NOT (DIMENSION - 1 - pred_dim)
-    memset(new_node->m_child + pred_dim, 0, sizeof(MDNode*) * (DIMENSION - pred_dim));
+    memset(new_node->Slot(pred_dim), 0, sizeof(MDRef) * (DIMENSION - pred_dim));
     if(dim < DIMENSION)
     {
         //If curr is marked for deletion or overriden, we donnot link it. 
         //Instead, we adopt ALL of its children
-        new_node->m_child[dim] = curr;
+        *new_node->Slot(dim) = curr;
     }
     new_node->m_pending = desc;
 
     return desc;
 }
 
-inline void MDList::FinishInserting(MDNode* n, MDDesc* desc)
+template<typename Key>
+void BasicMDList<Key>::FinishInserting(MDNode* n, MDDesc* desc)
 {
+    TRACE_SCOPE("FinishInserting", n, desc->dim);
+
     uint32_t pred_dim = desc->pred_dim;    
     uint32_t dim = desc->dim;    
     MDNode* curr = desc->curr;
 
     for (uint32_t i = pred_dim; i < dim; ++i) 
     {
-        MDNode* child = curr->m_child[i];
+        MDRef child;
 
         //Children slot of curr_node need to be marked as invalid 
         //before we copy them to new_node
-        //while(!IS_ADPINV(child) && !__sync_bool_compare_and_swap(&curr->m_child[i], child, SET_ADPINV(child)))
-        //{
-            //child = curr->m_child[i];
-        //}
-        child = __sync_fetch_and_or(&curr->m_child[i], 0x1);
-        child = CLR_ADPINV(curr->m_child[i]);
+        child = __sync_fetch_and_or(curr->Slot(i), 0x1);
+        child = CLR_ADPINV(*curr->Slot(i));
         if(child)
         {
             //Adopt children from curr_node's
-            if(n->m_child[i] == NULL)
+            if(*n->Slot(i) == 0)
             {
-                __sync_bool_compare_and_swap(&n->m_child[i], NULL, child);
+                __sync_bool_compare_and_swap(n->Slot(i), 0, child);
             }
         }
     }
@@ -256,24 +271,26 @@ inline void MDList::FinishInserting(MDNode* n, MDDesc* desc)
     }
 }
 
-bool MDList::Delete(MDNode*& pred, MDNode*& curr, uint32_t pred_dim, uint32_t dim)
+template<typename Key>
+bool BasicMDList<Key>::Delete(MDNode*& pred, MDNode*& curr, uint32_t pred_dim, uint32_t dim)
 {
     if(dim == DIMENSION)
     {
-        MDNode* pred_child = pred->m_child[pred_dim];
+        MDRef curr_ref = Ref(curr);
+        MDRef pred_child = *pred->Slot(pred_dim);
 
-        if(pred_child == curr)
+        if(pred_child == curr_ref)
         {
-            pred_child = __sync_val_compare_and_swap(&pred->m_child[pred_dim], curr, SET_DELINV(curr));
+            pred_child = __sync_val_compare_and_swap(pred->Slot(pred_dim), curr_ref, SET_DELINV(curr_ref));
         }
 
         //1. successfully marked node for deletion
-        if(pred_child == curr)
+        if(pred_child == curr_ref)
         {
             return true;
         }
         //2. Node is marked for deletion by another thread 
-        else if(IS_DELINV(pred_child) && CLR_INVALID(pred_child) == curr)
+        else if(IS_DELINV(pred_child) && CLR_INVALID(pred_child) == curr_ref)
         {
             return false;
         }
@@ -282,11 +299,12 @@ bool MDList::Delete(MDNode*& pred, MDNode*& curr, uint32_t pred_dim, uint32_t di
     return false;
 }
 
-bool MDList::Find(uint32_t key)
+template<typename Key>
+bool BasicMDList<Key>::Find(Key key)
 {
     //TODO: may be use specilized locatedPred to speedup
     uint8_t coord[DIMENSION];
-    KeyToCoord<DIMENSION>(key, coord);
+    KeyToCoord(key, coord);
     MDNode* pred = NULL;      //pred node
     MDNode* curr = m_head;    //curr node
     uint32_t dim = 0;       //the dimension of curr node
@@ -0,0 +1,140 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <iostream>
+
+//Bounded lock-free multi producer multi consumer queue
+//Every cell carries a sequence number that tells producers and consumers whose turn it is, so a position
+//is claimed with a single CAS and never handed out twice
+template<typename T>
+class MPMCQueue
+{
+public:
+    //The capacity is rounded up to a power of two
+    MPMCQueue(uint64_t _capacity)
+    {
+        capacity = 1;
+        while (capacity < _capacity)
+        {
+            capacity <<= 1;
+        }
+
+        mask = capacity - 1;
+        cells = new Cell[capacity];
+
+        if (cells == NULL)
+        {
+            std::cout << "Malloc error in mpmc_queue.h, exiting\n";
+            exit(EXIT_FAILURE);
+        }
+
+        for (uint64_t i = 0; i < capacity; i++)
+        {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos.store(0, std::memory_order_relaxed);
+    }
+
+    ~MPMCQueue()
+    {
+        delete[] cells;
+    }
+
+    //Returns false if the queue is full
+    bool Enqueue(const T& data)
+    {
+        uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell* cell = &cells[pos & mask];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            int64_t diff = (int64_t)seq - (int64_t)pos;
+
+            if (diff == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell->data = data;
+                    cell->seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //Returns false if the queue is empty
+    bool Dequeue(T& data)
+    {
+        uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell* cell = &cells[pos & mask];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            int64_t diff = (int64_t)seq - (int64_t)(pos + 1);
+
+            if (diff == 0)
+            {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    data = cell->data;
+                    cell->seq.store(pos + capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //Approximate while producers or consumers are running
+    bool Empty()
+    {
+        return enqueue_pos.load(std::memory_order_seq_cst) == dequeue_pos.load(std::memory_order_seq_cst);
+    }
+
+    //Approximate while producers or consumers are running
+    uint64_t Size()
+    {
+        uint64_t dequeued = dequeue_pos.load(std::memory_order_relaxed);
+        uint64_t enqueued = enqueue_pos.load(std::memory_order_relaxed);
+
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint64_t> seq;
+        T data;
+    };
+
+    uint64_t capacity;
+    uint64_t mask;
+    Cell* cells;
+
+    //Producers and consumers each get their own cache line
+    alignas(64) std::atomic<uint64_t> enqueue_pos;
+    alignas(64) std::atomic<uint64_t> dequeue_pos;
+};
+
+#endif
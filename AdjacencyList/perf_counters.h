@@ -0,0 +1,146 @@
+#pragma once
+#include <stdint.h>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+//Hardware counters of the calling thread through perf_event_open
+//Every event is opened on its own, so an event the CPU or the container does not offer only drops that event
+//The kernel multiplexes events when there are more than hardware counters, readings are scaled to the time each one ran
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        DTLB_MISSES,
+        NUM_EVENTS
+    };
+
+    static const char* Name(int event)
+    {
+        static const char* names[NUM_EVENTS] = {"cycles", "instructions", "cache-misses", "branch-misses", "L1d-misses", "dTLB-misses"};
+        return names[event];
+    }
+
+    PerfCounters()
+    {
+        for (int i = 0; i < NUM_EVENTS; i++)
+        {
+            fds[i] = -1;
+            values[i] = 0;
+        }
+
+        available = 0;
+        error = 0;
+    }
+
+    ~PerfCounters()
+    {
+        Close();
+    }
+
+    //Opens the counters for the calling thread, returns the number of events available
+    //When none is, error holds the errno of the first failure
+    int Open()
+    {
+        static const uint32_t cache_read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        static const uint32_t types[NUM_EVENTS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+            PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE};
+        static const uint64_t configs[NUM_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_L1D | cache_read_miss, PERF_COUNT_HW_CACHE_DTLB | cache_read_miss};
+
+        int count = 0;
+
+        for (int i = 0; i < NUM_EVENTS; i++)
+        {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = types[i];
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+            if (fds[i] >= 0)
+            {
+                available |= 1 << i;
+                count++;
+            }
+            else if (error == 0)
+            {
+                error = errno;
+            }
+        }
+
+        return count;
+    }
+
+    void Start()
+    {
+        for (int i = 0; i < NUM_EVENTS; i++)
+        {
+            if (fds[i] >= 0)
+            {
+                ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    //Stops counting and reads the counts into values
+    void Stop()
+    {
+        for (int i = 0; i < NUM_EVENTS; i++)
+        {
+            if (fds[i] < 0)
+            {
+                continue;
+            }
+
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            //Count, time enabled, time running
+            uint64_t reading[3];
+
+            if (read(fds[i], reading, sizeof(reading)) == sizeof(reading) && reading[2] > 0)
+            {
+                values[i] = reading[2] < reading[1] ? (uint64_t)((double)reading[0] * reading[1] / reading[2]) : reading[0];
+            }
+        }
+    }
+
+    void Close()
+    {
+        for (int i = 0; i < NUM_EVENTS; i++)
+        {
+            if (fds[i] >= 0)
+            {
+                close(fds[i]);
+                fds[i] = -1;
+            }
+        }
+    }
+
+    //Whether the event was opened, its value stays valid after Close
+    bool Available(int event)
+    {
+        return available & (1 << event);
+    }
+
+    int fds[NUM_EVENTS];
+    uint64_t values[NUM_EVENTS];
+    uint32_t available;
+    int error;
+};
@@ -5,55 +5,169 @@
 #include <stdlib.h>
 #include <malloc.h>
 #include <iostream>
+#include "shared_segment.h"
 
 template<typename T>
 class PreAllocator
 {
 public:
-    PreAllocator(uint64_t num_threads, uint64_t type_size, uint64_t amount) :
+    //With a segment, the items and counters are carved from it and every process that maps it shares the allocator
+    PreAllocator(uint64_t num_threads, uint64_t type_size, uint64_t amount, SharedSegment* segment = NULL) :
         num_threads(num_threads),
         type_size(type_size),
-        amount(amount)
+        amount(amount),
+        owned(segment == NULL)
     {
-        data = memalign(type_size, num_threads*type_size*amount);
+        uint64_t counters_size = num_threads * COUNTER_STRIDE * sizeof(uint64_t);
+
+        if (segment != NULL)
+        {
+            data = segment->Allocate(num_threads*type_size*amount);
+            handed_out = (volatile uint64_t*)segment->Allocate(counters_size);
+        }
+        else
+        {
+            data = memalign(type_size, num_threads*type_size*amount);
+            //One cache line per thread, so publishing a count never contends with another thread
+            handed_out = (volatile uint64_t*)memalign(64, counters_size);
+        }
+
         thread_id_count = 0;
 
-        if (data)
+        if (data && handed_out)
             std::cout << "Allocating room for: " << amount*num_threads << " objects, total size: " << num_threads*type_size*amount <<  "\n";
         else 
         {
             std::cout << "Malloc error in pre_alloc.h, exiting\n";
             exit(EXIT_FAILURE);
         } 
+
+        for (uint64_t i = 0; i < num_threads; i++)
+        {
+            handed_out[i * COUNTER_STRIDE] = 0;
+        }
     }
 
     ~PreAllocator()
     {
-
+        if (owned)
+        {
+            free(data);
+            free((void*)handed_out);
+        }
     }
 
     //Each thread must call init before trying to use the Pre-Allocator
+    //A thread may use several allocators of the same type, e.g. of the shards of a ShardedAdjacencyList, and keeps its place in each
     void init()
     {
-        id = __sync_fetch_and_add(&thread_id_count, 1);
-        base = (uint64_t)data + (id * (type_size * amount));
-        index = 0;
+        uint64_t thread = __sync_fetch_and_add(&thread_id_count, 1);
+
+        if (thread >= num_threads)
+        {
+            std::cout << "Error: more threads than the allocator was created for\n";
+            exit(EXIT_FAILURE);
+        }
+
+        //An allocator at the address of one this thread used before that was freed takes over its state
+        ThreadState* state = states;
+        while (state != NULL && state->owner != this)
+        {
+            state = state->next;
+        }
+
+        if (state == NULL)
+        {
+            state = new ThreadState();
+            state->owner = this;
+            state->next = states;
+            states = state;
+        }
+
+        state->id = thread;
+        state->base = (uint64_t)data + (thread * (type_size * amount));
+        state->index = 0;
+        current = state;
     }
 
     T *get_new()
     {
-        if (index > amount)
+        ThreadState* state = local();
+
+        if (state->index >= amount)
+        {
+            std::cout << "Error: out of memory in allocator\n";
+            exit(EXIT_FAILURE);
+        }
+
+        uint64_t next_item = state->base + (state->index * type_size);
+        state->index++;
+        handed_out[state->id * COUNTER_STRIDE] = state->index;
+
+        return (T *)next_item;
+    }
+
+    //Hands out count consecutive items, used for variable sized objects measured in items of type_size bytes
+    T *get_new(uint64_t count)
+    {
+        ThreadState* state = local();
+
+        if (state->index + count > amount)
         {
             std::cout << "Error: out of memory in allocator\n";
             exit(EXIT_FAILURE);
         }
 
-        uint64_t next_item = base + (index * type_size);
-        index++;
+        uint64_t next_item = state->base + (state->index * type_size);
+        state->index += count;
+        handed_out[state->id * COUNTER_STRIDE] = state->index;
 
         return (T *)next_item;
     }
 
+    //Items the calling thread can still take
+    uint64_t room()
+    {
+        return amount - local()->index;
+    }
+
+    //Bytes handed out to the calling thread
+    uint64_t used()
+    {
+        return local()->index * type_size;
+    }
+
+    //Bytes handed out to the thread that was the given one to call init, readable from any thread
+    uint64_t thread_used(uint64_t thread)
+    {
+        return handed_out[thread * COUNTER_STRIDE] * type_size;
+    }
+
+    //Bytes handed out to all threads
+    uint64_t total_used()
+    {
+        uint64_t total = 0;
+
+        for (uint64_t i = 0; i < threads(); i++)
+        {
+            total += thread_used(i);
+        }
+
+        return total;
+    }
+
+    //Bytes set aside for all threads when the allocator was created
+    uint64_t reserved()
+    {
+        return num_threads * type_size * amount;
+    }
+
+    //Threads that called init so far
+    uint64_t threads()
+    {
+        return thread_id_count < num_threads ? thread_id_count : num_threads;
+    }
+
     void free_all()
     {
         return;
@@ -64,18 +178,54 @@ public:
     uint64_t type_size;
     uint64_t amount;
     void *data;
-    static __thread uint64_t id;
-    static __thread uint64_t index;
-    static __thread uint64_t base;
-};
+    //False when data lives in a shared segment
+    bool owned;
+    //Items handed out per thread, every COUNTER_STRIDE-th entry is used
+    volatile uint64_t *handed_out;
+    static const uint64_t COUNTER_STRIDE = 8;
 
-template<typename T>
-__thread uint64_t PreAllocator<T>::id;
+private:
+    //Where a thread allocates from in one allocator
+    struct ThreadState
+    {
+        PreAllocator* owner;
+        uint64_t id;
+        uint64_t index;
+        uint64_t base;
+        ThreadState* next;
+    };
+
+    //The state of the allocator the thread used last, found again in states when the thread switches allocators
+    ThreadState* local()
+    {
+        ThreadState* state = current;
+
+        if (state != NULL && state->owner == this)
+        {
+            return state;
+        }
+
+        for (state = states; state != NULL && state->owner != this; state = state->next);
+
+        if (state == NULL)
+        {
+            std::cout << "Error: thread did not call init on the allocator\n";
+            exit(EXIT_FAILURE);
+        }
+
+        current = state;
+        return state;
+    }
+
+    //Every allocator of type T the thread called init on, a few bytes each that are kept until the process exits
+    static __thread ThreadState* states;
+    static __thread ThreadState* current;
+};
 
 template<typename T>
-__thread uint64_t PreAllocator<T>::index;
+__thread typename PreAllocator<T>::ThreadState* PreAllocator<T>::states;
 
 template<typename T>
-__thread uint64_t PreAllocator<T>::base;
+__thread typename PreAllocator<T>::ThreadState* PreAllocator<T>::current;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "lftt.h"
+
+//Binary protocol between graph_server and its clients, integers are in host byte order since both ends share the machine
+//A client sends requests back to back without waiting for earlier responses, every request carries a whole transaction:
+//  RequestHeader, then op_count WireOps
+//The server answers each request with one ResponseFrame, responses to one connection may arrive out of order
+
+//Largest transaction a request may carry, a larger op_count closes the connection
+static const uint32_t MAX_WIRE_OPS = 1 << 16;
+
+struct __attribute__((packed)) RequestHeader
+{
+    uint32_t request_id;        //Chosen by the client, echoed in the response
+    uint32_t op_count;
+};
+
+struct __attribute__((packed)) WireOp
+{
+    uint8_t type;               //OpType
+    uint32_t key;
+    uint32_t edge_key;
+};
+
+//Status of a request the server did not run, its allocators have no room left for the ops
+//The arenas are never reused, once exhausted the server answers every later request this way until it restarts
+static const uint8_t SERVER_EXHAUSTED = 0xFF;
+
+struct __attribute__((packed)) ResponseFrame
+{
+    uint32_t request_id;
+    uint8_t status;             //COMMITTED, ABORTED or SERVER_EXHAUSTED
+};
+
+//Listen addresses are unix:<path> for a Unix domain socket or tcp:<port> for loopback TCP
+//Fills addr and returns its length, or 0 if the address is malformed
+inline socklen_t ParseAddress(const char* address, sockaddr_storage& addr, int& family)
+{
+    memset(&addr, 0, sizeof(addr));
+
+    if (strncmp(address, "unix:", 5) == 0)
+    {
+        sockaddr_un* un = (sockaddr_un*)&addr;
+
+        if (strlen(address + 5) >= sizeof(un->sun_path))
+        {
+            return 0;
+        }
+
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, address + 5);
+        family = AF_UNIX;
+
+        return sizeof(sockaddr_un);
+    }
+
+    if (strncmp(address, "tcp:", 4) == 0)
+    {
+        sockaddr_in* in = (sockaddr_in*)&addr;
+
+        in->sin_family = AF_INET;
+        in->sin_port = htons(atoi(address + 4));
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        family = AF_INET;
+
+        return sizeof(sockaddr_in);
+    }
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//A named POSIX shared memory segment mapped at the same address in every process that opens it
+//Pointers into the segment are then valid in all of them as they are, so structures built in it need no offsets
+//The segment is carved up by a bump allocator and never gives memory back, like PreAllocator
+class SharedSegment
+{
+public:
+    //Far above the heap and below where the kernel places mappings and stacks on x86-64 Linux
+    static const uintptr_t DEFAULT_BASE = 0x200000000000ull;
+
+    //Creates the segment and maps it at base, returns NULL if it exists or the address range is taken
+    static SharedSegment* Create(const char* name, uint64_t size, uintptr_t base = DEFAULT_BASE)
+    {
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+        if (fd < 0)
+        {
+            perror("Error: creating the shared segment");
+            return NULL;
+        }
+
+        size = (size + sizeof(Header) + PAGE - 1) / PAGE * PAGE;
+
+        if (ftruncate(fd, size) != 0)
+        {
+            perror("Error: sizing the shared segment");
+            close(fd);
+            shm_unlink(name);
+            return NULL;
+        }
+
+        Header* header = Map(fd, size, base);
+        close(fd);
+
+        if (header == NULL)
+        {
+            shm_unlink(name);
+            return NULL;
+        }
+
+        header->magic = MAGIC;
+        header->size = size;
+        header->base = base;
+        header->used = (sizeof(Header) + ALIGN - 1) / ALIGN * ALIGN;
+        header->root = NULL;
+
+        return new SharedSegment(name, header);
+    }
+
+    //Maps an existing segment at the address it was created at, returns NULL if that range is taken in this process
+    static SharedSegment* Open(const char* name)
+    {
+        int fd = shm_open(name, O_RDWR, 0600);
+
+        if (fd < 0)
+        {
+            perror("Error: opening the shared segment");
+            return NULL;
+        }
+
+        //The header tells where the creator mapped the segment
+        Header* probe = (Header*)mmap(NULL, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+
+        if (probe == MAP_FAILED || probe->magic != MAGIC)
+        {
+            printf("Error: %s is not a shared segment\n", name);
+            close(fd);
+            return NULL;
+        }
+
+        uint64_t size = probe->size;
+        uintptr_t base = probe->base;
+        munmap(probe, sizeof(Header));
+
+        Header* header = Map(fd, size, base);
+        close(fd);
+
+        return header != NULL ? new SharedSegment(name, header) : NULL;
+    }
+
+    //Removes the name, processes that have the segment mapped keep using it until they unmap it
+    static void Remove(const char* name)
+    {
+        shm_unlink(name);
+    }
+
+    //Unmaps the segment from this process, everything allocated in it stays for the other processes
+    ~SharedSegment()
+    {
+        munmap((void*)header, header->size);
+    }
+
+    //Safe from any thread of any process, exits when the segment is full
+    void* Allocate(uint64_t size, uint64_t align = ALIGN)
+    {
+        while (true)
+        {
+            uint64_t used = header->used;
+            uint64_t start = (used + align - 1) / align * align;
+
+            if (start + size > header->size)
+            {
+                printf("Error: shared segment %s is full\n", name.c_str());
+                std::exit(EXIT_FAILURE);
+            }
+
+            if (__sync_bool_compare_and_swap(&header->used, used, start + size))
+            {
+                return (char*)header + start;
+            }
+        }
+    }
+
+    //The object other processes look up after Open, set once it is fully built
+    void SetRoot(void* root)
+    {
+        __sync_synchronize();
+        header->root = root;
+    }
+
+    //NULL until the creator called SetRoot
+    void* Root()
+    {
+        return header->root;
+    }
+
+    uint64_t Size()
+    {
+        return header->size;
+    }
+
+    uint64_t Used()
+    {
+        return header->used;
+    }
+
+private:
+    static const uint64_t MAGIC = 0x544d47534446544cull;  //"LFTDSGMT"
+    static const uint64_t PAGE = 4096;
+    static const uint64_t ALIGN = 64;
+
+    struct Header
+    {
+        uint64_t magic;
+        uint64_t size;
+        uintptr_t base;
+        volatile uint64_t used;
+        void* volatile root;
+    };
+
+    SharedSegment(const char* _name, Header* _header)
+        : header(_header)
+        , name(_name)
+    {
+    }
+
+    //Maps the segment at exactly base, a range already mapped in this process is left alone and fails the call
+    static Header* Map(int fd, uint64_t size, uintptr_t base)
+    {
+        void* address = mmap((void*)base, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (address == MAP_FAILED)
+        {
+            perror("Error: mapping the shared segment");
+            return NULL;
+        }
+
+        if ((uintptr_t)address != base)
+        {
+            printf("Error: the shared segment cannot be mapped at %p in this process\n", (void*)base);
+            munmap(address, size);
+            return NULL;
+        }
+
+        return (Header*)address;
+    }
+
+    Header* header;
+    std::string name;
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include <stdint.h>
+#include <cstdio>
+#include <algorithm>
+#include <ctime>
+#include <mutex>
+#include <vector>
+
+//Execution tracer, every thread records the spans of the traced calls into its own ring buffer, without locks or atomics
+//Only built with -DLFTT_TRACE (make TRACE=1), TRACE_SCOPE is empty otherwise and nothing is ever recorded
+//A full ring overwrites its oldest spans, so a dump holds the last LFTT_TRACE_EVENTS calls of every thread
+#ifndef LFTT_TRACE_EVENTS
+#define LFTT_TRACE_EVENTS (1 << 16)
+#endif
+
+#ifdef LFTT_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+//Traces the rest of the enclosing block as a span named name, object and index are shown with it, e.g. the helped Desc and opid
+#define TRACE_SCOPE(name, object, index) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name, object, index)
+#else
+#define TRACE_SCOPE(name, object, index) ((void)0)
+#endif
+
+class Tracer
+{
+public:
+    //A span is recorded when it ends, a begin and an end in one slot can not be split by the ring wrapping around
+    struct Event
+    {
+        const char* name;
+        const void* object;
+        uint64_t begin;
+        uint64_t end;
+        uint32_t index;
+        //Traced calls the span is nested in on its thread, the depth of helping for HelpOps
+        uint32_t depth;
+    };
+
+    struct Ring
+    {
+        uint32_t tid;
+        uint32_t depth;
+        //Spans ever recorded, the last LFTT_TRACE_EVENTS of them are kept
+        uint64_t count;
+        Event events[LFTT_TRACE_EVENTS];
+    };
+
+    static uint64_t Now()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec * 1000000000ull + now.tv_nsec;
+    }
+
+    //The ring of the calling thread, made on its first span and kept after the thread exits so it can still be dumped
+    static Ring* Local()
+    {
+        if (ring == NULL)
+        {
+            std::lock_guard<std::mutex> lock(Mutex());
+            ring = new Ring;
+            ring->tid = Rings().size() + 1;
+            ring->depth = 0;
+            ring->count = 0;
+            Rings().push_back(ring);
+        }
+
+        return ring;
+    }
+
+    //Writes every ring as Chrome trace JSON, which chrome://tracing and ui.perfetto.dev open, false if path can not be written
+    //The rings are read without synchronization, dump once the traced threads are done or idle
+    static bool Dump(const char* path)
+    {
+        FILE* file = fopen(path, "w");
+
+        if (file == NULL)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(Mutex());
+        uint64_t origin = UINT64_MAX;
+
+        for (Ring* r : Rings())
+        {
+            for (uint64_t i = First(r); i < r->count; i++)
+            {
+                origin = std::min(origin, r->events[i % LFTT_TRACE_EVENTS].begin);
+            }
+        }
+
+        fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        bool first = true;
+
+        for (Ring* r : Rings())
+        {
+            fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"thread %u\"}}",
+                first ? "" : ",\n", r->tid, r->tid);
+            first = false;
+
+            for (uint64_t i = First(r); i < r->count; i++)
+            {
+                const Event& e = r->events[i % LFTT_TRACE_EVENTS];
+
+                //Complete events, timestamps and durations in microseconds
+                fprintf(file, ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f,"
+                    "\"args\":{\"object\":\"%p\",\"index\":%u,\"depth\":%u}}",
+                    r->tid, e.name, (e.begin - origin) / 1000.0, (e.end - e.begin) / 1000.0, e.object, e.index, e.depth);
+            }
+        }
+
+        fprintf(file, "\n]}\n");
+
+        return fclose(file) == 0;
+    }
+
+    //Spans recorded over all threads, including the overwritten ones
+    static uint64_t Recorded()
+    {
+        std::lock_guard<std::mutex> lock(Mutex());
+        uint64_t count = 0;
+
+        for (Ring* r : Rings())
+        {
+            count += r->count;
+        }
+
+        return count;
+    }
+
+private:
+    static uint64_t First(Ring* r)
+    {
+        return r->count > LFTT_TRACE_EVENTS ? r->count - LFTT_TRACE_EVENTS : 0;
+    }
+
+    static std::mutex& Mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<Ring*>& Rings()
+    {
+        static std::vector<Ring*> rings;
+        return rings;
+    }
+
+    static __thread Ring* ring;
+};
+
+inline __thread Tracer::Ring* Tracer::ring;
+
+struct TraceScope
+{
+    TraceScope(const char* _name, const void* _object, uint32_t _index)
+        : ring(Tracer::Local()), name(_name), object(_object), index(_index), begin(Tracer::Now())
+    {
+        ring->depth++;
+    }
+
+    ~TraceScope()
+    {
+        Tracer::Event& e = ring->events[ring->count % LFTT_TRACE_EVENTS];
+        e.name = name;
+        e.object = object;
+        e.begin = begin;
+        e.end = Tracer::Now();
+        e.index = index;
+        e.depth = --ring->depth;
+        ring->count++;
+    }
+
+    Tracer::Ring* ring;
+    const char* name;
+    const void* object;
+    uint32_t index;
+    uint64_t begin;
+};
@@ -0,0 +1,195 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <boost/random.hpp>
+#include "lftt.h"
+
+//Share of each op type in the generated transactions, the ratios sum to 1
+struct OpMix
+{
+    const char* name;
+    double insert_vertex;
+    double delete_vertex;
+    double insert_edge;
+    double delete_edge;
+    double find;
+};
+
+//Probabilities of the quadrants an R-MAT edge recurses into, top left a, top right b, bottom left c and the rest bottom right
+struct RmatParams
+{
+    double a;
+    double b;
+    double c;
+};
+
+//The Graph500 Kronecker generator's
+static const RmatParams GRAPH500_RMAT = {0.57, 0.19, 0.19};
+
+//Graph500 edges per vertex
+static const uint32_t GRAPH500_EDGE_FACTOR = 16;
+
+//R-MAT edges over the keys [1, vertices], a few hubs hold most of the edges and the degrees follow a power law
+//Every edge picks one quadrant of the adjacency matrix of the next power of two vertices per bit, draws beyond vertices are redrawn
+//The vertex labels are scrambled like Graph500 does, so the hubs are spread over the key range instead of being the smallest keys
+class RmatGenerator
+{
+public:
+    RmatGenerator(uint32_t _vertices, uint32_t seed, const RmatParams& _params = GRAPH500_RMAT)
+        : vertices(_vertices)
+        , params(_params)
+        , scale(0)
+        , quadrant_dist(0, 1)
+    {
+        randomGen.seed(seed);
+
+        while (scale < 32 && (1ull << scale) < vertices)
+        {
+            scale++;
+        }
+
+        mask = (uint32_t)((1ull << scale) - 1);
+    }
+
+    //Draws an edge from src to dst
+    void Next(uint32_t& src, uint32_t& dst)
+    {
+        do
+        {
+            uint32_t row = 0;
+            uint32_t col = 0;
+
+            for (uint32_t bit = 0; bit < scale; bit++)
+            {
+                double quadrant = quadrant_dist(randomGen);
+                row = row << 1 | (quadrant >= params.a + params.b);
+                col = col << 1 | ((quadrant >= params.a && quadrant < params.a + params.b) || quadrant >= params.a + params.b + params.c);
+            }
+
+            src = Scramble(row);
+            dst = Scramble(col);
+        }
+        while (src >= vertices || dst >= vertices);
+
+        src++;
+        dst++;
+    }
+
+    //A vertex drawn with probability proportional to its degree, the source of an edge
+    uint32_t NextVertex()
+    {
+        uint32_t src;
+        uint32_t dst;
+        Next(src, dst);
+
+        return src;
+    }
+
+    //The distinct edges of count draws in both directions, as Graph500 graphs are undirected, sorted by source
+    //Self loops are dropped, an edge to its own vertex says nothing about an adjacency list
+    void Edges(uint64_t count, std::vector<std::pair<uint32_t, uint32_t>>& edges)
+    {
+        edges.clear();
+        edges.reserve(2 * count);
+
+        for (uint64_t i = 0; i < count; i++)
+        {
+            uint32_t src;
+            uint32_t dst;
+            Next(src, dst);
+
+            if (src != dst)
+            {
+                edges.push_back(std::make_pair(src, dst));
+                edges.push_back(std::make_pair(dst, src));
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    }
+
+private:
+    //A bijection of [0, 2^scale), multiplying by an odd number and xoring in the high bits are both invertible modulo 2^scale
+    uint32_t Scramble(uint32_t v)
+    {
+        v = (v * 0x9E3779B1u) & mask;
+        v ^= v >> (scale / 2 + 1);
+        v = (v * 0x85EBCA6Bu) & mask;
+        v ^= v >> (scale / 2 + 1);
+
+        return v;
+    }
+
+    uint32_t vertices;
+    RmatParams params;
+    uint32_t scale;
+    uint32_t mask;
+    boost::mt19937 randomGen;
+    boost::uniform_real<double> quadrant_dist;
+};
+
+//Random transactions of main and bench_sweep, every op and its keys are drawn independently from the keys [1, key_range]
+//Given an RmatGenerator, the vertex and edge of an edge op are an R-MAT edge instead
+class WorkloadGenerator
+{
+public:
+    WorkloadGenerator(const OpMix& mix, uint32_t key_range, uint32_t seed, RmatGenerator* _rmat = NULL)
+        : key_dist(1, key_range)
+        , op_dist(0, 1)
+        , rmat(_rmat)
+    {
+        randomGen.seed(seed);
+
+        //Cumulative bounds of the op types in the order of OpType, whatever lies above the last one is a find
+        bounds[0] = mix.insert_vertex;
+        bounds[1] = bounds[0] + mix.delete_vertex;
+        bounds[2] = bounds[1] + mix.insert_edge;
+        bounds[3] = bounds[2] + mix.delete_edge;
+    }
+
+    //Fills every op of desc
+    template<typename Desc>
+    void Fill(Desc* desc)
+    {
+        static const uint8_t types[4] = {INSERT, DELETE, INSERT_EDGE, DELETE_EDGE};
+
+        for (uint32_t t = 0; t < desc->size; t++)
+        {
+            double op = op_dist(randomGen);
+            uint8_t type = FIND;
+
+            for (int i = 0; i < 4; i++)
+            {
+                if (op < bounds[i])
+                {
+                    type = types[i];
+                    break;
+                }
+            }
+
+            desc->ops[t].type = type;
+
+            if ((type == INSERT_EDGE || type == DELETE_EDGE) && rmat != NULL)
+            {
+                uint32_t key;
+                uint32_t edge_key;
+                rmat->Next(key, edge_key);
+                desc->ops[t].key = key;
+                desc->ops[t].edge_key = edge_key;
+                continue;
+            }
+
+            desc->ops[t].key = key_dist(randomGen);
+            desc->ops[t].edge_key = type == INSERT_EDGE || type == DELETE_EDGE ? key_dist(randomGen) : 0;
+        }
+    }
+
+private:
+    boost::mt19937 randomGen;
+    boost::uniform_int<uint32_t> key_dist;
+    boost::uniform_real<double> op_dist;
+    RmatGenerator* rmat;
+    double bounds[4];
+};
@@ -0,0 +1,152 @@
+#ifndef WS_DEQUE_H
+#define WS_DEQUE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+//Chase-Lev work stealing deque
+//The owner pushes and pops at the bottom without synchronizing unless one item is left, thieves take from the top with a CAS
+//The ring doubles when full, replaced rings are kept until the deque is destroyed since a thief may still be reading one
+template<typename T>
+class WSDeque
+{
+public:
+    WSDeque(uint64_t capacity = 256)
+    {
+        uint64_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        Ring* ring = new Ring(size);
+        rings.push_back(ring);
+        active.store(ring, std::memory_order_relaxed);
+        top.store(0, std::memory_order_relaxed);
+        bottom.store(0, std::memory_order_relaxed);
+    }
+
+    ~WSDeque()
+    {
+        for (Ring* ring : rings)
+        {
+            delete ring;
+        }
+    }
+
+    //Owner only
+    void Push(T item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring* ring = active.load(std::memory_order_relaxed);
+
+        if (b - t > (int64_t)ring->mask)
+        {
+            ring = Grow(ring, t, b);
+        }
+
+        ring->Put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    //Owner only, returns false if the deque is empty
+    bool Pop(T& item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = active.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = ring->Get(b);
+
+        if (t == b)
+        {
+            //Last item, race the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    //Any thread, returns false if the deque is empty or another thread took the item first
+    bool Steal(T& item)
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return false;
+        }
+
+        Ring* ring = active.load(std::memory_order_consume);
+        item = ring->Get(t);
+
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    //Approximate while other threads are running
+    uint64_t Size()
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        return b > t ? b - t : 0;
+    }
+
+private:
+    struct Ring
+    {
+        Ring(uint64_t size) : mask(size - 1), items(new std::atomic<T>[size]) {}
+        ~Ring() { delete[] items; }
+
+        T Get(int64_t i)
+        {
+            return items[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void Put(int64_t i, T item)
+        {
+            items[i & mask].store(item, std::memory_order_relaxed);
+        }
+
+        uint64_t mask;
+        std::atomic<T>* items;
+    };
+
+    Ring* Grow(Ring* ring, int64_t t, int64_t b)
+    {
+        Ring* grown = new Ring((ring->mask + 1) << 1);
+
+        for (int64_t i = t; i < b; i++)
+        {
+            grown->Put(i, ring->Get(i));
+        }
+
+        rings.push_back(grown);
+        active.store(grown, std::memory_order_release);
+
+        return grown;
+    }
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Ring*> active;
+    //Only the owner grows the deque, so only the owner touches this list
+    std::vector<Ring*> rings;
+};
+
+#endif